@@ -0,0 +1,231 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Population diversity.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which computes diversity measures of a population of binary chromosomes,
+cheap enough to be watched every generation, e.g. to trigger a restart when the population has
+converged.
+
+The mean pairwise Hamming distance is not computed from the m(m-1)/2 pairs, as pdist would, but
+from the allele counts: if c_j individuals have a 1 in gene j then c_j(m-c_j) pairs differ in gene
+j, so the sum of all pairwise distances is the sum of c_j(m-c_j) over the genes, which takes O(m*n)
+rather than O(m^2*n). The allele counts are found by packing each gene (column) of the population
+into 64-bit words and counting their set bits with the hardware popcount instruction. When compiled
+with AVX2 the packing takes 32 individuals per instruction (vpmovmskb), and with AVX-512 VPOPCNTDQ
+the bits of 8 words are counted per instruction (vpopcntq).
+
+The duplicates are found by packing each individual (row) into 64-bit words and sorting the packed
+individuals, after which identical individuals are neighbours.
+
+The function takes 1 input:
+* Input 1: a [m x n] boolean matrix 'Population' containing the population.
+
+The function outputs 4 variables:
+* Output 1: a [1 x n] vector with the allele frequency of each gene, i.e. the fraction of 1s.
+* Output 2: a [1 x 1] scalar with the mean Hamming distance between all pairs of individuals.
+* Output 3: a [1 x n] vector with the entropy of each gene in bits, between 0 and 1.
+* Output 4: a [1 x 1] scalar with the number of duplicates, i.e. individuals identical to an
+individual higher up in the population. Only computed if requested.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex PopulationDiversity.c
+
+% Compile with AVX2 or AVX-512 VPOPCNTDQ (GCC/Clang) to enable the vector kernels:
+>> mex CFLAGS="$CFLAGS -mavx2" PopulationDiversity.c
+>> mex CFLAGS="$CFLAGS -mavx512f -mavx512vpopcntdq" PopulationDiversity.c
+
+% Run from Matlab when compiled:
+>> Population = logical(randi([0 1],10000, 256));
+>> [ Frequency, MeanHamming, Entropy, Duplicates ] = PopulationDiversity( Population );
+>> if mean(Entropy) < 0.05, Population = RestartPopulation(Population); end
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <math.h>   // Needed for log2() in the entropy.
+#include <string.h> // Needed for memset and memcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#ifdef _MSC_VER
+#include <intrin.h> // Needed for __popcnt64.
+#endif
+#if defined(__AVX2__) || defined(__AVX512VPOPCNTDQ__)
+#include <immintrin.h>
+#endif
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void PackColumn(const bool *Column, size_t m, uint64_t *Packed);
+
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed);
+
+uint64_t CountOnes(const uint64_t *Words, size_t NoWords);
+
+int Popcount64(uint64_t x);
+
+int CompareGenomes(const void *a, const void *b);
+
+/* Packed rows and their length, for CompareGenomes.											 */
+static const uint64_t *SortGenomes;
+static size_t SortWords;
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const bool *Population;
+
+	double *Frequency, *MeanHamming, *Entropy, *Duplicates;
+	uint64_t *Column, *Packed, Ones;
+	size_t *Order;
+	size_t m, n, Words, gene, row;
+	double p, DifferingPairs;
+
+	/* ————————————————————————— Get pointers from the input variables ————————————————————————— */
+	if (nrhs < 1 || !mxIsLogical(prhs[0])) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationDiversity:invalidinputs", "Error: Population must be a logical matrix!");
+	}
+	Population = mxGetLogicals(prhs[0]);      // Input 1 (Population)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[0]);                      // Number of rows in Population.
+	n = mxGetN(prhs[0]);                      // Number of columns in Population.
+
+	/* ———————————————————————————————— Specify Matlab outputs ————————————————————————————————— */
+	plhs[0] = mxCreateDoubleMatrix(1, n, mxREAL);
+	Frequency = mxGetPr(plhs[0]);
+	plhs[1] = mxCreateDoubleMatrix(1, 1, mxREAL);
+	MeanHamming = mxGetPr(plhs[1]);
+	plhs[2] = mxCreateDoubleMatrix(1, n, mxREAL);
+	Entropy = mxGetPr(plhs[2]);
+
+	if (m == 0) {
+		return;
+	}
+
+	/* ————————————————————————— Allele frequencies, Hamming and entropy ——————————————————————— */
+	Column = (uint64_t*)malloc(sizeof(uint64_t) * ((m + 63) / 64));
+	DifferingPairs = 0;
+	for (gene = 0; gene < n; gene++) {
+		PackColumn(Population + m * gene, m, Column);
+		Ones = CountOnes(Column, (m + 63) / 64);
+
+		p = (double)Ones / (double)m;
+		Frequency[gene] = p;
+		Entropy[gene] = p > 0 && p < 1 ? -p * log2(p) - (1 - p) * log2(1 - p) : 0;
+		DifferingPairs += (double)Ones * (double)(m - Ones);
+	}
+	free(Column);
+	*MeanHamming = m > 1 ? DifferingPairs / ((double)m * (double)(m - 1) / 2) : 0;
+
+	/* ———————————————————————————————————— Duplicate count ————————————————————————————————————— */
+	if (nlhs > 3) {
+		plhs[3] = mxCreateDoubleMatrix(1, 1, mxREAL);
+		Duplicates = mxGetPr(plhs[3]);
+
+		Words  = (n + 63) / 64;
+		Packed = (uint64_t*)malloc(sizeof(uint64_t) * (m * Words + 1));
+		Order  = (size_t*)malloc(sizeof(size_t) * m);
+		PackRows(Population, m, n, Words, Packed);
+		for (row = 0; row < m; row++) {
+			Order[row] = row;
+		}
+
+		/* Sort the rows by their packed genes, so that identical rows become neighbours.		 */
+		SortGenomes = Packed;
+		SortWords = Words;
+		qsort(Order, m, sizeof(size_t), CompareGenomes);
+		for (row = 1; row < m; row++) {
+			if (memcmp(Packed + Order[row] * Words, Packed + Order[row - 1] * Words, sizeof(uint64_t) * Words) == 0) {
+				*Duplicates += 1;
+			}
+		}
+		free(Packed);
+		free(Order);
+	}
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing one column of a logical matrix, i.e. one gene of all individuals, into	 */
+/* 64-bit words. Individual i is stored in bit i%64 of word i/64, and unused bits are zero.		 */
+void PackColumn(const bool *Column, size_t m, uint64_t *Packed){
+
+	size_t row, Full;
+
+	memset(Packed, 0, sizeof(uint64_t) * ((m + 63) / 64));
+	Full = 0;
+#ifdef __AVX2__
+	/* Compare 32 bytes with zero at a time and gather their inverted sign bits into 32 bits.	 */
+	{
+		__m256i Bytes, Zero = _mm256_setzero_si256();
+		uint32_t Mask;
+		for (Full = 0; Full + 32 <= m; Full += 32) {
+			Bytes = _mm256_loadu_si256((const __m256i*)(Column + Full));
+			Mask  = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(Bytes, Zero));
+			Packed[Full / 64] |= (uint64_t)Mask << (Full % 64);
+		}
+	}
+#endif
+	for (row = Full; row < m; row++) {
+		Packed[row / 64] |= (uint64_t)(Column[row] != 0) << (row % 64);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing each row of a column-major logical matrix into 64-bit words. Gene j of	 */
+/* a row is stored in bit j%64 of word j/64, and the unused bits of the last word are zero.		 */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed){
+
+	size_t row, gene;
+
+	memset(Packed, 0, sizeof(uint64_t) * m * Words);
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < m; row++) {
+			Packed[row * Words + gene / 64] |= (uint64_t)(Population[row + m * gene] != 0) << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for counting the set bits of an array of 64-bit words.								 */
+uint64_t CountOnes(const uint64_t *Words, size_t NoWords){
+
+	size_t word = 0;
+	uint64_t Ones = 0;
+
+#ifdef __AVX512VPOPCNTDQ__
+	/* Count the bits of 8 words per instruction, and add up the 8 lane counts at the end.		 */
+	__m512i Counts = _mm512_setzero_si512();
+	for (; word + 8 <= NoWords; word += 8) {
+		Counts = _mm512_add_epi64(Counts, _mm512_popcnt_epi64(_mm512_loadu_si512((const void*)(Words + word))));
+	}
+	Ones = (uint64_t)_mm512_reduce_add_epi64(Counts);
+#endif
+	for (; word < NoWords; word++) {
+		Ones += (uint64_t)Popcount64(Words[word]);
+	}
+	return Ones;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for counting the number of bits that are set in a 64-bit word.						 */
+int Popcount64(uint64_t x){
+#if defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64(x);
+#elif defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to order rows by their packed genes.								 */
+int CompareGenomes(const void *a, const void *b){
+	return memcmp(SortGenomes + *(const size_t*)a * SortWords, SortGenomes + *(const size_t*)b * SortWords, sizeof(uint64_t) * SortWords);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,472 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Delta fitness evaluation.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which updates the fitness of mutated individuals from the genes that were
+flipped, as listed by BitflipMutation, instead of evaluating the individuals from scratch. For
+objectives that are separable or built from local terms only the terms that contain a flipped gene
+change, so the cost per individual drops from O(n) to O(number of flips) times the number of terms
+per gene.
+
+The built-in delta evaluators are:
+	'onemax' - number of genes that are 1. Each flip changes the fitness by +1 or -1.
+	'nk'     - NK-landscape: the mean over the genes i of Table(i, b), where b is the index given
+	           by gene i and its K neighbours. Only the terms of genes that are flipped or have a
+	           flipped neighbour are recomputed.
+	'maxsat' - weighted MAX-SAT: the total weight of the satisfied clauses. Only the clauses that
+	           contain a flipped gene are recomputed.
+Each term is evaluated before and after the flips by reading the old value of a gene as its new
+value with the flip undone, so the population before mutation is not needed.
+
+Delta evaluators can be added in C by writing a function of type 'DeltaFunction', which receives
+one mutated individual, its fitness before the mutation and its flipped genes and returns its new
+fitness, together with a 'FullFunction' evaluating an individual from scratch, and adding them to
+the list of built-in evaluators in the gateway.
+
+The function takes 5 inputs:
+* Input 1: the name of a built-in delta evaluator, see above.
+* Input 2: a [m x n] boolean matrix 'Population' containing the population after mutation.
+* Input 3: a [m x 1] vector 'OldFitness' with the fitness of each individual before mutation. If
+empty, [], the individuals are evaluated from scratch, e.g. to get the fitness of the initial
+population.
+* Input 4: a [F x 2] matrix 'Flips' with the individual and gene of each flipped gene, sorted by
+individual and then by gene, as output by BitflipMutation.
+* Input 5: a struct 'Problem' describing the problem instance for 'nk' and 'maxsat':
+	nk:     Neighbours - [n x K] the K neighbours of each gene, with genes numbered 1 to n.
+	        Table      - [n x 2^(K+1)] the contribution of each gene for each of the 2^(K+1)
+	                     values of the gene and its neighbours, where the gene is the lowest bit
+	                     and neighbour k is bit k of the (0-based) column index.
+	maxsat: Clauses    - [C x L] the literals of each clause, +j for gene j and -j for not gene j,
+	                     padded with 0 for clauses with fewer than L literals.
+	        Weights    - (optional) [C x 1] the weight of each clause (default 1).
+
+The function outputs 1 variable:
+* Output 1: a [m x 1] vector 'Fitness' containing the fitness of each individual after mutation.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex DeltaFitness.c
+
+% Run from Matlab when compiled:
+>> Problem = struct('Neighbours', randi(256, 256, 4), 'Table', rand(256, 32));
+>> Population = logical(randi([0 1],10000, 256));
+>> [ Fitness ] = DeltaFitness( 'nk', Population, [], [], Problem );
+>> [ Population, Flips ] = BitflipMutation( Population, 1/256, 0 );
+>> [ Fitness ] = DeltaFitness( 'nk', Population, Fitness, Flips, Problem );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <string.h> // Needed for strcmp.
+#include <math.h>   // Needed for floor.
+
+/* ——————————————————————————————————————————— Types ——————————————————————————————————————————— */
+/* An individual is passed as a pointer to its first gene and the stride between its genes, so	 */
+/* that gene j of row i of a column-major population is Population[i + m*j].					 */
+typedef double (*DeltaFunction)(const bool *Genome, size_t Stride, double OldFitness, const size_t *Flipped, size_t NoFlipped, void *Context);
+
+typedef double (*FullFunction)(const bool *Genome, size_t Stride, void *Context);
+
+/* NK-landscape with its dependency lists, i.e. for each gene the terms that read it.			 */
+typedef struct {
+	size_t n, K;
+	const double *Neighbours;   // [n x K] 1-based neighbours of each gene.
+	const double *Table;        // [n x 2^(K+1)] contribution of each gene.
+	size_t *DependStart;        // [n+1 x 1] start of the terms of each gene in Depend.
+	size_t *Depend;             // [n*(K+1) x 1] terms that read each gene.
+	unsigned char *Flipped;     // [n x 1] scratch marking the flipped genes.
+	size_t *Stamp;              // [n x 1] call in which each term was last recomputed.
+	size_t Call;                // Number of calls to NKDelta so far.
+} NKProblem;
+
+/* Weighted MAX-SAT with its occurrence lists, i.e. for each gene the clauses that contain it.	 */
+typedef struct {
+	size_t n, C, L;
+	const double *Clauses;      // [C x L] signed 1-based literals, 0 for none.
+	const double *Weights;      // [C x 1] weight of each clause, or NULL for all 1.
+	size_t *OccurStart;         // [n+1 x 1] start of the clauses of each gene in Occur.
+	size_t *Occur;              // [C*L x 1] clauses that contain each gene.
+	unsigned char *Flipped;     // [n x 1] scratch marking the flipped genes.
+	size_t *Stamp;              // [C x 1] call in which each clause was last recomputed.
+	size_t Call;                // Number of calls to MaxSatDelta so far.
+} MaxSatProblem;
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+double OneMaxDelta(const bool *Genome, size_t Stride, double OldFitness, const size_t *Flipped, size_t NoFlipped, void *Context);
+
+double OneMaxFull(const bool *Genome, size_t Stride, void *Context);
+
+double NKDelta(const bool *Genome, size_t Stride, double OldFitness, const size_t *Flipped, size_t NoFlipped, void *Context);
+
+double NKFull(const bool *Genome, size_t Stride, void *Context);
+
+double NKTerm(const NKProblem *NK, const bool *Genome, size_t Stride, size_t Gene, bool Old);
+
+void NKSetup(const mxArray *Problem, size_t n, NKProblem *NK);
+
+double MaxSatDelta(const bool *Genome, size_t Stride, double OldFitness, const size_t *Flipped, size_t NoFlipped, void *Context);
+
+double MaxSatFull(const bool *Genome, size_t Stride, void *Context);
+
+bool ClauseSatisfied(const MaxSatProblem *Sat, const bool *Genome, size_t Stride, size_t Clause, bool Old);
+
+void MaxSatSetup(const mxArray *Problem, size_t n, MaxSatProblem *Sat);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	char Name[16];
+	const bool *Population;
+	const double *OldFitness, *Flips;
+	const mxArray *Problem;
+	DeltaFunction Delta;
+	FullFunction Full;
+	void *Context;
+	NKProblem NK;
+	MaxSatProblem Sat;
+
+	double *FitnessOut;
+	size_t *Flipped;
+	size_t m, n, NoFlips, f, row, NoFlipped, Gene;
+	bool Valid = true;
+
+	/* ————————————————————————— Get pointers from the input variables ————————————————————————— */
+	if (nrhs < 4 || mxGetString(prhs[0], Name, sizeof(Name)) != 0 || !mxIsLogical(prhs[1])) {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Inputs must be an evaluator name, a logical Population, OldFitness and Flips!");
+	}
+	if ((!mxIsEmpty(prhs[2]) && !mxIsDouble(prhs[2])) || (!mxIsEmpty(prhs[3]) && !mxIsDouble(prhs[3]))) {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: OldFitness and Flips must be of type double!");
+	}
+	Population = mxGetLogicals(prhs[1]);      // Input 2 (Population)
+	OldFitness = mxIsEmpty(prhs[2]) ? NULL : mxGetPr(prhs[2]); // Input 3 (OldFitness)
+	Flips      = mxGetPr(prhs[3]);            // Input 4 (Flips)
+	Problem    = nrhs > 4 ? prhs[4] : NULL;   // Input 5 (Problem)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[1]);                      // Number of rows in Population.
+	n = mxGetN(prhs[1]);                      // Number of columns in Population.
+	NoFlips = OldFitness != NULL ? mxGetM(prhs[3]) : 0;
+
+	if (OldFitness != NULL && mxGetNumberOfElements(prhs[2]) != m) {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: OldFitness must have one element per individual in Population!");
+	}
+	if (NoFlips > 0 && mxGetN(prhs[3]) != 2) {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Flips must be a [F x 2] matrix of individuals and genes!");
+	}
+
+	/* ———————————————————————————————— Pick the delta evaluator ——————————————————————————————— */
+	if (strcmp(Name, "onemax") == 0) {
+		Delta   = OneMaxDelta;
+		Full    = OneMaxFull;
+		Context = &n;
+	}
+	else if (strcmp(Name, "nk") == 0) {
+		NKSetup(Problem, n, &NK);
+		Delta   = NKDelta;
+		Full    = NKFull;
+		Context = &NK;
+	}
+	else if (strcmp(Name, "maxsat") == 0) {
+		MaxSatSetup(Problem, n, &Sat);
+		Delta   = MaxSatDelta;
+		Full    = MaxSatFull;
+		Context = &Sat;
+	}
+	else {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Unknown delta evaluator '%s'!", Name);
+		return;
+	}
+
+	/* ———————————————————————————————— Specify Matlab outputs ————————————————————————————————— */
+	plhs[0] = mxCreateDoubleMatrix(m, 1, mxREAL);
+	FitnessOut = mxGetPr(plhs[0]);
+
+	/* ——————————————————————— Evaluate from scratch or from the flips ————————————————————————— */
+	if (OldFitness == NULL) {
+		for (row = 0; row < m; row++) {
+			FitnessOut[row] = Full(Population + row, m, Context);
+		}
+	}
+	else {
+		/* The flips are sorted by individual, so the flips of each individual are consecutive,	 */
+		/* and by gene, so a gene flipped twice is caught by comparing it to the previous gene.	 */
+		/* A gene must be a whole number between 1 and n, so NaN is rejected before the cast.	 */
+		Flipped = (size_t*)malloc(sizeof(size_t) * (n + 1));
+		f = 0;
+		for (row = 0; row < m && Valid; row++) {
+			NoFlipped = 0;
+			while (f < NoFlips && Flips[f] == (double)(row + 1)) {
+				if (!(Flips[f + NoFlips] >= 1 && Flips[f + NoFlips] <= (double)n) || Flips[f + NoFlips] != floor(Flips[f + NoFlips])) {
+					Valid = false;
+					break;
+				}
+				Gene = (size_t)Flips[f + NoFlips] - 1;
+				if (NoFlipped > 0 && Gene <= Flipped[NoFlipped - 1]) {
+					Valid = false;
+					break;
+				}
+				Flipped[NoFlipped++] = Gene;
+				f++;
+			}
+			FitnessOut[row] = NoFlipped > 0 ? Delta(Population + row, m, OldFitness[row], Flipped, NoFlipped, Context) : OldFitness[row];
+		}
+		free(Flipped);
+		if (f < NoFlips) {
+			Valid = false;
+		}
+	}
+
+	/* ——————————————————————————————————— Free the problems ——————————————————————————————————— */
+	if (Context == &NK) {
+		free(NK.DependStart);
+		free(NK.Depend);
+		free(NK.Flipped);
+		free(NK.Stamp);
+	}
+	else if (Context == &Sat) {
+		free(Sat.OccurStart);
+		free(Sat.Occur);
+		free(Sat.Flipped);
+		free(Sat.Stamp);
+	}
+	if (!Valid) {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Flips must be sorted by individual and gene, with individuals between 1 and m, whole genes between 1 and n and no gene twice!");
+	}
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* OneMax: each flip to 1 adds one to the fitness and each flip to 0 subtracts one.				 */
+double OneMaxDelta(const bool *Genome, size_t Stride, double OldFitness, const size_t *Flipped, size_t NoFlipped, void *Context){
+	size_t f;
+	for (f = 0; f < NoFlipped; f++) {
+		OldFitness += Genome[Flipped[f] * Stride] ? 1 : -1;
+	}
+	return OldFitness;
+}
+
+double OneMaxFull(const bool *Genome, size_t Stride, void *Context){
+	size_t gene, n = *(size_t*)Context;
+	double Ones = 0;
+	for (gene = 0; gene < n; gene++) {
+		Ones += Genome[gene * Stride] != 0;
+	}
+	return Ones;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* NK-landscape: the terms of the flipped genes and of the genes that have a flipped neighbour	 */
+/* are recomputed, each once, with the old and the new genes.									 */
+double NKDelta(const bool *Genome, size_t Stride, double OldFitness, const size_t *Flipped, size_t NoFlipped, void *Context){
+
+	NKProblem *NK = (NKProblem*)Context;
+	size_t f, d, Term;
+	double Change = 0;
+
+	NK->Call++;
+	for (f = 0; f < NoFlipped; f++) {
+		NK->Flipped[Flipped[f]] = 1;
+	}
+	for (f = 0; f < NoFlipped; f++) {
+		for (d = NK->DependStart[Flipped[f]]; d < NK->DependStart[Flipped[f] + 1]; d++) {
+			Term = NK->Depend[d];
+			if (NK->Stamp[Term] != NK->Call) {
+				NK->Stamp[Term] = NK->Call;
+				Change += NKTerm(NK, Genome, Stride, Term, false) - NKTerm(NK, Genome, Stride, Term, true);
+			}
+		}
+	}
+	for (f = 0; f < NoFlipped; f++) {
+		NK->Flipped[Flipped[f]] = 0;
+	}
+	return OldFitness + Change / (double)NK->n;
+}
+
+double NKFull(const bool *Genome, size_t Stride, void *Context){
+	NKProblem *NK = (NKProblem*)Context;
+	size_t gene;
+	double Sum = 0;
+	for (gene = 0; gene < NK->n; gene++) {
+		Sum += NKTerm(NK, Genome, Stride, gene, false);
+	}
+	return Sum / (double)NK->n;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for looking up the term of one gene, with the genes before the flips if Old is true. */
+double NKTerm(const NKProblem *NK, const bool *Genome, size_t Stride, size_t Gene, bool Old){
+	size_t k, Neighbour, Column;
+	Column = (Genome[Gene * Stride] != 0) ^ (Old && NK->Flipped[Gene]);
+	for (k = 0; k < NK->K; k++) {
+		Neighbour = (size_t)NK->Neighbours[Gene + NK->n * k] - 1;
+		Column |= (size_t)((Genome[Neighbour * Stride] != 0) ^ (Old && NK->Flipped[Neighbour])) << (k + 1);
+	}
+	return NK->Table[Gene + NK->n * Column];
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading an NK-landscape and building the list of terms that read each gene.		 */
+void NKSetup(const mxArray *Problem, size_t n, NKProblem *NK){
+
+	const mxArray *Neighbours, *Table;
+	size_t gene, k, Neighbour, *Fill;
+
+	Neighbours = Problem != NULL && mxIsStruct(Problem) ? mxGetField(Problem, 0, "Neighbours") : NULL;
+	Table      = Problem != NULL && mxIsStruct(Problem) ? mxGetField(Problem, 0, "Table") : NULL;
+	if (Neighbours == NULL || Table == NULL || !mxIsDouble(Neighbours) || !mxIsDouble(Table) ||
+	    (mxGetM(Neighbours) != n && !mxIsEmpty(Neighbours)) || mxGetN(Neighbours) > 30 || mxGetM(Table) != n ||
+	    mxGetN(Table) != ((size_t)1 << (mxIsEmpty(Neighbours) ? 1 : mxGetN(Neighbours) + 1))) {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Problem must have fields Neighbours [n x K] and Table [n x 2^(K+1)]!");
+	}
+	NK->n          = n;
+	NK->K          = mxIsEmpty(Neighbours) ? 0 : mxGetN(Neighbours);
+	NK->Neighbours = mxGetPr(Neighbours);
+	NK->Table      = mxGetPr(Table);
+	for (gene = 0; gene < n * NK->K; gene++) {
+		if (!(NK->Neighbours[gene] >= 1 && NK->Neighbours[gene] <= (double)n) || NK->Neighbours[gene] != floor(NK->Neighbours[gene])) {
+			mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Problem.Neighbours must contain whole genes between 1 and n!");
+		}
+	}
+
+	/* Term i reads gene i and its neighbours, so it is listed under each of them.				 */
+	NK->DependStart = (size_t*)calloc(n + 1, sizeof(size_t));
+	NK->Depend      = (size_t*)malloc(sizeof(size_t) * (n * (NK->K + 1) + 1));
+	NK->Flipped     = (unsigned char*)calloc(n, 1);
+	NK->Stamp       = (size_t*)calloc(n, sizeof(size_t));
+	NK->Call        = 0;
+	Fill            = (size_t*)malloc(sizeof(size_t) * n);
+	for (gene = 0; gene < n; gene++) {
+		NK->DependStart[gene + 1]++;
+		for (k = 0; k < NK->K; k++) {
+			NK->DependStart[(size_t)NK->Neighbours[gene + n * k]]++;
+		}
+	}
+	for (gene = 0; gene < n; gene++) {
+		NK->DependStart[gene + 1] += NK->DependStart[gene];
+		Fill[gene] = NK->DependStart[gene];
+	}
+	for (gene = 0; gene < n; gene++) {
+		NK->Depend[Fill[gene]++] = gene;
+		for (k = 0; k < NK->K; k++) {
+			Neighbour = (size_t)NK->Neighbours[gene + n * k] - 1;
+			NK->Depend[Fill[Neighbour]++] = gene;
+		}
+	}
+	free(Fill);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* MAX-SAT: the clauses that contain a flipped gene are recomputed, each once, with the old and	 */
+/* the new genes.																				 */
+double MaxSatDelta(const bool *Genome, size_t Stride, double OldFitness, const size_t *Flipped, size_t NoFlipped, void *Context){
+
+	MaxSatProblem *Sat = (MaxSatProblem*)Context;
+	size_t f, o, Clause;
+	double Change = 0, Weight;
+
+	Sat->Call++;
+	for (f = 0; f < NoFlipped; f++) {
+		Sat->Flipped[Flipped[f]] = 1;
+	}
+	for (f = 0; f < NoFlipped; f++) {
+		for (o = Sat->OccurStart[Flipped[f]]; o < Sat->OccurStart[Flipped[f] + 1]; o++) {
+			Clause = Sat->Occur[o];
+			if (Sat->Stamp[Clause] != Sat->Call) {
+				Sat->Stamp[Clause] = Sat->Call;
+				Weight = Sat->Weights != NULL ? Sat->Weights[Clause] : 1;
+				Change += Weight * ((double)ClauseSatisfied(Sat, Genome, Stride, Clause, false) - (double)ClauseSatisfied(Sat, Genome, Stride, Clause, true));
+			}
+		}
+	}
+	for (f = 0; f < NoFlipped; f++) {
+		Sat->Flipped[Flipped[f]] = 0;
+	}
+	return OldFitness + Change;
+}
+
+double MaxSatFull(const bool *Genome, size_t Stride, void *Context){
+	MaxSatProblem *Sat = (MaxSatProblem*)Context;
+	size_t Clause;
+	double Sum = 0;
+	for (Clause = 0; Clause < Sat->C; Clause++) {
+		if (ClauseSatisfied(Sat, Genome, Stride, Clause, false)) {
+			Sum += Sat->Weights != NULL ? Sat->Weights[Clause] : 1;
+		}
+	}
+	return Sum;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking if a clause is satisfied, by the genes before the flips if Old is true. */
+bool ClauseSatisfied(const MaxSatProblem *Sat, const bool *Genome, size_t Stride, size_t Clause, bool Old){
+	size_t l, Gene;
+	double Literal;
+	bool Value;
+	for (l = 0; l < Sat->L; l++) {
+		Literal = Sat->Clauses[Clause + Sat->C * l];
+		if (Literal == 0) {
+			continue;
+		}
+		Gene  = (size_t)(Literal > 0 ? Literal : -Literal) - 1;
+		Value = (Genome[Gene * Stride] != 0) ^ (Old && Sat->Flipped[Gene]);
+		if (Value == (Literal > 0)) {
+			return true;
+		}
+	}
+	return false;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading a MAX-SAT instance and building the list of clauses of each gene.		 */
+void MaxSatSetup(const mxArray *Problem, size_t n, MaxSatProblem *Sat){
+
+	const mxArray *Clauses, *Weights;
+	size_t c, l, Gene, *Fill;
+	double Literal;
+
+	Clauses = Problem != NULL && mxIsStruct(Problem) ? mxGetField(Problem, 0, "Clauses") : NULL;
+	Weights = Problem != NULL && mxIsStruct(Problem) ? mxGetField(Problem, 0, "Weights") : NULL;
+	if (Clauses == NULL || !mxIsDouble(Clauses) ||
+	    (Weights != NULL && (!mxIsDouble(Weights) || mxGetNumberOfElements(Weights) != mxGetM(Clauses)))) {
+		mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Problem must have fields Clauses [C x L] and optionally Weights [C x 1]!");
+	}
+	Sat->n       = n;
+	Sat->C       = mxGetM(Clauses);
+	Sat->L       = mxGetN(Clauses);
+	Sat->Clauses = mxGetPr(Clauses);
+	Sat->Weights = Weights != NULL ? mxGetPr(Weights) : NULL;
+	for (c = 0; c < Sat->C * Sat->L; c++) {
+		if (!(Sat->Clauses[c] >= -(double)n && Sat->Clauses[c] <= (double)n) || Sat->Clauses[c] != floor(Sat->Clauses[c])) {
+			mexErrMsgIdAndTxt("MATLAB:DeltaFitness:invalidinputs", "Error: Problem.Clauses must contain whole literals between -n and n!");
+		}
+	}
+
+	/* A clause is listed once under each of its genes, also if the gene appears twice in it.	 */
+	Sat->OccurStart = (size_t*)calloc(n + 1, sizeof(size_t));
+	Sat->Occur      = (size_t*)malloc(sizeof(size_t) * (Sat->C * Sat->L + 1));
+	Sat->Flipped    = (unsigned char*)calloc(n, 1);
+	Sat->Stamp      = (size_t*)calloc(Sat->C + 1, sizeof(size_t));
+	Sat->Call       = 0;
+	Fill            = (size_t*)malloc(sizeof(size_t) * (n + 1));
+	for (c = 0; c < Sat->C * Sat->L; c++) {
+		Literal = Sat->Clauses[c];
+		if (Literal != 0) {
+			Sat->OccurStart[(size_t)(Literal > 0 ? Literal : -Literal)]++;
+		}
+	}
+	for (Gene = 0; Gene < n; Gene++) {
+		Sat->OccurStart[Gene + 1] += Sat->OccurStart[Gene];
+		Fill[Gene] = Sat->OccurStart[Gene];
+	}
+	for (c = 0; c < Sat->C; c++) {
+		for (l = 0; l < Sat->L; l++) {
+			Literal = Sat->Clauses[c + Sat->C * l];
+			if (Literal != 0) {
+				Gene = (size_t)(Literal > 0 ? Literal : -Literal) - 1;
+				Sat->Occur[Fill[Gene]++] = c;
+			}
+		}
+	}
+	free(Fill);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,415 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Population evaluation.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which evaluates the fitness of every individual in a population of binary
+chromosomes and returns it as a fitness vector in the layout expected by TournamentSelection.
+
+The fitness function is either a Matlab function handle or the name of a built-in fitness function:
+* A function handle is called with a [b x n] logical matrix of up to 'BatchSize' individuals and
+must return a vector with their b fitness values. Calls into Matlab can only be made from the main
+thread, so batches are evaluated one after another, and a vectorised fitness function should be
+given batches as large as possible to keep the number of calls down.
+* The built-in fitness functions run natively on chromosomes packed into 64-bit words. The batches
+are handed out dynamically to the threads of an OpenMP team (compile with OpenMP enabled, see
+below), so that idle threads pick up the next batch when the cost of the fitness differs between
+individuals. The built-in functions are:
+	'onemax'      - number of genes that are 1.
+	'leadingones' - number of consecutive 1s counted from the first gene.
+	'trap5'       - sum of deceptive traps over consecutive blocks of 5 genes, where a block with
+	                u ones scores 5 if u = 5 and 4 - u otherwise.
+
+Native fitness functions can be added in C by writing a function of type 'FitnessFunction', which
+receives one packed chromosome (gene j in bit j%64 of word j/64), and adding it to the list of
+built-in functions in the gateway. EvalPop() can also be called directly from other C code.
+
+Lazy offspring from LazyNpointCrossover can be evaluated without materialising them in Matlab, by
+giving the parent pool as Population and the Offspring struct as input 4. Each thread then builds
+one packed child at a time from the packed parents, word by word, and evaluates it before building
+the next, so the children never exist as a whole matrix. Function handles need the children as a
+logical matrix, so for them all the children are materialised first.
+
+The function takes 3 inputs:
+* Input 1: a function handle or the name of a built-in fitness function, see above.
+* Input 2: a [m x n] boolean matrix 'Population' containing the population.
+* Input 3: (optional) a [1 x 1] scalar 'BatchSize' specifying how many individuals are evaluated
+per batch. Defaults to m for function handles and 64 for the built-in fitness functions. Can be
+left empty, [], when input 4 is given.
+* Input 4: (optional) a struct 'Offspring' from LazyNpointCrossover, in which case Population is
+its parent pool and the lazy children are evaluated instead of the rows of Population.
+
+The function outputs 1 variable:
+* Output 1: a [m x 1] vector 'Fitness' containing the fitness of each individual, higher better,
+or a [my x 1] vector with the fitness of each lazy child if input 4 is given.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64, with OpenMP for the built-in fitness functions
+>> mex COMPFLAGS="$COMPFLAGS /openmp" EvaluatePopulation.c
+>> mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" EvaluatePopulation.c
+
+% Run from Matlab when compiled:
+>> Population = logical(randi([0 1],10000, 256));
+>> [ Fitness ] = EvaluatePopulation( 'onemax', Population );
+>> [ Fitness ] = EvaluatePopulation( @(P) sum(P,2), Population, 1000 );
+>> [ Offspring ] = LazyNpointCrossover( Population, 2, 5000, 1/256 );
+>> [ ChildFitness ] = EvaluatePopulation( 'onemax', Population, [], Offspring );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <string.h> // Needed for memset and strcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#ifdef _MSC_VER
+#include <intrin.h> // Needed for __popcnt64.
+#endif
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+typedef double (*FitnessFunction)(const uint64_t *Genome, size_t n, void *Context);
+
+/* Children recorded by LazyNpointCrossover, see its description for the meaning of the fields.	 */
+typedef struct {
+	const double *Parents;          // [Children x 2] 1-based rows of the parents.
+	const double *CrossOverPoints;  // [Children x N] sorted crossover points.
+	const double *Flips;            // [NoFlips x 2] child and gene of each flip, sorted by child.
+	size_t Children, N, NoFlips;
+} LazyOffspring;
+
+void EvalPop(FitnessFunction Fitness, void *Context, const uint64_t *Packed, size_t m, size_t n, size_t Words, int BatchSize, double *FitnessOut);
+
+void EvalPopMatlab(const mxArray *Handle, const bool *Population, size_t m, size_t n, int BatchSize, double *FitnessOut);
+
+void EvalLazy(FitnessFunction Fitness, void *Context, const LazyOffspring *Lazy, const uint64_t *Packed, size_t n, size_t Words, int BatchSize, double *FitnessOut);
+
+void GetLazyOffspring(const mxArray *Offspring, size_t m, size_t n, LazyOffspring *Lazy);
+
+void MaterializeChild(const LazyOffspring *Lazy, const uint64_t *Packed, size_t n, size_t Words, size_t Child, uint64_t *Genome);
+
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed);
+
+double OneMax(const uint64_t *Genome, size_t n, void *Context);
+
+double LeadingOnes(const uint64_t *Genome, size_t n, void *Context);
+
+double Trap5(const uint64_t *Genome, size_t n, void *Context);
+
+int Popcount64(uint64_t x);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	char Name[32];
+	const bool *Population;
+	FitnessFunction Fitness;
+	int BatchSize;
+	LazyOffspring Lazy;
+
+	double *FitnessOut;
+	uint64_t *Packed, *Genome;
+	bool *Children;
+	size_t m, n, Words, child, gene;
+
+	/* ————————————————————————— Get pointers from the input variables ————————————————————————— */
+	if (nrhs < 2 || !mxIsLogical(prhs[1])) {
+		mexErrMsgIdAndTxt("MATLAB:EvaluatePopulation:invalidinputs", "Error: Population must be a logical matrix!");
+	}
+	Population = mxGetLogicals(prhs[1]);      // Input 2 (Population)
+	BatchSize  = nrhs > 2 && !mxIsEmpty(prhs[2]) ? (int)mxGetScalar(prhs[2]) : 0; // Input 3 (BatchSize)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[1]);                      // Number of rows in Population.
+	n = mxGetN(prhs[1]);                      // Number of columns in Population.
+	Words = (n + 63) / 64;                    // Number of 64-bit words per packed row.
+
+	if (nrhs > 3) {
+		GetLazyOffspring(prhs[3], m, n, &Lazy); // Input 4 (Offspring)
+	}
+
+	/* ———————————————————————————————— Specify Matlab outputs ————————————————————————————————— */
+	plhs[0] = mxCreateDoubleMatrix(nrhs > 3 ? Lazy.Children : m, 1, mxREAL);
+	FitnessOut = mxGetPr(plhs[0]);
+
+	/* ———————————————————————— Evaluate with a Matlab function handle ————————————————————————— */
+	if (mxIsClass(prhs[0], "function_handle")) {
+		if (nrhs > 3) {
+			/* Materialise the lazy children, as Matlab needs them as a matrix. The buffers come */
+			/* from mxMalloc, so that Matlab frees them if the fitness function errors.			 */
+			Packed   = (uint64_t*)mxMalloc(sizeof(uint64_t) * (m * Words + 1));
+			Genome   = (uint64_t*)mxMalloc(sizeof(uint64_t) * Words);
+			Children = (bool*)mxMalloc(sizeof(bool) * Lazy.Children * n + 1);
+			PackRows(Population, m, n, Words, Packed);
+			for (child = 0; child < Lazy.Children; child++) {
+				MaterializeChild(&Lazy, Packed, n, Words, child, Genome);
+				for (gene = 0; gene < n; gene++) {
+					Children[child + Lazy.Children * gene] = (Genome[gene / 64] >> (gene % 64)) & 1;
+				}
+			}
+			mxFree(Packed);
+			mxFree(Genome);
+			EvalPopMatlab(prhs[0], Children, Lazy.Children, n, BatchSize > 0 ? BatchSize : (int)Lazy.Children, FitnessOut);
+			mxFree(Children);
+			return;
+		}
+		EvalPopMatlab(prhs[0], Population, m, n, BatchSize > 0 ? BatchSize : (int)m, FitnessOut);
+		return;
+	}
+
+	/* ——————————————————————— Evaluate with a built-in fitness function ——————————————————————— */
+	if (mxGetString(prhs[0], Name, sizeof(Name)) != 0) {
+		mexErrMsgIdAndTxt("MATLAB:EvaluatePopulation:invalidinputs", "Error: Input 1 must be a function handle or the name of a built-in fitness function!");
+	}
+	if (strcmp(Name, "onemax") == 0) {
+		Fitness = OneMax;
+	}
+	else if (strcmp(Name, "leadingones") == 0) {
+		Fitness = LeadingOnes;
+	}
+	else if (strcmp(Name, "trap5") == 0) {
+		Fitness = Trap5;
+	}
+	else {
+		mexErrMsgIdAndTxt("MATLAB:EvaluatePopulation:invalidinputs", "Error: Unknown built-in fitness function '%s'!", Name);
+		return;
+	}
+
+	Packed = (uint64_t*)malloc(sizeof(uint64_t) * (m * Words + 1));
+	PackRows(Population, m, n, Words, Packed);
+
+	if (nrhs > 3) {
+		EvalLazy(Fitness, NULL, &Lazy, Packed, n, Words, BatchSize > 0 ? BatchSize : 64, FitnessOut);
+	}
+	else {
+		EvalPop(Fitness, NULL, Packed, m, n, Words, BatchSize > 0 ? BatchSize : 64, FitnessOut);
+	}
+
+	free(Packed);
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for evaluating a packed population with a native fitness function. The rows are		 */
+/* split into batches of 'BatchSize' which are handed out dynamically to the OpenMP threads.	 */
+void EvalPop(FitnessFunction Fitness, void *Context, const uint64_t *Packed, size_t m, size_t n, size_t Words, int BatchSize, double *FitnessOut){
+
+	ptrdiff_t row;
+
+	#pragma omp parallel for schedule(dynamic, BatchSize)
+	for (row = 0; row < (ptrdiff_t)m; row++) {
+		FitnessOut[row] = Fitness(Packed + row * Words, n, Context);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for evaluating lazy children with a native fitness function. Each thread builds one	 */
+/* child at a time in a buffer of its own from the packed parents, and evaluates it.			 */
+void EvalLazy(FitnessFunction Fitness, void *Context, const LazyOffspring *Lazy, const uint64_t *Packed, size_t n, size_t Words, int BatchSize, double *FitnessOut){
+
+	#pragma omp parallel
+	{
+		uint64_t *Genome = (uint64_t*)malloc(sizeof(uint64_t) * Words);
+		ptrdiff_t child;
+
+		#pragma omp for schedule(dynamic, BatchSize)
+		for (child = 0; child < (ptrdiff_t)Lazy->Children; child++) {
+			MaterializeChild(Lazy, Packed, n, Words, (size_t)child, Genome);
+			FitnessOut[child] = Fitness(Genome, n, Context);
+		}
+		free(Genome);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading the Offspring struct of LazyNpointCrossover, checking that its parents	 */
+/* and crossover points lie within a parent pool of m rows and n genes.							 */
+void GetLazyOffspring(const mxArray *Offspring, size_t m, size_t n, LazyOffspring *Lazy){
+
+	const mxArray *Parents, *Points, *Flips;
+	size_t child, Point;
+	double Previous;
+
+	Parents = mxIsStruct(Offspring) ? mxGetField(Offspring, 0, "Parents") : NULL;
+	Points  = mxIsStruct(Offspring) ? mxGetField(Offspring, 0, "CrossOverPoints") : NULL;
+	Flips   = mxIsStruct(Offspring) ? mxGetField(Offspring, 0, "Flips") : NULL;
+	if (Parents == NULL || Points == NULL || !mxIsDouble(Parents) || !mxIsDouble(Points) || mxGetN(Parents) != 2 || mxGetM(Points) != mxGetM(Parents)) {
+		mexErrMsgIdAndTxt("MATLAB:EvaluatePopulation:invalidinputs", "Error: Input 4 must be an Offspring struct from LazyNpointCrossover!");
+	}
+	Lazy->Parents         = mxGetPr(Parents);
+	Lazy->CrossOverPoints = mxGetPr(Points);
+	Lazy->Children        = mxGetM(Parents);
+	Lazy->N               = mxGetN(Points);
+	Lazy->NoFlips         = Flips != NULL && mxIsDouble(Flips) && mxGetN(Flips) == 2 ? mxGetM(Flips) : 0;
+	Lazy->Flips           = Lazy->NoFlips > 0 ? mxGetPr(Flips) : NULL;
+
+	for (child = 0; child < Lazy->Children; child++) {
+		if (Lazy->Parents[child] < 1 || Lazy->Parents[child] > (double)m ||
+		    Lazy->Parents[child + Lazy->Children] < 1 || Lazy->Parents[child + Lazy->Children] > (double)m) {
+			mexErrMsgIdAndTxt("MATLAB:EvaluatePopulation:invalidinputs", "Error: The parents of the lazy children must be rows of Population!");
+		}
+		Previous = 0;
+		for (Point = 0; Point < Lazy->N; Point++) {
+			if (Lazy->CrossOverPoints[child + Lazy->Children * Point] <= Previous || Lazy->CrossOverPoints[child + Lazy->Children * Point] >= (double)n) {
+				mexErrMsgIdAndTxt("MATLAB:EvaluatePopulation:invalidinputs", "Error: The crossover points of the lazy children must be sorted and between 1 and n-1!");
+			}
+			Previous = Lazy->CrossOverPoints[child + Lazy->Children * Point];
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for building one lazy child from its packed parents. The child starts as a copy of	 */
+/* its first parent, every second segment is then replaced word by word by the second parent,	 */
+/* and finally its mutated genes are flipped.													 */
+void MaterializeChild(const LazyOffspring *Lazy, const uint64_t *Packed, size_t n, size_t Words, size_t Child, uint64_t *Genome){
+
+	const uint64_t *P1, *P2;
+	size_t Point, Start, End, word, Low, High, Mid, gene;
+	uint64_t Mask;
+
+	P1 = Packed + ((size_t)Lazy->Parents[Child] - 1) * Words;
+	P2 = Packed + ((size_t)Lazy->Parents[Child + Lazy->Children] - 1) * Words;
+	memcpy(Genome, P1, sizeof(uint64_t) * Words);
+
+	/* Segments [Point_1, Point_2), [Point_3, Point_4) etc. come from the second parent.		 */
+	for (Point = 0; Point < Lazy->N; Point += 2) {
+		Start = (size_t)Lazy->CrossOverPoints[Child + Lazy->Children * Point];
+		End   = Point + 1 < Lazy->N ? (size_t)Lazy->CrossOverPoints[Child + Lazy->Children * (Point + 1)] : n;
+		for (word = Start / 64; word <= (End - 1) / 64; word++) {
+			Mask = ~(uint64_t)0;
+			if (word == Start / 64) {
+				Mask &= ~(uint64_t)0 << (Start % 64);
+			}
+			if (word == (End - 1) / 64 && End % 64 != 0) {
+				Mask &= ((uint64_t)1 << (End % 64)) - 1;
+			}
+			Genome[word] = (Genome[word] & ~Mask) | (P2[word] & Mask);
+		}
+	}
+
+	/* Binary search for the first flip of the child, then flip its genes.						 */
+	Low = 0;
+	High = Lazy->NoFlips;
+	while (Low < High) {
+		Mid = Low + (High - Low) / 2;
+		if (Lazy->Flips[Mid] < (double)(Child + 1)) {
+			Low = Mid + 1;
+		}
+		else {
+			High = Mid;
+		}
+	}
+	for (; Low < Lazy->NoFlips && Lazy->Flips[Low] == (double)(Child + 1); Low++) {
+		gene = (size_t)Lazy->Flips[Low + Lazy->NoFlips] - 1;
+		if (gene < n) {
+			Genome[gene / 64] ^= (uint64_t)1 << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for evaluating a population by calling a Matlab function handle on batches of rows.	 */
+void EvalPopMatlab(const mxArray *Handle, const bool *Population, size_t m, size_t n, int BatchSize, double *FitnessOut){
+
+	mxArray *Inputs[2], *Output;
+	bool *Batch;
+	size_t First, Rows, row, gene;
+
+	for (First = 0; First < m; First += Rows) {
+		Rows = m - First < (size_t)BatchSize ? m - First : (size_t)BatchSize;
+
+		/* Copy the rows of the batch into a matrix of their own.								 */
+		Inputs[0] = (mxArray*)Handle;
+		Inputs[1] = mxCreateLogicalMatrix(Rows, n);
+		Batch = mxGetLogicals(Inputs[1]);
+		for (gene = 0; gene < n; gene++) {
+			memcpy(Batch + Rows * gene, Population + First + m * gene, sizeof(bool) * Rows);
+		}
+
+		mexCallMATLAB(1, &Output, 2, Inputs, "feval");
+		mxDestroyArray(Inputs[1]);
+
+		if (!mxIsDouble(Output) || mxGetNumberOfElements(Output) != Rows) {
+			mxDestroyArray(Output);
+			mexErrMsgIdAndTxt("MATLAB:EvaluatePopulation:invalidoutput", "Error: The fitness function must return a double vector with one element per row!");
+		}
+		for (row = 0; row < Rows; row++) {
+			FitnessOut[First + row] = mxGetPr(Output)[row];
+		}
+		mxDestroyArray(Output);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing each row of a column-major logical matrix into 64-bit words. Gene j of	 */
+/* a row is stored in bit j%64 of word j/64, and the unused bits of the last word are zero.		 */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed){
+
+	size_t row, gene;
+
+	memset(Packed, 0, sizeof(uint64_t) * m * Words);
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < m; row++) {
+			Packed[row * Words + gene / 64] |= (uint64_t)(Population[row + m * gene] != 0) << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* OneMax: the number of genes that are 1.														 */
+double OneMax(const uint64_t *Genome, size_t n, void *Context){
+	size_t word;
+	int Ones = 0;
+	for (word = 0; word < (n + 63) / 64; word++) {
+		Ones += Popcount64(Genome[word]);
+	}
+	return Ones;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* LeadingOnes: the number of consecutive 1s counted from the first gene.						 */
+double LeadingOnes(const uint64_t *Genome, size_t n, void *Context){
+	size_t word, Ones = 0;
+	uint64_t Zeros;
+	for (word = 0; word < (n + 63) / 64; word++) {
+		if (Genome[word] != ~(uint64_t)0) {
+			/* Count the trailing ones of the word, i.e. the position of its lowest zero.		 */
+			Zeros = ~Genome[word];
+			while ((Zeros & 1) == 0) {
+				Zeros >>= 1;
+				Ones++;
+			}
+			break;
+		}
+		Ones += 64;
+	}
+	return (double)(Ones < n ? Ones : n);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Trap5: sum of deceptive traps over consecutive blocks of 5 genes. A trailing block shorter	 */
+/* than 5 genes is scored as a trap of its own length.											 */
+double Trap5(const uint64_t *Genome, size_t n, void *Context){
+	size_t Start, gene, Length;
+	int Ones;
+	double Fitness = 0;
+	for (Start = 0; Start < n; Start += 5) {
+		Length = n - Start < 5 ? n - Start : 5;
+		Ones = 0;
+		for (gene = Start; gene < Start + Length; gene++) {
+			Ones += (int)((Genome[gene / 64] >> (gene % 64)) & 1);
+		}
+		Fitness += Ones == (int)Length ? (double)Length : (double)Length - 1 - Ones;
+	}
+	return Fitness;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for counting the number of bits that are set in a 64-bit word.						 */
+int Popcount64(uint64_t x){
+#if defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64(x);
+#elif defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,338 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Fitness cache.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which remembers the fitness of previously evaluated chromosomes, so that
+individuals identical to ones already evaluated (elites, clones produced by TournamentSelection,
+children of identical parents or unmutated offspring) do not have to be evaluated again.
+
+Each chromosome is packed into 64-bit words and hashed with xxHash64. The hashes are stored in an
+open-addressing hash table together with the packed chromosome and its fitness, and on a hash match
+the packed chromosomes are compared in full, so a hash collision can never return the wrong fitness.
+The cache lives in the memory of the MEX function between calls, and is freed by 'clear', by
+"clear FitnessCache" or when Matlab exits.
+
+The function is called with a command as first input:
+* FitnessCache('lookup', Population) returns the cached fitness of each row of Population.
+* FitnessCache('store', Population, Fitness) adds the rows of Population and their fitness.
+* FitnessCache('clear') empties the cache.
+
+The inputs are:
+* Population: a [m x n] boolean matrix containing the population, with one individual per row.
+* Fitness: a [m x 1] vector containing the fitness of each individual (only for 'store').
+
+'lookup' outputs 2 variables:
+* Output 1: a [m x 1] vector with the cached fitness of each individual, NaN if not cached.
+* Output 2: a [m x 1] boolean vector which is true for the individuals found in the cache.
+
+The chromosome length n is fixed by the first 'store' after a 'clear'; storing a population with a
+different n empties the cache first.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex FitnessCache.c
+
+% Run from Matlab when compiled:
+>> Population = logical(randi([0 1],100, 256));
+>> [ Fitness, IsCached ] = FitnessCache( 'lookup', Population );
+>> Fitness(~IsCached) = MyFitnessFunction( Population(~IsCached,:) );
+>> FitnessCache( 'store', Population(~IsCached,:), Fitness(~IsCached) );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <string.h> // Needed for memset, memcmp and strcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed);
+
+uint64_t XXH64(const uint64_t *Data, size_t Words, uint64_t Seed);
+
+int64_t CacheFind(const uint64_t *Row, uint64_t Hash);
+
+void CacheInsert(const uint64_t *Row, uint64_t Hash, double Fitness);
+
+void CacheGrow(void);
+
+void CacheFree(void);
+
+/* —————————————————————————————— Cache state kept between calls ——————————————————————————————— */
+static uint64_t *CacheHashes;   // [Slots x 1] hash of the chromosome in each slot.
+static int64_t  *CacheEntry;    // [Slots x 1] entry stored in each slot, -1 if empty.
+static uint64_t *CacheGenomes;  // [Capacity x Words] packed chromosome of each entry.
+static double   *CacheFitness;  // [Capacity x 1] fitness of each entry.
+static size_t CacheSlots, CacheEntries, CacheCapacity, CacheWords, CacheGenes;
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	char Command[16];
+	const bool *Population;
+	const double *Fitness;
+
+	double *CachedFitness;
+	bool *IsCached;
+	uint64_t *Packed, Hash;
+	int64_t Entry;
+
+	size_t m, n, Words, row;
+
+	mexAtExit(CacheFree);
+
+	/* ————————————————————————— Get pointers from the input variables ————————————————————————— */
+	if (nrhs < 1 || mxGetString(prhs[0], Command, sizeof(Command)) != 0) {
+		mexErrMsgIdAndTxt("MATLAB:FitnessCache:invalidinputs", "Error: First input must be 'lookup', 'store' or 'clear'!");
+	}
+	if (strcmp(Command, "clear") == 0) {
+		CacheFree();
+		return;
+	}
+	if (nrhs < 2 || !mxIsLogical(prhs[1])) {
+		mexErrMsgIdAndTxt("MATLAB:FitnessCache:invalidinputs", "Error: Population must be a logical matrix!");
+	}
+	Population = mxGetLogicals(prhs[1]);      // Input 2 (Population)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[1]);                      // Number of rows in Population.
+	n = mxGetN(prhs[1]);                      // Number of columns in Population.
+	Words = (n + 63) / 64;                    // Number of 64-bit words per packed row.
+
+	/* ————————————————————————————— Pack and hash the population —————————————————————————————— */
+	/* Packed is allocated with mxMalloc, so that Matlab frees it if an error, e.g. running out	 */
+	/* of memory in CacheGrow, ends the call early.												 */
+	Packed = (uint64_t*)mxMalloc(sizeof(uint64_t) * (m * Words + 1));
+	PackRows(Population, m, n, Words, Packed);
+
+	if (strcmp(Command, "lookup") == 0) {
+		plhs[0] = mxCreateDoubleMatrix(m, 1, mxREAL);
+		CachedFitness = mxGetPr(plhs[0]);
+		plhs[1] = mxCreateLogicalMatrix(m, 1);
+		IsCached = mxGetLogicals(plhs[1]);
+
+		for (row = 0; row < m; row++) {
+			Entry = -1;
+			if (CacheEntries > 0 && n == CacheGenes) {
+				Hash  = XXH64(Packed + row * Words, Words, 0);
+				Entry = CacheFind(Packed + row * Words, Hash);
+			}
+			CachedFitness[row] = Entry >= 0 ? CacheFitness[Entry] : mxGetNaN();
+			IsCached[row] = Entry >= 0;
+		}
+	}
+	else if (strcmp(Command, "store") == 0) {
+		if (nrhs < 3 || !mxIsDouble(prhs[2]) || mxGetNumberOfElements(prhs[2]) != m) {
+			mxFree(Packed);
+			mexErrMsgIdAndTxt("MATLAB:FitnessCache:invalidinputs", "Error: Fitness must be a double vector with one element per individual in Population!");
+		}
+		Fitness = mxGetPr(prhs[2]);           // Input 3 (Fitness)
+
+		/* A new chromosome length makes the cached chromosomes meaningless.					 */
+		if (CacheEntries > 0 && n != CacheGenes) {
+			CacheFree();
+		}
+		CacheGenes = n;
+		CacheWords = Words;
+
+		for (row = 0; row < m; row++) {
+			Hash = XXH64(Packed + row * Words, Words, 0);
+			if (CacheFind(Packed + row * Words, Hash) < 0) {
+				CacheInsert(Packed + row * Words, Hash, Fitness[row]);
+			}
+		}
+	}
+	else {
+		mxFree(Packed);
+		mexErrMsgIdAndTxt("MATLAB:FitnessCache:invalidinputs", "Error: First input must be 'lookup', 'store' or 'clear'!");
+	}
+
+	mxFree(Packed);
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing each row of a column-major logical matrix into 64-bit words. Gene j of	 */
+/* a row is stored in bit j%64 of word j/64, and the unused bits of the last word are zero.		 */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed){
+
+	size_t row, gene;
+
+	memset(Packed, 0, sizeof(uint64_t) * m * Words);
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < m; row++) {
+			Packed[row * Words + gene / 64] |= (uint64_t)(Population[row + m * gene] != 0) << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for computing the 64-bit xxHash of 'Words' 64-bit words.							 */
+#define XXH_PRIME1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME3 0x165667B19E3779F9ULL
+#define XXH_PRIME4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME5 0x27D4EB2F165667C5ULL
+#define XXH_ROTL(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+static uint64_t XXH64Round(uint64_t Acc, uint64_t Input) {
+	Acc += Input * XXH_PRIME2;
+	Acc  = XXH_ROTL(Acc, 31);
+	return Acc * XXH_PRIME1;
+}
+
+static uint64_t XXH64Merge(uint64_t Acc, uint64_t Val) {
+	Acc ^= XXH64Round(0, Val);
+	return Acc * XXH_PRIME1 + XXH_PRIME4;
+}
+
+uint64_t XXH64(const uint64_t *Data, size_t Words, uint64_t Seed) {
+
+	uint64_t Hash, v1, v2, v3, v4;
+	size_t i = 0;
+
+	if (Words >= 4) {
+		v1 = Seed + XXH_PRIME1 + XXH_PRIME2;
+		v2 = Seed + XXH_PRIME2;
+		v3 = Seed;
+		v4 = Seed - XXH_PRIME1;
+		for (; i + 4 <= Words; i += 4) {
+			v1 = XXH64Round(v1, Data[i]);
+			v2 = XXH64Round(v2, Data[i + 1]);
+			v3 = XXH64Round(v3, Data[i + 2]);
+			v4 = XXH64Round(v4, Data[i + 3]);
+		}
+		Hash = XXH_ROTL(v1, 1) + XXH_ROTL(v2, 7) + XXH_ROTL(v3, 12) + XXH_ROTL(v4, 18);
+		Hash = XXH64Merge(Hash, v1);
+		Hash = XXH64Merge(Hash, v2);
+		Hash = XXH64Merge(Hash, v3);
+		Hash = XXH64Merge(Hash, v4);
+	}
+	else {
+		Hash = Seed + XXH_PRIME5;
+	}
+
+	Hash += (uint64_t)Words * 8;
+	for (; i < Words; i++) {
+		Hash ^= XXH64Round(0, Data[i]);
+		Hash  = XXH_ROTL(Hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+	}
+
+	Hash ^= Hash >> 33;
+	Hash *= XXH_PRIME2;
+	Hash ^= Hash >> 29;
+	Hash *= XXH_PRIME3;
+	Hash ^= Hash >> 32;
+	return Hash;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding a packed chromosome in the cache. Returns its entry, or -1 if missing.	 */
+int64_t CacheFind(const uint64_t *Row, uint64_t Hash){
+
+	size_t Slot;
+	int64_t Entry;
+
+	if (CacheSlots == 0) {
+		return -1;
+	}
+
+	/* Linear probing until an empty slot is reached.											 */
+	for (Slot = Hash & (CacheSlots - 1); (Entry = CacheEntry[Slot]) >= 0; Slot = (Slot + 1) & (CacheSlots - 1)) {
+		if (CacheHashes[Slot] == Hash && memcmp(CacheGenomes + Entry * CacheWords, Row, sizeof(uint64_t) * CacheWords) == 0) {
+			return Entry;
+		}
+	}
+	return -1;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for adding a packed chromosome that is not already in the cache.					 */
+void CacheInsert(const uint64_t *Row, uint64_t Hash, double Fitness){
+
+	size_t Slot;
+
+	/* Keep the table at most half full so that the probe sequences stay short.				 */
+	if (2 * (CacheEntries + 1) > CacheSlots || CacheEntries == CacheCapacity) {
+		CacheGrow();
+	}
+
+	Slot = Hash & (CacheSlots - 1);
+	while (CacheEntry[Slot] >= 0) {
+		Slot = (Slot + 1) & (CacheSlots - 1);
+	}
+	CacheHashes[Slot] = Hash;
+	CacheEntry[Slot]  = (int64_t)CacheEntries;
+	memcpy(CacheGenomes + CacheEntries * CacheWords, Row, sizeof(uint64_t) * CacheWords);
+	CacheFitness[CacheEntries] = Fitness;
+	CacheEntries++;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for doubling the size of the cache and rehashing the stored chromosomes. If memory	 */
+/* runs out the cache is left as it was, still valid, and an error is raised.					 */
+void CacheGrow(void){
+
+	size_t Slot, NewSlots, OldSlots, NewCapacity, GenomeBytes;
+	uint64_t *OldHashes, *NewGenomes, *NewHashes;
+	int64_t *OldEntry, *NewEntry;
+	double *NewFitness;
+
+	OldSlots  = CacheSlots;
+	OldHashes = CacheHashes;
+	OldEntry  = CacheEntry;
+
+	/* The stores grow into temporaries, so that a failed realloc does not lose the old block.	 */
+	NewSlots    = OldSlots ? OldSlots * 2 : 1024;
+	NewCapacity = NewSlots / 2;
+	GenomeBytes = sizeof(uint64_t) * NewCapacity * CacheWords;
+	NewGenomes  = (uint64_t*)realloc(CacheGenomes, GenomeBytes);
+	if (NewGenomes != NULL || GenomeBytes == 0) {
+		CacheGenomes = NewGenomes;
+	}
+	NewFitness  = (double*)realloc(CacheFitness, sizeof(double) * NewCapacity);
+	if (NewFitness != NULL) {
+		CacheFitness = NewFitness;
+	}
+	NewHashes   = (uint64_t*)malloc(sizeof(uint64_t) * NewSlots);
+	NewEntry    = (int64_t*)malloc(sizeof(int64_t) * NewSlots);
+	if ((NewGenomes == NULL && GenomeBytes > 0) || NewFitness == NULL || NewHashes == NULL || NewEntry == NULL) {
+		free(NewHashes);
+		free(NewEntry);
+		mexErrMsgIdAndTxt("MATLAB:FitnessCache:outofmemory", "Error: Out of memory while growing the fitness cache!");
+	}
+	CacheCapacity = NewCapacity;
+	CacheHashes   = NewHashes;
+	CacheEntry    = NewEntry;
+	CacheSlots    = NewSlots;
+	memset(CacheEntry, 0xFF, sizeof(int64_t) * NewSlots);
+
+	for (Slot = 0; Slot < OldSlots; Slot++) {
+		if (OldEntry[Slot] >= 0) {
+			size_t NewSlot = OldHashes[Slot] & (NewSlots - 1);
+			while (CacheEntry[NewSlot] >= 0) {
+				NewSlot = (NewSlot + 1) & (NewSlots - 1);
+			}
+			CacheHashes[NewSlot] = OldHashes[Slot];
+			CacheEntry[NewSlot]  = OldEntry[Slot];
+		}
+	}
+
+	free(OldHashes);
+	free(OldEntry);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for emptying the cache and releasing its memory.									 */
+void CacheFree(void){
+	free(CacheHashes);
+	free(CacheEntry);
+	free(CacheGenomes);
+	free(CacheFitness);
+	CacheHashes  = NULL;
+	CacheEntry   = NULL;
+	CacheGenomes = NULL;
+	CacheFitness = NULL;
+	CacheSlots = CacheEntries = CacheCapacity = CacheWords = CacheGenes = 0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
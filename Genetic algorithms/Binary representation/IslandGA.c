@@ -0,0 +1,1323 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Island model genetic algorithm.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which runs a complete binary genetic algorithm on several islands in
+parallel, where each island evolves a population of its own and the islands periodically exchange
+their best individuals (migration).
+
+Each island has its own population buffers and its own random number generator, and performs per
+generation:
+* Elitism: the 'Elites' best individuals are copied unchanged to the next generation.
+* Parent selection: tournament selection with 'k' contenders, as in TournamentSelection.
+* Recombination: N-point crossover of two parents into two children, as in NpointCrossover.
+* Mutation: bitflip mutation with probability 'Pm' of the children, as in BitflipMutation.
+* Evaluation: a built-in fitness function, as in EvaluatePopulation.
+The chromosomes are stored packed into 64-bit words (gene j in bit j%64 of word j/64), so crossover
+swaps whole words between the parents and mutation uses skip sampling, i.e. it draws the distance
+to the next flipped gene rather than one random number per gene.
+
+The islands and the fitness evaluation within each island share one team of OpenMP threads: the
+islands are split evenly over the threads, and the evaluation of the offspring of an island is
+split into tasks (taskloop), so when there are fewer islands than threads the idle threads take
+over evaluation tasks from the busy islands, and the number of threads never exceeds the team.
+Only the evaluation is split, and the islands migrate in step (see below), so the random numbers
+drawn by each island, the migrants it receives, and therefore the results for a given seed do not
+depend on the number of threads. The exception is migration through shared memory (see below):
+when migrants arrive from islands in other processes depends on the timing of those processes.
+Compilers without OpenMP 4.5 (e.g. Microsoft Visual C++) evaluate the offspring of each island on
+the thread of the island.
+
+Every 'MigrationInterval' generations each island sends copies of its 'Migrants' best individuals
+to a neighbour, and replaces its worst individuals by the migrants that have arrived from other
+islands. In a 'ring' topology island i sends to island i+1, in a 'random' topology to a randomly
+drawn island. The islands are run in epochs of 'MigrationInterval' generations: every island of
+the process evolves up to the next migration, then all of them send their migrants, and then all
+of them receive. So every island takes part in every migration, also when there are more islands
+than threads (or no OpenMP at all), in which case a thread runs its islands in turn within each
+epoch. Migrants are passed through lock-free single-producer single-consumer queues, one per pair
+of islands that can communicate. Islands in other processes do not wait for each other: if a queue
+is full the migrants are dropped, and an island that finds no migrants simply continues.
+
+Islands can also run in several processes on the same host, e.g. to isolate crashes or to combine
+IslandGA with islands driven from Matlab. The migration queues are then placed in a POSIX shared
+memory segment created beforehand with ShmMigration('create', ...), which has the same layout as the
+in-process queues, and each process runs 'Islands' of the islands in the segment starting at
+'FirstIsland'. The topology then spans all islands in the segment, so a process running a single
+island still exchanges migrants with the islands of the other processes.
+
+All buffers of the islands (populations, offspring, fitness, scratch and migration queues) are
+carved out of one memory arena, which is kept between calls and only reallocated if a call needs
+more memory than any call before it, so repeated calls do not allocate. The buffers of each island
+start on their own cache line, so that islands on different threads never share a cache line. The
+arena is freed by "clear IslandGA" or when Matlab exits.
+
+An arena of at least 2 MB is aligned to 2 MB and marked for transparent huge pages on Linux, which
+saves TLB misses on large islands. With HugePages 'explicit' it is instead taken from the reserved
+huge pages (MAP_HUGETLB on Linux, large pages on Windows, which need the "Lock pages in memory"
+privilege), falling back to transparent huge pages if none are available. On machines with several
+NUMA nodes, the NUMA option gives each island its own page-aligned block of the arena, and the
+thread running the island binds that block to its own node (mbind on Linux) before touching it, so
+that an island never works on memory of another node, also when the arena is reused by a later
+call. This is most effective with the threads pinned to cores, e.g. with OMP_PROC_BIND=spread.
+
+A run can be traced by giving the name of a file in the Trace option. The phases of every island
+(initialization, and per generation emigration, immigration, elitism, selection and crossover,
+mutation and evaluation) and the evaluation tasks are then recorded as spans of the thread that ran
+them, and written to the file in the Chrome trace event format, which can be opened in Perfetto
+(ui.perfetto.dev) or chrome://tracing to see where the time of each generation went. Selection and
+crossover alternate per pair of children, so they are recorded as one span. Each thread records
+into a buffer of its own, which it appends to the file whenever it is full, so the file grows
+during a long run and can be opened before the run has ended. The timestamps are taken from the
+monotonic clock of the host, so the traces of several processes sharing a ShmMigration segment can
+be opened together.
+
+Calls into Matlab can only be made from the main thread, so the fitness function has to be one of
+the built-in fitness functions of EvaluatePopulation ('onemax', 'leadingones' or 'trap5').
+
+The function takes 3 inputs:
+* Input 1: the name of a built-in fitness function, see above.
+* Input 2: a [1 x 1] scalar 'n' specifying the number of genes per chromosome.
+* Input 3: (optional) a struct 'Options' with any of the following fields:
+	Islands           - number of islands (default 4).
+	IslandSize        - number of individuals per island (default 100).
+	Generations       - number of generations (default 100).
+	k                 - number of contenders per tournament (default 3).
+	N                 - number of crossover points, between 1 and n-1 (default 2).
+	Pm                - mutation probability per gene (default 1/n).
+	Elites            - number of elites per island (default 1).
+	MigrationInterval - number of generations between migrations (default 10).
+	Migrants          - number of individuals sent per migration (default 2).
+	Topology          - 'ring' or 'random' (default 'ring').
+	Seed              - seed of the random number generators (default from the clock).
+	SharedMemory      - name of a ShmMigration segment to migrate through (POSIX only, default none).
+	FirstIsland       - 1-based index in the segment of the first island of this process (default 1).
+	HugePages         - 'off', 'transparent' or 'explicit' (default 'transparent').
+	NUMA              - true to place the memory of each island on the node of its thread (default
+	                    false).
+	Trace             - name of a file to write a trace of the run to, see above (default none).
+
+The function outputs 3 variables:
+* Output 1: a [Islands*IslandSize x n] boolean matrix containing the final populations, where the
+rows of island i are (i-1)*IslandSize+1 to i*IslandSize.
+* Output 2: a [Islands*IslandSize x 1] vector with the fitness of the final populations.
+* Output 3: a [Generations x Islands] matrix with the best fitness of each island per generation.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64 with OpenMP enabled
+>> mex COMPFLAGS="$COMPFLAGS /openmp" IslandGA.c
+>> mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" IslandGA.c
+
+% Run from Matlab when compiled:
+>> Options = struct('Islands', 8, 'IslandSize', 200, 'Generations', 500, 'Topology', 'random');
+>> [ Population, Fitness, BestFitness ] = IslandGA( 'trap5', 200, Options );
+% Run with a trace of the run, to be opened in ui.perfetto.dev:
+>> Options.Trace = 'IslandGA.json';
+>> [ Population, Fitness, BestFitness ] = IslandGA( 'trap5', 200, Options );
+
+% Run one island in each of two Matlab sessions, migrating through shared memory:
+>> ShmMigration( 'create', 'ga_run1', 2, 16, 200 );
+>> Options = struct('Islands', 1, 'SharedMemory', 'ga_run1', 'FirstIsland', 1); % 2 in session 2
+>> [ Population, Fitness, BestFitness ] = IslandGA( 'trap5', 200, Options );
+% Check that the migrants of island 1 reach island 2, here without a session running island 2:
+>> [ Immigrants, ImmigrantFitness ] = ShmMigration( 'receive', 'ga_run1', 2 );
+>> ShmMigration( 'unlink', 'ga_run1' );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used as default seed.
+#include <math.h>   // Needed for log() and log1p() in the skip sampling of the mutation.
+#include <string.h> // Needed for memcpy, memset and strcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#include <stdio.h>  // Needed for writing the trace file.
+#ifdef _OPENMP
+#include <omp.h>    // Needed for omp_get_thread_num.
+#endif
+#ifdef _MSC_VER
+#include <intrin.h> // Needed for __popcnt64 and _ReadWriteBarrier.
+#include <malloc.h> // Needed for _aligned_malloc.
+#endif
+#ifdef _WIN32
+#include <windows.h> // Needed for VirtualAlloc with large pages.
+#endif
+#ifdef __linux__
+#include <sys/syscall.h> // Needed for the mbind and getcpu system calls.
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>    // Needed for shm_open.
+#include <sys/mman.h> // Needed for shm_open and mmap.
+#include <sys/stat.h> // Needed for fstat.
+#include <unistd.h>   // Needed for close.
+#define SHM_SUPPORTED
+#endif
+
+/* Alignment of the arena buffers, and of arenas large enough to be backed by huge pages.		 */
+#define CACHE_LINE 64
+#define SMALL_PAGE 4096
+#define HUGE_PAGE (2 * 1024 * 1024)
+
+/* Approximate number of 64-bit words of chromosomes evaluated per evaluation task.				 */
+#define EVALUATION_TASK_WORDS 16384
+
+/* OpenMP version with taskloops (4.5).															 */
+#if defined(_OPENMP) && _OPENMP >= 201511
+#define OMP_TASKLOOP
+#endif
+
+/* Number of trace events a thread buffers before it appends them to the trace file.			 */
+#define TRACE_BUFFER_EVENTS 4096
+
+/* Huge page modes of the arena.																 */
+#define HUGE_PAGES_OFF 0
+#define HUGE_PAGES_TRANSPARENT 1
+#define HUGE_PAGES_EXPLICIT 2
+
+/* Memory policy constants of mbind, from linux/mempolicy.h.									 */
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+
+/* ——————————————————————————————————————————— Types ——————————————————————————————————————————— */
+typedef double (*FitnessFunction)(const uint64_t *Genome, size_t n, void *Context);
+
+/* Lock-free single-producer single-consumer queue of migrants. Head is only written by the		 */
+/* consumer and Tail only by the producer, and they are kept on separate cache lines. The queue	 */
+/* holds no pointers, so that it can be placed in shared memory: its fitness and packed			 */
+/* chromosome slots follow directly after it. This layout is shared with ShmMigration.			 */
+typedef struct {
+	volatile uint64_t Head;
+	char PadHead[64 - sizeof(uint64_t)];
+	volatile uint64_t Tail;
+	char PadTail[64 - sizeof(uint64_t)];
+	uint64_t Capacity;
+	char PadCapacity[64 - sizeof(uint64_t)];
+} MigrationQueue;               // Followed by double Fitness[Capacity], uint64_t Genomes[Capacity x Words].
+
+/* Header of a ShmMigration segment, which is followed by its Islands x Islands queues.			 */
+#define SHM_MAGIC 0x3130304D48534147ULL  // "GASHM001"
+
+typedef struct {
+	uint64_t Magic;
+	uint64_t Islands, Capacity, Genes, Words, QueueBytes;
+	uint64_t Pad[2];
+} ShmHeader;
+
+/* A span of a trace. The island and generation are 1-based, and 0 where they do not apply.		 */
+typedef struct {
+	const char *Name;
+	double Start, Duration;     // Microseconds.
+	int Island, Generation;
+} TraceEvent;
+
+/* Buffer of the trace events of one thread, which only that thread writes to.					 */
+typedef struct {
+	int Count;
+	TraceEvent Events[TRACE_BUFFER_EVENTS];
+} TraceBuffer;
+
+/* Trace of a call, written as a JSON array of Chrome trace events.								 */
+typedef struct {
+	FILE *File;
+	long Process;
+	int Threads;
+	TraceBuffer *Buffers;       // [Threads x 1] buffers, one per OpenMP thread.
+} Tracer;
+
+/* Parameters shared by all islands.															 */
+typedef struct {
+	FitnessFunction Fitness;
+	size_t n, Words, m;
+	int Islands, Generations, k, N, Elites, MigrationInterval, Migrants;
+	bool RandomTopology;
+	bool NumaPlacement;         // True to bind the block of each island to the node of its thread.
+	int HugePages;              // HUGE_PAGES_OFF, HUGE_PAGES_TRANSPARENT or HUGE_PAGES_EXPLICIT.
+	double Pm;
+	int TotalIslands;           // Number of islands in all processes.
+	int FirstIsland;            // 0-based index of the first island of this process.
+	char *Queues;               // [TotalIslands x TotalIslands] queues, destination-major.
+	size_t QueueBytes;          // Bytes per queue, including its slots.
+	double *BestFitness;        // [Generations x Islands] best fitness per generation.
+	Tracer *Trace;              // Trace of the call, or NULL if it is not traced.
+} GAParameters;
+
+/* State of one island.																			 */
+typedef struct {
+	uint64_t *Population, *Offspring;  // [m+1 x Words] packed individuals of this/next generation.
+	double *Fitness, *OffspringFitness;
+	int *Order;                        // [m x 1] scratch for the best/worst rows.
+	int *ContenderList;                // [k x 1] scratch for the tournament contenders.
+	int *CrossOverPoints;              // [N x 1] scratch for the crossover points.
+	char *Block;                       // Block of the arena holding the buffers above.
+	size_t BlockBytes;
+	uint64_t Rng[4];
+	char Pad[2 * CACHE_LINE - 8 * sizeof(void*) - sizeof(size_t) - 4 * sizeof(uint64_t)]; // Islands never share a cache line.
+} Island;
+
+/* Memory arena from which buffers are carved by bumping an offset. It is kept between calls.	 */
+typedef struct {
+	char *Base;
+	size_t Capacity, Used;
+	int HugePages;              // Huge page mode the arena was allocated with.
+	bool Mapped;                // True if the arena is mapped huge pages rather than from the heap.
+} Arena;
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void InitIsland(const GAParameters *GA, Island *Isl, int IslandNo);
+
+void EvolveIsland(const GAParameters *GA, Island *Isl, int IslandNo, int FirstGeneration, int EndGeneration);
+
+int Tournament(const GAParameters *GA, Island *Isl);
+
+void Crossover(const GAParameters *GA, Island *Isl, const uint64_t *P1, const uint64_t *P2, uint64_t *C1, uint64_t *C2);
+
+void Mutate(const GAParameters *GA, Island *Isl, uint64_t *Genome);
+
+void Emigrate(const GAParameters *GA, Island *Isl, int IslandNo, int Generation);
+
+void Immigrate(const GAParameters *GA, Island *Isl, int IslandNo, int Generation);
+
+void EvaluateOffspring(const GAParameters *GA, Island *Isl, int IslandNo, int Generation);
+
+MigrationQueue *GetQueue(const GAParameters *GA, int Destination, int Source);
+
+ShmHeader *MapSegment(const char *Name, size_t *Bytes);
+
+void SelectRows(const double *Fitness, size_t m, int Count, bool Best, int *Rows);
+
+bool QueuePush(MigrationQueue *Q, const uint64_t *Genome, double Fitness, size_t Words);
+
+bool QueuePop(MigrationQueue *Q, uint64_t *Genome, double *Fitness, size_t Words);
+
+uint64_t RngNext(uint64_t *s);
+
+void RngSeed(uint64_t *s, uint64_t Seed);
+
+unsigned int RandBelow(uint64_t *s, unsigned int Range);
+
+double RandUnit(uint64_t *s);
+
+double OneMax(const uint64_t *Genome, size_t n, void *Context);
+
+double LeadingOnes(const uint64_t *Genome, size_t n, void *Context);
+
+double Trap5(const uint64_t *Genome, size_t n, void *Context);
+
+int Popcount64(uint64_t x);
+
+double GetOption(const mxArray *Options, const char *Name, double Default);
+
+void ArenaReserve(Arena *A, size_t Bytes, int HugePages);
+
+void *ArenaAlloc(Arena *A, size_t Bytes);
+
+void ArenaAlign(Arena *A, size_t Alignment);
+
+void ArenaRelease(Arena *A);
+
+void ArenaFree(void);
+
+void *AllocateHugePages(size_t *Bytes);
+
+void AlignedFree(void *Buffer);
+
+void PlaceOnLocalNode(void *Block, size_t Bytes);
+
+size_t AlignUp(size_t Bytes, size_t Alignment);
+
+bool TraceOpen(Tracer *T, const char *FileName);
+
+double TraceStart(const GAParameters *GA);
+
+void TraceSpan(const GAParameters *GA, const char *Name, double Start, int IslandNo, int Generation);
+
+void TraceFlush(Tracer *T, TraceBuffer *B, int Thread);
+
+void TraceClose(Tracer *T);
+
+int CurrentThread(void);
+
+double WallTime(void);
+
+/* —————————————————————————————— Memory arena kept between calls —————————————————————————————— */
+static Arena Memory;
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	char Name[256], TraceFile[256];
+	const mxArray *Options;
+	mxArray *Field;
+	GAParameters GA;
+	Island *Islands;
+	uint64_t Seed;
+	int i, q, Epoch, EpochEnd;
+	bool Migrating;
+	size_t row, gene, TotalRows, SegmentBytes, IslandBytes, IslandAlignment;
+	ShmHeader *Shm;
+	Tracer Trace;
+
+	bool *PopulationOut;
+	double *FitnessOut;
+
+	mexAtExit(ArenaFree);
+
+	/* ———————————————————————————————————— Get the inputs ————————————————————————————————————— */
+	if (nrhs < 2 || mxGetString(prhs[0], Name, sizeof(Name)) != 0) {
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Input 1 must be the name of a built-in fitness function!");
+	}
+	if (strcmp(Name, "onemax") == 0) {
+		GA.Fitness = OneMax;
+	}
+	else if (strcmp(Name, "leadingones") == 0) {
+		GA.Fitness = LeadingOnes;
+	}
+	else if (strcmp(Name, "trap5") == 0) {
+		GA.Fitness = Trap5;
+	}
+	else {
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Unknown built-in fitness function '%s'!", Name);
+		return;
+	}
+
+	Options = nrhs > 2 && mxIsStruct(prhs[2]) ? prhs[2] : NULL;
+
+	GA.n                 = (size_t)mxGetScalar(prhs[1]);                     // Input 2 (n)
+	GA.Words             = (GA.n + 63) / 64;
+	GA.Islands           = (int)GetOption(Options, "Islands", 4);
+	GA.m                 = (size_t)GetOption(Options, "IslandSize", 100);
+	GA.Generations       = (int)GetOption(Options, "Generations", 100);
+	GA.k                 = (int)GetOption(Options, "k", 3);
+	GA.N                 = (int)GetOption(Options, "N", 2);
+	GA.Pm                = GetOption(Options, "Pm", 1.0 / (double)GA.n);
+	GA.Elites            = (int)GetOption(Options, "Elites", 1);
+	GA.MigrationInterval = (int)GetOption(Options, "MigrationInterval", 10);
+	GA.Migrants          = (int)GetOption(Options, "Migrants", 2);
+	Seed                 = (uint64_t)GetOption(Options, "Seed", (double)clock());
+
+	GA.FirstIsland       = (int)GetOption(Options, "FirstIsland", 1) - 1;
+
+	GA.RandomTopology = false;
+	Field = Options ? mxGetField(Options, 0, "Topology") : NULL;
+	if (Field != NULL) {
+		if (mxGetString(Field, Name, sizeof(Name)) != 0 || (strcmp(Name, "ring") != 0 && strcmp(Name, "random") != 0)) {
+			mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Topology must be 'ring' or 'random'!");
+		}
+		GA.RandomTopology = strcmp(Name, "random") == 0;
+	}
+
+	GA.HugePages = HUGE_PAGES_TRANSPARENT;
+	Field = Options ? mxGetField(Options, 0, "HugePages") : NULL;
+	if (Field != NULL) {
+		if (mxGetString(Field, Name, sizeof(Name)) != 0 || (strcmp(Name, "off") != 0 && strcmp(Name, "transparent") != 0 && strcmp(Name, "explicit") != 0)) {
+			mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: HugePages must be 'off', 'transparent' or 'explicit'!");
+		}
+		GA.HugePages = strcmp(Name, "off") == 0 ? HUGE_PAGES_OFF : strcmp(Name, "explicit") == 0 ? HUGE_PAGES_EXPLICIT : HUGE_PAGES_TRANSPARENT;
+	}
+	GA.NumaPlacement = GetOption(Options, "NUMA", 0) != 0;
+
+	TraceFile[0] = '\0';
+	Field = Options ? mxGetField(Options, 0, "Trace") : NULL;
+	if (Field != NULL && (mxGetString(Field, TraceFile, sizeof(TraceFile)) != 0 || TraceFile[0] == '\0')) {
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Trace must be the name of a file!");
+	}
+
+	if (GA.n < 2 || GA.N < 1 || GA.N > (int)GA.n - 1) {
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Crossover points (N) must be between 1 and n-1!");
+	}
+	if (GA.Islands < 1 || GA.m < 2 || GA.Generations < 1 || GA.k < 1 || GA.k > (int)GA.m) {
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Islands, IslandSize, Generations and k must be positive, with k <= IslandSize!");
+	}
+	if (GA.Elites < 0 || GA.Elites >= (int)GA.m || GA.Migrants < 0 || GA.Migrants >= (int)GA.m || GA.MigrationInterval < 1) {
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Elites and Migrants must be smaller than IslandSize, and MigrationInterval positive!");
+	}
+
+	/* ———————————————————————————————— Specify Matlab outputs ————————————————————————————————— */
+	TotalRows = (size_t)GA.Islands * GA.m;
+	plhs[0] = mxCreateLogicalMatrix(TotalRows, GA.n);
+	PopulationOut = mxGetLogicals(plhs[0]);
+	plhs[1] = mxCreateDoubleMatrix(TotalRows, 1, mxREAL);
+	FitnessOut = mxGetPr(plhs[1]);
+	plhs[2] = mxCreateDoubleMatrix(GA.Generations, GA.Islands, mxREAL);
+	GA.BestFitness = mxGetPr(plhs[2]);
+
+	/* ———————————————————————————————— Reserve the memory arena ———————————————————————————————— */
+	/* Room for the islands, the in-process queues and the block of each island. The blocks are	 */
+	/* page aligned for NUMA placement, so that no page is shared by two islands.				 */
+	GA.QueueBytes = (sizeof(MigrationQueue) + (sizeof(double) + sizeof(uint64_t) * GA.Words) * (2 * (size_t)GA.Migrants + 1) + 63) / 64 * 64;
+	IslandBytes = 2 * AlignUp(sizeof(uint64_t) * (GA.m + 1) * GA.Words, CACHE_LINE) + 2 * AlignUp(sizeof(double) * (GA.m + 1), CACHE_LINE) +
+		AlignUp(sizeof(int) * GA.m, CACHE_LINE) + AlignUp(sizeof(int) * GA.k, CACHE_LINE) + AlignUp(sizeof(int) * GA.N, CACHE_LINE);
+	IslandAlignment = !GA.NumaPlacement ? CACHE_LINE : GA.HugePages != HUGE_PAGES_OFF && IslandBytes >= HUGE_PAGE ? HUGE_PAGE : SMALL_PAGE;
+	ArenaReserve(&Memory, AlignUp(sizeof(Island) * GA.Islands, CACHE_LINE) + AlignUp((size_t)GA.Islands * GA.Islands * GA.QueueBytes, CACHE_LINE) +
+		IslandAlignment + (size_t)GA.Islands * AlignUp(IslandBytes, IslandAlignment), GA.HugePages);
+
+	/* ————————————————————————— Allocate or map the migration queues —————————————————————————— */
+	Shm = NULL;
+	Field = Options ? mxGetField(Options, 0, "SharedMemory") : NULL;
+	if (Field != NULL) {
+		if (mxGetString(Field, Name + 1, sizeof(Name) - 1) != 0) {
+			mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: SharedMemory must be the name of a ShmMigration segment!");
+		}
+		Name[0] = '/';
+		Shm = MapSegment(Name, &SegmentBytes);
+		if (Shm->Genes != GA.n || GA.FirstIsland < 0 || GA.FirstIsland + GA.Islands > (int)Shm->Islands) {
+#ifdef SHM_SUPPORTED
+			munmap(Shm, SegmentBytes);
+#endif
+			mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: The segment must be for n genes and hold islands FirstIsland to FirstIsland+Islands-1!");
+		}
+		GA.TotalIslands = (int)Shm->Islands;
+		GA.QueueBytes   = (size_t)Shm->QueueBytes;
+		GA.Queues       = (char*)Shm + sizeof(ShmHeader);
+	}
+	else {
+		GA.TotalIslands = GA.Islands;
+		GA.FirstIsland  = 0;
+		GA.Queues       = (char*)ArenaAlloc(&Memory, (size_t)GA.Islands * GA.Islands * GA.QueueBytes);
+		memset(GA.Queues, 0, (size_t)GA.Islands * GA.Islands * GA.QueueBytes);
+		for (q = 0; q < GA.Islands * GA.Islands; q++) {
+			GetQueue(&GA, q / GA.Islands, q % GA.Islands)->Capacity = 2 * (uint64_t)GA.Migrants + 1;
+		}
+	}
+
+	/* ————————————————————————————————— Allocate the islands —————————————————————————————————— */
+	Islands = (Island*)ArenaAlloc(&Memory, sizeof(Island) * GA.Islands);
+	memset(Islands, 0, sizeof(Island) * GA.Islands);
+	for (i = 0; i < GA.Islands; i++) {
+		ArenaAlign(&Memory, IslandAlignment);
+		Islands[i].Block            = Memory.Base + Memory.Used;
+		Islands[i].BlockBytes       = AlignUp(IslandBytes, IslandAlignment);
+		Islands[i].Population       = (uint64_t*)ArenaAlloc(&Memory, sizeof(uint64_t) * (GA.m + 1) * GA.Words);
+		Islands[i].Offspring        = (uint64_t*)ArenaAlloc(&Memory, sizeof(uint64_t) * (GA.m + 1) * GA.Words);
+		Islands[i].Fitness          = (double*)ArenaAlloc(&Memory, sizeof(double) * (GA.m + 1));
+		Islands[i].OffspringFitness = (double*)ArenaAlloc(&Memory, sizeof(double) * (GA.m + 1));
+		Islands[i].Order            = (int*)ArenaAlloc(&Memory, sizeof(int) * GA.m);
+		Islands[i].ContenderList    = (int*)ArenaAlloc(&Memory, sizeof(int) * GA.k);
+		Islands[i].CrossOverPoints  = (int*)ArenaAlloc(&Memory, sizeof(int) * GA.N);
+		Memory.Used = (size_t)(Islands[i].Block - Memory.Base) + Islands[i].BlockBytes;
+		RngSeed(Islands[i].Rng, Seed + (uint64_t)(GA.FirstIsland + i));
+	}
+
+	/* —————————————————————————————————— Open the trace file —————————————————————————————————— */
+	GA.Trace = TraceFile[0] != '\0' ? &Trace : NULL;
+	if (GA.Trace != NULL && !TraceOpen(GA.Trace, TraceFile)) {
+		if (Shm != NULL) {
+#ifdef SHM_SUPPORTED
+			munmap(Shm, SegmentBytes);
+#endif
+		}
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:invalidinputs", "Error: Could not open the trace file '%s'!", TraceFile);
+	}
+
+	/* ———————————————————————————————————— Run the islands ———————————————————————————————————— */
+	/* The islands are run epoch by epoch, and the migrants are only sent once every island has	 */
+	/* reached the end of the epoch, and only received once all have been sent. The islands are	 */
+	/* split statically, so that an island stays on the thread (and node) that first touched its */
+	/* memory, and threads that wait at the end of an epoch take evaluation tasks of the others. */
+	Migrating = GA.Migrants > 0 && GA.TotalIslands > 1;
+	#pragma omp parallel private(Epoch, EpochEnd)
+	{
+		#pragma omp for schedule(static)
+		for (i = 0; i < GA.Islands; i++) {
+			InitIsland(&GA, &Islands[i], i);
+		}
+		for (Epoch = 0; Epoch < GA.Generations; Epoch = EpochEnd) {
+			EpochEnd = GA.Generations - Epoch > GA.MigrationInterval ? Epoch + GA.MigrationInterval : GA.Generations;
+			if (Epoch > 0 && Migrating) {
+				#pragma omp for schedule(static)
+				for (i = 0; i < GA.Islands; i++) {
+					Emigrate(&GA, &Islands[i], i, Epoch + 1);
+				}
+				#pragma omp for schedule(static)
+				for (i = 0; i < GA.Islands; i++) {
+					Immigrate(&GA, &Islands[i], i, Epoch + 1);
+				}
+			}
+			#pragma omp for schedule(static)
+			for (i = 0; i < GA.Islands; i++) {
+				EvolveIsland(&GA, &Islands[i], i, Epoch, EpochEnd);
+			}
+		}
+	}
+	if (GA.Trace != NULL) {
+		TraceClose(GA.Trace);
+	}
+
+	/* ————————————————————————————— Unpack the final populations —————————————————————————————— */
+	for (i = 0; i < GA.Islands; i++) {
+		for (row = 0; row < GA.m; row++) {
+			FitnessOut[i * GA.m + row] = Islands[i].Fitness[row];
+			for (gene = 0; gene < GA.n; gene++) {
+				PopulationOut[i * GA.m + row + TotalRows * gene] = (Islands[i].Population[row * GA.Words + gene / 64] >> (gene % 64)) & 1;
+			}
+		}
+	}
+	if (Shm != NULL) {
+#ifdef SHM_SUPPORTED
+		munmap(Shm, SegmentBytes);
+#endif
+	}
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for creating the random initial population of an island. IslandNo is the index		 */
+/* of the island within this process.															 */
+void InitIsland(const GAParameters *GA, Island *Isl, int IslandNo){
+
+	size_t m = GA->m, Words = GA->Words, row, word;
+	double Start;
+
+	/* Bind the memory of the island to the node of this thread before it is first touched.		 */
+	if (GA->NumaPlacement) {
+		PlaceOnLocalNode(Isl->Block, Isl->BlockBytes);
+	}
+
+	/* Random initial population.																 */
+	Start = TraceStart(GA);
+	for (row = 0; row < m; row++) {
+		for (word = 0; word < Words; word++) {
+			Isl->Population[row * Words + word] = RngNext(Isl->Rng);
+		}
+		if (GA->n % 64 != 0) {
+			Isl->Population[row * Words + Words - 1] &= ((uint64_t)1 << (GA->n % 64)) - 1;
+		}
+		Isl->Fitness[row] = GA->Fitness(Isl->Population + row * Words, GA->n, NULL);
+	}
+	TraceSpan(GA, "Initialization", Start, IslandNo, 0);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for evolving one island through the 0-based generations FirstGeneration to			 */
+/* EndGeneration-1. IslandNo is the index of the island within this process.					 */
+void EvolveIsland(const GAParameters *GA, Island *Isl, int IslandNo, int FirstGeneration, int EndGeneration){
+
+	size_t m = GA->m, Words = GA->Words, row;
+	int Generation, e, P1, P2;
+	uint64_t *Swap;
+	double *SwapFitness, Best, Start, GenerationStart;
+
+	for (Generation = FirstGeneration; Generation < EndGeneration; Generation++) {
+		GenerationStart = TraceStart(GA);
+
+		/* Copy the elites to the top of the next generation.									 */
+		if (GA->Elites > 0) {
+			Start = TraceStart(GA);
+			SelectRows(Isl->Fitness, m, GA->Elites, true, Isl->Order);
+			for (e = 0; e < GA->Elites; e++) {
+				memcpy(Isl->Offspring + e * Words, Isl->Population + Isl->Order[e] * Words, sizeof(uint64_t) * Words);
+				Isl->OffspringFitness[e] = Isl->Fitness[Isl->Order[e]];
+			}
+			TraceSpan(GA, "Elitism", Start, IslandNo, Generation + 1);
+		}
+
+		/* Fill the rest with mutated children of tournament winners. The offspring buffer has	 */
+		/* room for one extra row, so that the last pair may overshoot by one child.			 */
+		Start = TraceStart(GA);
+		for (row = GA->Elites; row < m; row += 2) {
+			P1 = Tournament(GA, Isl);
+			P2 = Tournament(GA, Isl);
+			Crossover(GA, Isl, Isl->Population + P1 * Words, Isl->Population + P2 * Words,
+			          Isl->Offspring + row * Words, Isl->Offspring + (row + 1) * Words);
+		}
+		TraceSpan(GA, "Selection and crossover", Start, IslandNo, Generation + 1);
+
+		Start = TraceStart(GA);
+		for (row = GA->Elites; row < m; row++) {
+			Mutate(GA, Isl, Isl->Offspring + row * Words);
+		}
+		TraceSpan(GA, "Mutation", Start, IslandNo, Generation + 1);
+
+		Start = TraceStart(GA);
+		EvaluateOffspring(GA, Isl, IslandNo, Generation + 1);
+		TraceSpan(GA, "Evaluation", Start, IslandNo, Generation + 1);
+
+		/* The offspring become the population of the next generation.							 */
+		Swap = Isl->Population;
+		Isl->Population = Isl->Offspring;
+		Isl->Offspring = Swap;
+		SwapFitness = Isl->Fitness;
+		Isl->Fitness = Isl->OffspringFitness;
+		Isl->OffspringFitness = SwapFitness;
+
+		Best = Isl->Fitness[0];
+		for (row = 1; row < m; row++) {
+			if (Isl->Fitness[row] > Best) {
+				Best = Isl->Fitness[row];
+			}
+		}
+		GA->BestFitness[Generation + (size_t)GA->Generations * IslandNo] = Best;
+		TraceSpan(GA, "Generation", GenerationStart, IslandNo, Generation + 1);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for evaluating the offspring of an island, except the elites. The rows are split	 */
+/* into tasks of about EVALUATION_TASK_WORDS words, which idle threads of the team can take.	 */
+/* IslandNo and Generation only label the tasks in the trace.									 */
+void EvaluateOffspring(const GAParameters *GA, Island *Isl, int IslandNo, int Generation){
+
+	ptrdiff_t row, Task, End;
+	ptrdiff_t Grain = (ptrdiff_t)(EVALUATION_TASK_WORDS / GA->Words) + 1;
+	ptrdiff_t Tasks = ((ptrdiff_t)GA->m - GA->Elites + Grain - 1) / Grain;
+	double Start;
+
+#ifdef OMP_TASKLOOP
+	#pragma omp taskloop grainsize(1) private(row, End, Start) if(Tasks > 1)
+#endif
+	for (Task = 0; Task < Tasks; Task++) {
+		Start = TraceStart(GA);
+		End = GA->Elites + (Task + 1) * Grain < (ptrdiff_t)GA->m ? GA->Elites + (Task + 1) * Grain : (ptrdiff_t)GA->m;
+		for (row = GA->Elites + Task * Grain; row < End; row++) {
+			Isl->OffspringFitness[row] = GA->Fitness(Isl->Offspring + row * GA->Words, GA->n, NULL);
+		}
+		TraceSpan(GA, "Evaluation task", Start, IslandNo, Generation);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for holding one tournament among k unique contenders. Returns the winning row.		 */
+int Tournament(const GAParameters *GA, Island *Isl){
+
+	int Contender, ContenderIndex, row, WinnerIndex;
+	int *ContenderList = Isl->ContenderList;
+	bool AlreadyInTour;
+
+	Contender = 0;
+	WinnerIndex = 0;
+	while (Contender < GA->k){
+		ContenderIndex = (int)RandBelow(Isl->Rng, (unsigned int)GA->m);
+		AlreadyInTour = false;
+		for (row = 0; row < Contender; row++) {
+			if (ContenderIndex == ContenderList[row]) {
+				AlreadyInTour = true;
+			}
+		}
+		if (AlreadyInTour == false) {
+			ContenderList[Contender] = ContenderIndex;
+			if (Contender == 0 || Isl->Fitness[ContenderIndex] > Isl->Fitness[WinnerIndex]) {
+				WinnerIndex = ContenderIndex;
+			}
+			Contender++;
+		}
+	}
+	return WinnerIndex;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for N-point crossover of two packed parents into two children. Segments alternate	 */
+/* between the parents at N unique crossover points, and the bits of every second segment are	 */
+/* swapped between the children word by word.													 */
+void Crossover(const GAParameters *GA, Island *Isl, const uint64_t *P1, const uint64_t *P2, uint64_t *C1, uint64_t *C2){
+
+	int i, j, CandidatePoint, Point;
+	size_t Start, End, word;
+	uint64_t Mask, Diff;
+	bool AlreadyChosen;
+
+	memcpy(C1, P1, sizeof(uint64_t) * GA->Words);
+	memcpy(C2, P2, sizeof(uint64_t) * GA->Words);
+
+	/* Pick N unique crossover points in 1..n-1, sorted by insertion.							 */
+	i = 0;
+	while (i < GA->N) {
+		CandidatePoint = 1 + (int)RandBelow(Isl->Rng, (unsigned int)GA->n - 1);
+		AlreadyChosen = false;
+		for (j = 0; j < i; j++) {
+			if (CandidatePoint == Isl->CrossOverPoints[j]) {
+				AlreadyChosen = true;
+			}
+		}
+		if (AlreadyChosen == false) {
+			for (j = i; j > 0 && Isl->CrossOverPoints[j - 1] > CandidatePoint; j--) {
+				Isl->CrossOverPoints[j] = Isl->CrossOverPoints[j - 1];
+			}
+			Isl->CrossOverPoints[j] = CandidatePoint;
+			i++;
+		}
+	}
+
+	/* Swap the genes of every second segment, [Point_1, Point_2), [Point_3, Point_4) etc.		 */
+	for (Point = 0; Point < GA->N; Point += 2) {
+		Start = (size_t)Isl->CrossOverPoints[Point];
+		End   = Point + 1 < GA->N ? (size_t)Isl->CrossOverPoints[Point + 1] : GA->n;
+		for (word = Start / 64; word <= (End - 1) / 64; word++) {
+			Mask = ~(uint64_t)0;
+			if (word == Start / 64) {
+				Mask &= ~(uint64_t)0 << (Start % 64);
+			}
+			if (word == (End - 1) / 64 && End % 64 != 0) {
+				Mask &= ((uint64_t)1 << (End % 64)) - 1;
+			}
+			Diff = (C1[word] ^ C2[word]) & Mask;
+			C1[word] ^= Diff;
+			C2[word] ^= Diff;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for bitflip mutation of a packed chromosome using skip sampling: the number of		 */
+/* genes skipped before the next flip is geometrically distributed with parameter Pm. log1p		 */
+/* keeps log(1 - Pm) accurate for tiny Pm, where 1 - Pm rounds to 1, and the skip is clamped	 */
+/* to the chromosome length before it is cast, as it is huge or infinite for such Pm.			 */
+void Mutate(const GAParameters *GA, Island *Isl, uint64_t *Genome){
+
+	size_t gene;
+	double LogQ, Skip;
+
+	if (GA->Pm <= 0) {
+		return;
+	}
+	if (GA->Pm >= 1) {
+		for (gene = 0; gene < GA->n; gene++) {
+			Genome[gene / 64] ^= (uint64_t)1 << (gene % 64);
+		}
+		return;
+	}
+
+	LogQ = log1p(-GA->Pm);
+	Skip = floor(log(RandUnit(Isl->Rng)) / LogQ);
+	gene = Skip < (double)GA->n ? (size_t)Skip : GA->n;
+	while (gene < GA->n) {
+		Genome[gene / 64] ^= (uint64_t)1 << (gene % 64);
+		Skip = floor(log(RandUnit(Isl->Rng)) / LogQ);
+		gene += 1 + (Skip < (double)GA->n ? (size_t)Skip : GA->n);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for sending copies of the best individuals of an island to a neighbouring island.	 */
+/* IslandNo is the index of the island within this process, and Generation (1-based) only		 */
+/* labels the span in the trace.																 */
+void Emigrate(const GAParameters *GA, Island *Isl, int IslandNo, int Generation){
+
+	size_t Words = GA->Words;
+	int Source = GA->FirstIsland + IslandNo, Destination, i;
+	MigrationQueue *Q;
+	double Start = TraceStart(GA);
+
+	/* Push copies of the best individuals onto the queue of the destination.					 */
+	SelectRows(Isl->Fitness, GA->m, GA->Migrants, true, Isl->Order);
+	if (GA->RandomTopology) {
+		Destination = (int)RandBelow(Isl->Rng, (unsigned int)GA->TotalIslands - 1);
+		Destination += Destination >= Source;
+	}
+	else {
+		Destination = (Source + 1) % GA->TotalIslands;
+	}
+	Q = GetQueue(GA, Destination, Source);
+	for (i = 0; i < GA->Migrants; i++) {
+		QueuePush(Q, Isl->Population + Isl->Order[i] * Words, Isl->Fitness[Isl->Order[i]], Words);
+	}
+	TraceSpan(GA, "Emigration", Start, IslandNo, Generation);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for replacing the worst individuals of an island by the migrants that have arrived	 */
+/* from other islands. IslandNo and Generation are as in Emigrate.								 */
+void Immigrate(const GAParameters *GA, Island *Isl, int IslandNo, int Generation){
+
+	size_t m = GA->m, Words = GA->Words;
+	int Destination = GA->FirstIsland + IslandNo, Source, i, Arrived;
+	MigrationQueue *Q;
+	double Start = TraceStart(GA);
+
+	/* Collect the arrived migrants in the (still unused) offspring buffer, at most as many as	 */
+	/* there are non-elite rows.																 */
+	Arrived = 0;
+	for (Source = 0; Source < GA->TotalIslands; Source++) {
+		Q = GetQueue(GA, Destination, Source);
+		while (Arrived < (int)m - GA->Elites &&
+		       QueuePop(Q, Isl->Offspring + Arrived * Words, &Isl->OffspringFitness[Arrived], Words)) {
+			Arrived++;
+		}
+	}
+
+	/* The migrants overwrite the worst individuals.											 */
+	SelectRows(Isl->Fitness, m, Arrived, false, Isl->Order);
+	for (i = 0; i < Arrived; i++) {
+		memcpy(Isl->Population + Isl->Order[i] * Words, Isl->Offspring + i * Words, sizeof(uint64_t) * Words);
+		Isl->Fitness[Isl->Order[i]] = Isl->OffspringFitness[i];
+	}
+	TraceSpan(GA, "Immigration", Start, IslandNo, Generation);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding the 'Count' best (or worst) rows, ordered best (or worst) first. Each row */
+/* is inserted into a sorted list of the rows found so far, which is O(m) for small Count.		 */
+void SelectRows(const double *Fitness, size_t m, int Count, bool Best, int *Rows){
+
+	size_t row;
+	int Found, j;
+	double f;
+
+	if (Count <= 0) {
+		return;
+	}
+	Found = 0;
+	for (row = 0; row < m; row++) {
+		f = Fitness[row];
+		if (Found < Count || (Best ? f > Fitness[Rows[Count - 1]] : f < Fitness[Rows[Count - 1]])) {
+			j = Found < Count ? Found++ : Count - 1;
+			while (j > 0 && (Best ? f > Fitness[Rows[j - 1]] : f < Fitness[Rows[j - 1]])) {
+				Rows[j] = Rows[j - 1];
+				j--;
+			}
+			Rows[j] = (int)row;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding the queue from island 'Source' to island 'Destination' (0-based).		 */
+MigrationQueue *GetQueue(const GAParameters *GA, int Destination, int Source){
+	return (MigrationQueue*)(GA->Queues + ((size_t)Destination * GA->TotalIslands + Source) * GA->QueueBytes);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for mapping an existing ShmMigration segment. The caller unmaps it.					 */
+ShmHeader *MapSegment(const char *Name, size_t *Bytes){
+#ifdef SHM_SUPPORTED
+	struct stat Info;
+	ShmHeader *Shm;
+	int fd;
+
+	fd = shm_open(Name, O_RDWR, 0600);
+	if (fd < 0) {
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:shmopen", "Error: Shared memory segment '%s' does not exist!", Name);
+	}
+	if (fstat(fd, &Info) != 0 || (size_t)Info.st_size < sizeof(ShmHeader) ||
+	    (Shm = (ShmHeader*)mmap(NULL, (size_t)Info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		close(fd);
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:shmopen", "Error: Could not map shared memory segment '%s'!", Name);
+	}
+	close(fd);
+
+	if (__atomic_load_n(&Shm->Magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+	    sizeof(ShmHeader) + Shm->Islands * Shm->Islands * Shm->QueueBytes > (size_t)Info.st_size) {
+		munmap(Shm, (size_t)Info.st_size);
+		mexErrMsgIdAndTxt("MATLAB:IslandGA:shmopen", "Error: '%s' is not an initialised migration segment!", Name);
+	}
+	*Bytes = (size_t)Info.st_size;
+	return Shm;
+#else
+	mexErrMsgIdAndTxt("MATLAB:IslandGA:unsupported", "Error: Shared memory migration requires a POSIX system!");
+	return NULL;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Functions for atomic access to the queue indices, with acquire and release semantics.		 */
+static uint64_t LoadAcquire(volatile uint64_t *p) {
+#if defined(__GNUC__)
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+	uint64_t v = *p;
+	_ReadWriteBarrier();
+	return v;
+#endif
+}
+
+static void StoreRelease(volatile uint64_t *p, uint64_t v) {
+#if defined(__GNUC__)
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+#else
+	_ReadWriteBarrier();
+	*p = v;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for pushing a migrant onto a queue. Returns false if the queue is full.				 */
+bool QueuePush(MigrationQueue *Q, const uint64_t *Genome, double Fitness, size_t Words){
+
+	uint64_t Tail = Q->Tail, Slot;
+	double *SlotFitness = (double*)(Q + 1);
+	uint64_t *SlotGenomes = (uint64_t*)(SlotFitness + Q->Capacity);
+
+	if (Tail - LoadAcquire(&Q->Head) >= Q->Capacity) {
+		return false;
+	}
+	Slot = Tail % Q->Capacity;
+	memcpy(SlotGenomes + Slot * Words, Genome, sizeof(uint64_t) * Words);
+	SlotFitness[Slot] = Fitness;
+	StoreRelease(&Q->Tail, Tail + 1);
+	return true;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for popping a migrant from a queue. Returns false if the queue is empty.			 */
+bool QueuePop(MigrationQueue *Q, uint64_t *Genome, double *Fitness, size_t Words){
+
+	uint64_t Head = Q->Head, Slot;
+	double *SlotFitness = (double*)(Q + 1);
+	uint64_t *SlotGenomes = (uint64_t*)(SlotFitness + Q->Capacity);
+
+	if (Head == LoadAcquire(&Q->Tail)) {
+		return false;
+	}
+	Slot = Head % Q->Capacity;
+	memcpy(Genome, SlotGenomes + Slot * Words, sizeof(uint64_t) * Words);
+	*Fitness = SlotFitness[Slot];
+	StoreRelease(&Q->Head, Head + 1);
+	return true;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Random number generator (xoshiro256**), one per island so that the islands do not share the	 */
+/* state of rand(). Seeded through splitmix64.													 */
+uint64_t RngNext(uint64_t *s){
+	uint64_t Result = s[1] * 5;
+	uint64_t t = s[1] << 17;
+	Result = ((Result << 7) | (Result >> 57)) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return Result;
+}
+
+void RngSeed(uint64_t *s, uint64_t Seed){
+	int i;
+	uint64_t z;
+	for (i = 0; i < 4; i++) {
+		Seed += 0x9E3779B97F4A7C15ULL;
+		z = Seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s[i] = z ^ (z >> 31);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer in the range 0 to Range-1.								 */
+unsigned int RandBelow(uint64_t *s, unsigned int Range){
+	return (unsigned int)(((RngNext(s) >> 32) * Range) >> 32);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random number in the range (0,1].										 */
+double RandUnit(uint64_t *s){
+	return ((RngNext(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* OneMax: the number of genes that are 1.														 */
+double OneMax(const uint64_t *Genome, size_t n, void *Context){
+	size_t word;
+	int Ones = 0;
+	for (word = 0; word < (n + 63) / 64; word++) {
+		Ones += Popcount64(Genome[word]);
+	}
+	return Ones;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* LeadingOnes: the number of consecutive 1s counted from the first gene.						 */
+double LeadingOnes(const uint64_t *Genome, size_t n, void *Context){
+	size_t word, Ones = 0;
+	uint64_t Zeros;
+	for (word = 0; word < (n + 63) / 64; word++) {
+		if (Genome[word] != ~(uint64_t)0) {
+			Zeros = ~Genome[word];
+			while ((Zeros & 1) == 0) {
+				Zeros >>= 1;
+				Ones++;
+			}
+			break;
+		}
+		Ones += 64;
+	}
+	return (double)(Ones < n ? Ones : n);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Trap5: sum of deceptive traps over consecutive blocks of 5 genes.							 */
+double Trap5(const uint64_t *Genome, size_t n, void *Context){
+	size_t Start, gene, Length;
+	int Ones;
+	double Fitness = 0;
+	for (Start = 0; Start < n; Start += 5) {
+		Length = n - Start < 5 ? n - Start : 5;
+		Ones = 0;
+		for (gene = Start; gene < Start + Length; gene++) {
+			Ones += (int)((Genome[gene / 64] >> (gene % 64)) & 1);
+		}
+		Fitness += Ones == (int)Length ? (double)Length : (double)Length - 1 - Ones;
+	}
+	return Fitness;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for counting the number of bits that are set in a 64-bit word.						 */
+int Popcount64(uint64_t x){
+#if defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64(x);
+#elif defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading a scalar field of the options struct, or its default if missing.		 */
+double GetOption(const mxArray *Options, const char *Name, double Default){
+	mxArray *Field = Options ? mxGetField(Options, 0, Name) : NULL;
+	return Field != NULL && !mxIsEmpty(Field) ? mxGetScalar(Field) : Default;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for making sure that the arena holds at least Bytes bytes, and emptying it. The		 */
+/* arena only grows, so calls with the same sizes as an earlier call reuse its memory.			 */
+void ArenaReserve(Arena *A, size_t Bytes, int HugePages){
+
+	size_t Alignment = HugePages != HUGE_PAGES_OFF && Bytes >= HUGE_PAGE ? HUGE_PAGE : SMALL_PAGE;
+	void *Base = NULL;
+
+	A->Used = 0;
+	if (Bytes <= A->Capacity && HugePages == A->HugePages) {
+		return;
+	}
+	ArenaRelease(A);
+	Bytes = AlignUp(Bytes, Alignment);
+
+	/* Explicit huge pages, if any are available.												 */
+	if (HugePages == HUGE_PAGES_EXPLICIT) {
+		Base = AllocateHugePages(&Bytes);
+		A->Mapped = Base != NULL;
+	}
+	if (Base == NULL) {
+#ifdef _MSC_VER
+		Base = _aligned_malloc(Bytes, Alignment);
+#else
+		if (posix_memalign(&Base, Alignment, Bytes) != 0) {
+			Base = NULL;
+		}
+#endif
+		if (Base == NULL) {
+			mexErrMsgIdAndTxt("MATLAB:IslandGA:outofmemory", "Error: Out of memory while allocating the islands!");
+		}
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		/* Back large arenas with transparent huge pages, to save TLB misses on large islands.	 */
+		if (Alignment == HUGE_PAGE) {
+			madvise(Base, Bytes, MADV_HUGEPAGE);
+		}
+#endif
+	}
+	A->Base = (char*)Base;
+	A->Capacity = Bytes;
+	A->HugePages = HugePages;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for carving a cache line aligned buffer of Bytes bytes out of the arena. The arena	 */
+/* must have been reserved large enough for all buffers of the call.							 */
+void *ArenaAlloc(Arena *A, size_t Bytes){
+	void *Buffer = A->Base + A->Used;
+	A->Used += AlignUp(Bytes, CACHE_LINE);
+	return Buffer;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for moving the next buffer of the arena to an address that is a multiple of			 */
+/* Alignment, which is a power of two.															 */
+void ArenaAlign(Arena *A, size_t Alignment){
+	A->Used = (size_t)(AlignUp((uintptr_t)(A->Base + A->Used), Alignment) - (uintptr_t)A->Base);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for returning the memory of an arena to the system.									 */
+void ArenaRelease(Arena *A){
+	if (A->Mapped) {
+#if defined(_WIN32)
+		VirtualFree(A->Base, 0, MEM_RELEASE);
+#elif defined(SHM_SUPPORTED)
+		munmap(A->Base, A->Capacity);
+#endif
+	}
+	else {
+		AlignedFree(A->Base);
+	}
+	A->Base = NULL;
+	A->Capacity = 0;
+	A->Used = 0;
+	A->Mapped = false;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for freeing the arena, also called when the MEX function is cleared.				 */
+void ArenaFree(void){
+	ArenaRelease(&Memory);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for allocating Bytes bytes of explicit huge pages, rounding Bytes up to whole huge	 */
+/* pages. Returns NULL if no huge pages are available.											 */
+void *AllocateHugePages(size_t *Bytes){
+#if defined(__linux__) && defined(MAP_HUGETLB)
+	void *Base = mmap(NULL, AlignUp(*Bytes, HUGE_PAGE), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (Base == MAP_FAILED) {
+		return NULL;
+	}
+	*Bytes = AlignUp(*Bytes, HUGE_PAGE);
+	return Base;
+#elif defined(_WIN32)
+	size_t LargePage = GetLargePageMinimum();
+	void *Base = LargePage > 0 ? VirtualAlloc(NULL, AlignUp(*Bytes, LargePage), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE) : NULL;
+	if (Base != NULL) {
+		*Bytes = AlignUp(*Bytes, LargePage);
+	}
+	return Base;
+#else
+	(void)Bytes;
+	return NULL;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for freeing a buffer allocated by ArenaReserve from the heap.						 */
+void AlignedFree(void *Buffer){
+#ifdef _MSC_VER
+	_aligned_free(Buffer);
+#else
+	free(Buffer);
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for binding a page-aligned block of memory to the NUMA node of the calling thread.	 */
+/* Pages already on another node are moved, and pages not yet touched will be allocated on the	 */
+/* node. Only done on Linux; elsewhere the pages stay where they were first touched.			 */
+void PlaceOnLocalNode(void *Block, size_t Bytes){
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+	unsigned int Cpu, Node;
+	unsigned long Mask[16];
+
+	if (syscall(SYS_getcpu, &Cpu, &Node, NULL) != 0 || Node >= 8 * sizeof(Mask)) {
+		return;
+	}
+	memset(Mask, 0, sizeof(Mask));
+	Mask[Node / (8 * sizeof(unsigned long))] = 1UL << (Node % (8 * sizeof(unsigned long)));
+	syscall(SYS_mbind, Block, Bytes, MPOL_PREFERRED, Mask, 8 * sizeof(Mask), MPOL_MF_MOVE);
+#else
+	(void)Block;
+	(void)Bytes;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for rounding Bytes up to a multiple of Alignment, which is a power of two.			 */
+size_t AlignUp(size_t Bytes, size_t Alignment){
+	return (Bytes + Alignment - 1) & ~(Alignment - 1);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for opening the trace file and writing the names of the process and its threads.	 */
+/* Returns false if the file cannot be opened.													 */
+bool TraceOpen(Tracer *T, const char *FileName){
+
+	int Thread;
+
+	T->File = fopen(FileName, "w");
+	if (T->File == NULL) {
+		return false;
+	}
+#ifdef _OPENMP
+	T->Threads = omp_get_max_threads();
+#else
+	T->Threads = 1;
+#endif
+#if defined(_WIN32)
+	T->Process = (long)GetCurrentProcessId();
+#elif defined(SHM_SUPPORTED)
+	T->Process = (long)getpid();
+#else
+	T->Process = 1;
+#endif
+	T->Buffers = (TraceBuffer*)malloc(sizeof(TraceBuffer) * T->Threads);
+	if (T->Buffers == NULL) {
+		fclose(T->File);
+		return false;
+	}
+
+	/* Every event after the first is preceded by a comma, so that the file is a valid JSON		 */
+	/* array once the closing bracket is written. Trace viewers also read it without.			 */
+	fprintf(T->File, "[{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %ld, \"args\": {\"name\": \"IslandGA\"}}", T->Process);
+	for (Thread = 0; Thread < T->Threads; Thread++) {
+		T->Buffers[Thread].Count = 0;
+		fprintf(T->File, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %ld, \"tid\": %d, \"args\": {\"name\": \"Thread %d\"}}",
+			T->Process, Thread, Thread);
+	}
+	fflush(T->File);
+	return true;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading the clock at the start of a span, if the call is traced.				 */
+double TraceStart(const GAParameters *GA){
+	return GA->Trace != NULL ? WallTime() : 0.0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for recording a span from Start until now in the buffer of the calling thread, if	 */
+/* the call is traced. IslandNo is the index of the island within this process.					 */
+void TraceSpan(const GAParameters *GA, const char *Name, double Start, int IslandNo, int Generation){
+
+	Tracer *T = GA->Trace;
+	TraceBuffer *B;
+	TraceEvent *E;
+	int Thread;
+
+	if (T == NULL) {
+		return;
+	}
+	Thread = CurrentThread();
+	B = &T->Buffers[Thread];
+	if (B->Count == TRACE_BUFFER_EVENTS) {
+		TraceFlush(T, B, Thread);
+	}
+	E = &B->Events[B->Count++];
+	E->Name       = Name;
+	E->Start      = 1e6 * Start;
+	E->Duration   = 1e6 * (WallTime() - Start);
+	E->Island     = GA->FirstIsland + IslandNo + 1;
+	E->Generation = Generation;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for appending the events of a buffer to the trace file and emptying it. The file is	 */
+/* shared by all threads, so only one thread writes to it at a time.							 */
+void TraceFlush(Tracer *T, TraceBuffer *B, int Thread){
+
+	int e;
+
+	#pragma omp critical(IslandGATrace)
+	{
+		for (e = 0; e < B->Count; e++) {
+			fprintf(T->File, ",\n{\"name\": \"%s\", \"cat\": \"IslandGA\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %ld, \"tid\": %d, "
+				"\"args\": {\"Island\": %d, \"Generation\": %d}}", B->Events[e].Name, B->Events[e].Start, B->Events[e].Duration,
+				T->Process, Thread, B->Events[e].Island, B->Events[e].Generation);
+		}
+		fflush(T->File);
+	}
+	B->Count = 0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for writing the remaining events of all threads and closing the trace file.			 */
+void TraceClose(Tracer *T){
+
+	int Thread;
+
+	for (Thread = 0; Thread < T->Threads; Thread++) {
+		TraceFlush(T, &T->Buffers[Thread], Thread);
+	}
+	fprintf(T->File, "\n]\n");
+	fclose(T->File);
+	free(T->Buffers);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for getting the number of the calling thread within the OpenMP team.				 */
+int CurrentThread(void){
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading a monotonic wall clock in seconds.										 */
+double WallTime(void){
+#ifdef _WIN32
+	LARGE_INTEGER Count, Frequency;
+	QueryPerformanceCounter(&Count);
+	QueryPerformanceFrequency(&Frequency);
+	return (double)Count.QuadPart / (double)Frequency.QuadPart;
+#else
+	struct timespec Now;
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (double)Now.tv_sec + 1e-9 * (double)Now.tv_nsec;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,346 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Shared memory migration between island processes.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which lets islands of an island model GA that run as separate processes on
+the same host (e.g. one Matlab session per island, so that a crash in the fitness code of one
+island does not take down the others) exchange migrants through POSIX shared memory.
+
+The shared memory segment holds one lock-free single-producer single-consumer ring buffer for each
+ordered pair of islands, so any topology can be used and no locks are ever taken. The migrants are
+stored as packed chromosomes (gene j in bit j%64 of word j/64) next to their fitness, so the rows
+selected by e.g. TournamentSelection are copied straight into the ring buffer without any further
+serialisation. If a ring buffer is full the remaining migrants are dropped, and 'receive' returns
+whatever has arrived without waiting.
+
+The segment uses the same layout as the in-process migration queues of IslandGA, so IslandGA
+processes given the segment name in Options.SharedMemory migrate through it as well, and can be
+mixed with Matlab processes using this function.
+
+The function is called with a command as first input:
+* ShmMigration('create', Name, Islands, Capacity, n) creates the segment '/Name' for 'Islands'
+islands, with room for 'Capacity' migrants of 'n' genes in each ring buffer.
+* ShmMigration('unlink', Name) removes the segment once all islands are done.
+* Sent = ShmMigration('send', Name, Island, Destination, Emigrants, Fitness) sends the rows of the
+[e x n] boolean matrix 'Emigrants' and their [e x 1] 'Fitness' from island 'Island' to island
+'Destination' (both 1-based), and returns the number of migrants that fitted in the ring buffer.
+* [Immigrants, Fitness] = ShmMigration('receive', Name, Island) returns all migrants that have
+arrived at island 'Island' from any other island, as a boolean matrix and a fitness vector.
+
+The last segment used is kept mapped between calls and unmapped when the MEX function is cleared.
+The mapping is only reused while the name still refers to the same segment, so a segment that is
+unlinked and created again under the same name, also from another session, is mapped anew.
+
+Example on how to compile and run from Matlab (Linux or macOS only):
+% Compile .C to .mexa64
+>> mex LDFLAGS="$LDFLAGS -lrt" ShmMigration.c
+
+% In the coordinating session, before starting the island sessions:
+>> ShmMigration( 'create', 'ga_run1', 8, 16, 256 );
+
+% In the session of island 3, every K generations:
+>> [ Emigrants, EmigrantFitness ] = TournamentSelection( 2, Fitness, Population, 4, 0 );
+>> ShmMigration( 'send', 'ga_run1', 3, 4, Emigrants, EmigrantFitness );
+>> [ Immigrants, ImmigrantFitness ] = ShmMigration( 'receive', 'ga_run1', 3 );
+
+% In the coordinating session, when all islands have finished:
+>> ShmMigration( 'unlink', 'ga_run1' );
+
+Example of compatible C compilers:
+* GCC 4.9 or later
+* Clang 3.5 or later
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <string.h> // Needed for memcpy, memset and strcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>    // Needed for the O_* flags of shm_open.
+#include <sys/mman.h> // Needed for shm_open and mmap.
+#include <sys/stat.h> // Needed for fstat.
+#include <unistd.h>   // Needed for ftruncate and close.
+#define SHM_SUPPORTED
+#endif
+
+/* ——————————————————————————————————— Shared memory layout ———————————————————————————————————— */
+/* The segment starts with a header, followed by Islands x Islands queues where the queue from	 */
+/* island s to island d is number d*Islands + s. Each queue is a header with the indices on		 */
+/* separate cache lines, followed by its fitness and packed chromosome slots.					 */
+#define SHM_MAGIC 0x3130304D48534147ULL  // "GASHM001"
+
+typedef struct {
+	uint64_t Magic;
+	uint64_t Islands, Capacity, Genes, Words, QueueBytes;
+	uint64_t Pad[2];
+} ShmHeader;
+
+typedef struct {
+	volatile uint64_t Head;     // Next slot to read, only written by the consumer.
+	char PadHead[64 - sizeof(uint64_t)];
+	volatile uint64_t Tail;     // Next slot to write, only written by the producer.
+	char PadTail[64 - sizeof(uint64_t)];
+	uint64_t Capacity;
+	char PadCapacity[64 - sizeof(uint64_t)];
+} MigrationQueue;               // Followed by double Fitness[Capacity], uint64_t Genomes[Capacity x Words].
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+ShmHeader *MapSegment(const char *Name);
+
+void UnmapSegment(void);
+
+MigrationQueue *GetQueue(ShmHeader *Shm, size_t Destination, size_t Source);
+
+bool QueuePush(MigrationQueue *Q, const uint64_t *Genome, double Fitness, size_t Words);
+
+bool QueuePop(MigrationQueue *Q, uint64_t *Genome, double *Fitness, size_t Words);
+
+/* ———————————————————————————————— Mapping kept between calls ————————————————————————————————— */
+static char MappedName[256];
+static ShmHeader *Mapped;
+static size_t MappedBytes;
+#ifdef SHM_SUPPORTED
+static dev_t MappedDevice;
+static ino_t MappedInode;
+#endif
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+#ifndef SHM_SUPPORTED
+	mexErrMsgIdAndTxt("MATLAB:ShmMigration:unsupported", "Error: Shared memory migration requires a POSIX system!");
+#else
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	char Command[16], Name[256];
+	ShmHeader *Shm, Header;
+	MigrationQueue *Q;
+	uint64_t *Genome;
+	const bool *Emigrants;
+	const double *Fitness;
+	bool *Immigrants;
+	double *ImmigrantFitness;
+	size_t Island, Destination, Source, Count, Arrived, row, gene, q, Bytes;
+	int fd;
+
+	mexAtExit(UnmapSegment);
+
+	/* ——————————————————————————— Get the command and segment name ———————————————————————————— */
+	if (nrhs < 2 || mxGetString(prhs[0], Command, sizeof(Command)) != 0 || mxGetString(prhs[1], Name + 1, sizeof(Name) - 1) != 0) {
+		mexErrMsgIdAndTxt("MATLAB:ShmMigration:invalidinputs", "Error: Inputs 1 and 2 must be a command and a segment name!");
+	}
+	Name[0] = '/';
+
+	/* ——————————————————————————————————— Create a segment ———————————————————————————————————— */
+	if (strcmp(Command, "create") == 0) {
+		if (nrhs < 5) {
+			mexErrMsgIdAndTxt("MATLAB:ShmMigration:invalidinputs", "Error: 'create' needs Islands, Capacity and n!");
+		}
+		memset(&Header, 0, sizeof(Header));
+		Header.Magic      = SHM_MAGIC;
+		Header.Islands    = (uint64_t)mxGetScalar(prhs[2]);
+		Header.Capacity   = (uint64_t)mxGetScalar(prhs[3]);
+		Header.Genes      = (uint64_t)mxGetScalar(prhs[4]);
+		Header.Words      = (Header.Genes + 63) / 64;
+		Header.QueueBytes = (sizeof(MigrationQueue) + sizeof(double) * Header.Capacity + sizeof(uint64_t) * Header.Capacity * Header.Words + 63) / 64 * 64;
+		if (Header.Islands < 1 || Header.Capacity < 1 || Header.Genes < 1) {
+			mexErrMsgIdAndTxt("MATLAB:ShmMigration:invalidinputs", "Error: Islands, Capacity and n must be positive!");
+		}
+		Bytes = sizeof(ShmHeader) + Header.Islands * Header.Islands * Header.QueueBytes;
+
+		fd = shm_open(Name, O_CREAT | O_EXCL | O_RDWR, 0600);
+		if (fd < 0) {
+			mexErrMsgIdAndTxt("MATLAB:ShmMigration:shmopen", "Error: Could not create shared memory segment '%s' (does it already exist?)!", Name);
+		}
+		if (ftruncate(fd, (off_t)Bytes) != 0 || (Shm = (ShmHeader*)mmap(NULL, Bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+			close(fd);
+			shm_unlink(Name);
+			mexErrMsgIdAndTxt("MATLAB:ShmMigration:shmopen", "Error: Could not size or map shared memory segment '%s'!", Name);
+		}
+		close(fd);
+
+		/* The segment is zero-filled, so only the capacities have to be set. The magic number	 */
+		/* is written last, so that a segment is never used before it is fully initialised.		 */
+		memcpy(Shm, &Header, sizeof(Header));
+		Shm->Magic = 0;
+		for (q = 0; q < Header.Islands * Header.Islands; q++) {
+			GetQueue(Shm, q / Header.Islands, q % Header.Islands)->Capacity = Header.Capacity;
+		}
+		__atomic_store_n(&Shm->Magic, SHM_MAGIC, __ATOMIC_RELEASE);
+		munmap(Shm, Bytes);
+		return;
+	}
+
+	/* ——————————————————————————————————— Remove a segment ———————————————————————————————————— */
+	if (strcmp(Command, "unlink") == 0) {
+		if (Mapped != NULL && strcmp(Name, MappedName) == 0) {
+			UnmapSegment();
+		}
+		shm_unlink(Name);
+		return;
+	}
+
+	/* ——————————————————————————————— Send and receive migrants ——————————————————————————————— */
+	Shm = MapSegment(Name);
+	Island = nrhs > 2 ? (size_t)mxGetScalar(prhs[2]) : 0;
+	if (Island < 1 || Island > Shm->Islands) {
+		mexErrMsgIdAndTxt("MATLAB:ShmMigration:invalidinputs", "Error: Island must be between 1 and %d!", (int)Shm->Islands);
+	}
+	Island--;
+
+	if (strcmp(Command, "send") == 0) {
+		if (nrhs < 6 || !mxIsLogical(prhs[4]) || mxGetN(prhs[4]) != Shm->Genes || mxGetNumberOfElements(prhs[5]) != mxGetM(prhs[4])) {
+			mexErrMsgIdAndTxt("MATLAB:ShmMigration:invalidinputs", "Error: 'send' needs a Destination, a [e x n] logical Emigrants matrix and [e x 1] Fitness!");
+		}
+		Destination = (size_t)mxGetScalar(prhs[3]);
+		if (Destination < 1 || Destination > Shm->Islands) {
+			mexErrMsgIdAndTxt("MATLAB:ShmMigration:invalidinputs", "Error: Destination must be between 1 and %d!", (int)Shm->Islands);
+		}
+		Emigrants = mxGetLogicals(prhs[4]);
+		Fitness   = mxGetPr(prhs[5]);
+		Count     = mxGetM(prhs[4]);
+		Q         = GetQueue(Shm, Destination - 1, Island);
+
+		/* Pack each emigrant directly from the column-major matrix.							 */
+		Genome = (uint64_t*)malloc(sizeof(uint64_t) * Shm->Words);
+		for (row = 0; row < Count; row++) {
+			memset(Genome, 0, sizeof(uint64_t) * Shm->Words);
+			for (gene = 0; gene < Shm->Genes; gene++) {
+				Genome[gene / 64] |= (uint64_t)(Emigrants[row + Count * gene] != 0) << (gene % 64);
+			}
+			if (!QueuePush(Q, Genome, Fitness[row], Shm->Words)) {
+				break;
+			}
+		}
+		free(Genome);
+		plhs[0] = mxCreateDoubleScalar((double)row);
+	}
+	else if (strcmp(Command, "receive") == 0) {
+		/* Count what has arrived first, so the outputs can be created with the right size.		 */
+		Count = 0;
+		for (Source = 0; Source < Shm->Islands; Source++) {
+			Q = GetQueue(Shm, Island, Source);
+			Count += (size_t)(__atomic_load_n(&Q->Tail, __ATOMIC_ACQUIRE) - Q->Head);
+		}
+
+		plhs[0] = mxCreateLogicalMatrix(Count, Shm->Genes);
+		Immigrants = mxGetLogicals(plhs[0]);
+		plhs[1] = mxCreateDoubleMatrix(Count, 1, mxREAL);
+		ImmigrantFitness = mxGetPr(plhs[1]);
+
+		/* Pop at most the counted migrants, as more may arrive while unpacking.				 */
+		Genome = (uint64_t*)malloc(sizeof(uint64_t) * Shm->Words);
+		Arrived = 0;
+		for (Source = 0; Source < Shm->Islands; Source++) {
+			Q = GetQueue(Shm, Island, Source);
+			while (Arrived < Count && QueuePop(Q, Genome, &ImmigrantFitness[Arrived], Shm->Words)) {
+				for (gene = 0; gene < Shm->Genes; gene++) {
+					Immigrants[Arrived + Count * gene] = (Genome[gene / 64] >> (gene % 64)) & 1;
+				}
+				Arrived++;
+			}
+		}
+		free(Genome);
+	}
+	else {
+		mexErrMsgIdAndTxt("MATLAB:ShmMigration:invalidinputs", "Error: Unknown command '%s'!", Command);
+	}
+#endif
+}
+
+#ifdef SHM_SUPPORTED
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for mapping an existing segment, reusing the mapping of the previous call if the	 */
+/* name still refers to the same segment, i.e. it has not been unlinked and created again.		 */
+ShmHeader *MapSegment(const char *Name){
+
+	struct stat Info;
+	ShmHeader *Shm;
+	int fd;
+
+	fd = shm_open(Name, O_RDWR, 0600);
+	if (fd < 0) {
+		UnmapSegment();
+		mexErrMsgIdAndTxt("MATLAB:ShmMigration:shmopen", "Error: Shared memory segment '%s' does not exist!", Name);
+	}
+	if (fstat(fd, &Info) != 0) {
+		close(fd);
+		mexErrMsgIdAndTxt("MATLAB:ShmMigration:shmopen", "Error: Could not map shared memory segment '%s'!", Name);
+	}
+	if (Mapped != NULL && strcmp(Name, MappedName) == 0 && Info.st_dev == MappedDevice &&
+	    Info.st_ino == MappedInode && (size_t)Info.st_size == MappedBytes) {
+		close(fd);
+		return Mapped;
+	}
+	UnmapSegment();
+
+	if ((size_t)Info.st_size < sizeof(ShmHeader) ||
+	    (Shm = (ShmHeader*)mmap(NULL, (size_t)Info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		close(fd);
+		mexErrMsgIdAndTxt("MATLAB:ShmMigration:shmopen", "Error: Could not map shared memory segment '%s'!", Name);
+	}
+	close(fd);
+
+	if (__atomic_load_n(&Shm->Magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+	    sizeof(ShmHeader) + Shm->Islands * Shm->Islands * Shm->QueueBytes > (size_t)Info.st_size) {
+		munmap(Shm, (size_t)Info.st_size);
+		mexErrMsgIdAndTxt("MATLAB:ShmMigration:shmopen", "Error: '%s' is not an initialised migration segment!", Name);
+	}
+
+	Mapped = Shm;
+	MappedBytes = (size_t)Info.st_size;
+	MappedDevice = Info.st_dev;
+	MappedInode = Info.st_ino;
+	strcpy(MappedName, Name);
+	return Shm;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for unmapping the segment kept between calls.										 */
+void UnmapSegment(void){
+	if (Mapped != NULL) {
+		munmap(Mapped, MappedBytes);
+		Mapped = NULL;
+		MappedName[0] = '\0';
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding the queue from island 'Source' to island 'Destination' (0-based).		 */
+MigrationQueue *GetQueue(ShmHeader *Shm, size_t Destination, size_t Source){
+	return (MigrationQueue*)((char*)Shm + sizeof(ShmHeader) + (Destination * Shm->Islands + Source) * Shm->QueueBytes);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for pushing a migrant onto a queue. Returns false if the queue is full.				 */
+bool QueuePush(MigrationQueue *Q, const uint64_t *Genome, double Fitness, size_t Words){
+
+	uint64_t Tail = Q->Tail, Slot;
+	double *SlotFitness = (double*)(Q + 1);
+	uint64_t *SlotGenomes = (uint64_t*)(SlotFitness + Q->Capacity);
+
+	if (Tail - __atomic_load_n(&Q->Head, __ATOMIC_ACQUIRE) >= Q->Capacity) {
+		return false;
+	}
+	Slot = Tail % Q->Capacity;
+	memcpy(SlotGenomes + Slot * Words, Genome, sizeof(uint64_t) * Words);
+	SlotFitness[Slot] = Fitness;
+	__atomic_store_n(&Q->Tail, Tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for popping a migrant from a queue. Returns false if the queue is empty.			 */
+bool QueuePop(MigrationQueue *Q, uint64_t *Genome, double *Fitness, size_t Words){
+
+	uint64_t Head = Q->Head, Slot;
+	double *SlotFitness = (double*)(Q + 1);
+	uint64_t *SlotGenomes = (uint64_t*)(SlotFitness + Q->Capacity);
+
+	if (Head == __atomic_load_n(&Q->Tail, __ATOMIC_ACQUIRE)) {
+		return false;
+	}
+	Slot = Head % Q->Capacity;
+	memcpy(Genome, SlotGenomes + Slot * Words, sizeof(uint64_t) * Words);
+	*Fitness = SlotFitness[Slot];
+	__atomic_store_n(&Q->Head, Head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+#endif
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
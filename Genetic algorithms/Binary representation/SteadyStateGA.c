@@ -0,0 +1,446 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Steady-state genetic algorithm.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which keeps a population in memory between calls and evolves it a few
+offspring at a time, rather than one whole generation at a time. This suits expensive fitness
+functions: every evaluated child competes with the population immediately, and no evaluations are
+spent on a full generation of children of which most are thrown away.
+
+A steady-state step consists of:
+* 'breed': tournament selection with 'k' contenders, N-point crossover and bitflip mutation with
+probability 'Pm', as in TournamentSelection, NpointCrossover and BitflipMutation, of a few
+offspring that are returned to Matlab for evaluation.
+* 'insert': the evaluated offspring replace the worst individuals of the population, if they are
+at least as good as them.
+
+The population is stored packed into 64-bit words (gene j in bit j%64 of word j/64) together with
+a binary min-heap on fitness, so the worst individual is always at the root of the heap and
+replacing it costs O(log m) rather than a scan of the whole population. Tournament selection only
+looks at its k contenders, and the best individual is tracked as offspring are inserted, since
+worst-replacement can never remove it. The population is freed by 'clear', by
+"clear SteadyStateGA" or when Matlab exits.
+
+The function is called with a command as first input:
+* SteadyStateGA('init', Population, Fitness, Seed) stores an initial population and its fitness.
+Seed is optional and seeds the random number generator (default from the clock).
+* Offspring = SteadyStateGA('breed', NoOffspring, k, N, Pm) creates NoOffspring new individuals.
+* Replaced = SteadyStateGA('insert', Offspring, Fitness) inserts evaluated offspring.
+* [Population, Fitness, BestRow] = SteadyStateGA('get') returns the current population.
+* SteadyStateGA('clear') frees the population.
+
+The inputs are:
+* Population: a [m x n] boolean matrix containing the initial population, one individual per row.
+* Fitness: a [m x 1] vector containing the fitness of each individual, to be maximised.
+* NoOffspring: a [1 x 1] scalar specifying the number of offspring to create.
+* k: a [1 x 1] scalar specifying the number of contenders per tournament, k <= m.
+* N: a [1 x 1] scalar specifying the number of crossover points, between 1 and n-1.
+* Pm: a [1 x 1] scalar specifying the mutation probability per gene.
+* Offspring: a [NoOffspring x n] boolean matrix containing evaluated offspring.
+
+The outputs are:
+* Offspring: a [NoOffspring x n] boolean matrix containing the new, unevaluated individuals.
+* Replaced: a [NoOffspring x 1] vector with the row each offspring replaced, 0 if it was rejected.
+* Population, Fitness: the current population and the fitness of each of its individuals.
+* BestRow: a [1 x 1] scalar with the row of the best individual in the population.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex SteadyStateGA.c
+
+% Run from Matlab when compiled:
+>> Population = logical(randi([0 1], 100, 64));
+>> SteadyStateGA( 'init', Population, MyFitnessFunction(Population) );
+>> for Step = 1:1000
+>>     Offspring = SteadyStateGA( 'breed', 2, 3, 2, 1/64 );
+>>     SteadyStateGA( 'insert', Offspring, MyFitnessFunction(Offspring) );
+>> end
+>> [ Population, Fitness, BestRow ] = SteadyStateGA( 'get' );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used as default seed.
+#include <math.h>   // Needed for log() and log1p() in the skip sampling of the mutation.
+#include <string.h> // Needed for memcpy and strcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed);
+
+void UnpackRows(const uint64_t *Packed, size_t m, size_t n, size_t Words, bool *Population);
+
+int Tournament(int k);
+
+void Crossover(int N, const uint64_t *P1, const uint64_t *P2, uint64_t *C1, uint64_t *C2);
+
+void Mutate(double Pm, uint64_t *Genome);
+
+void HeapSiftDown(size_t Position);
+
+void StateFree(void);
+
+uint64_t RngNext(uint64_t *s);
+
+void RngSeed(uint64_t *s, uint64_t Seed);
+
+unsigned int RandBelow(uint64_t *s, unsigned int Range);
+
+double RandUnit(uint64_t *s);
+
+/* ———————————————————————————— Population state kept between calls ———————————————————————————— */
+static uint64_t *Genomes;       // [m x Words] packed individuals of the population.
+static double *Fitness;         // [m x 1] fitness of each individual.
+static size_t *Heap;            // [m x 1] rows ordered as a min-heap on fitness.
+static int *ContenderList;      // [m x 1] scratch for the tournament contenders.
+static int *CrossOverPoints;    // [n x 1] scratch for the crossover points.
+static size_t PopSize, Genes, Words, BestRow;
+static uint64_t Rng[4];
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	char Command[16];
+	const bool *Population;
+	const double *InputFitness;
+
+	double *ReplacedOut, *FitnessOut, Pm;
+	uint64_t *Packed;
+	size_t m, n, row, Worst, Position, NoOffspring;
+	int k, N, P1, P2;
+
+	mexAtExit(StateFree);
+
+	/* ————————————————————————— Get pointers from the input variables ————————————————————————— */
+	if (nrhs < 1 || mxGetString(prhs[0], Command, sizeof(Command)) != 0) {
+		mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: First input must be 'init', 'breed', 'insert', 'get' or 'clear'!");
+	}
+	if (strcmp(Command, "clear") == 0) {
+		StateFree();
+		return;
+	}
+	if (strcmp(Command, "init") != 0 && Genomes == NULL) {
+		mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: No population, call SteadyStateGA('init', Population, Fitness) first!");
+	}
+
+	/* ————————————————————————————— Store the initial population —————————————————————————————— */
+	if (strcmp(Command, "init") == 0) {
+		if (nrhs < 3 || !mxIsLogical(prhs[1]) || mxGetNumberOfElements(prhs[2]) != mxGetM(prhs[1])) {
+			mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: Population must be a logical matrix with one element of Fitness per row!");
+		}
+		Population   = mxGetLogicals(prhs[1]);    // Input 2 (Population)
+		InputFitness = mxGetPr(prhs[2]);          // Input 3 (Fitness)
+		m = mxGetM(prhs[1]);                      // Number of rows in Population.
+		n = mxGetN(prhs[1]);                      // Number of columns in Population.
+		if (m < 2 || n < 2) {
+			mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: Population must have at least 2 rows and 2 columns!");
+		}
+
+		StateFree();
+		PopSize = m;
+		Genes   = n;
+		Words   = (n + 63) / 64;
+		Genomes         = (uint64_t*)malloc(sizeof(uint64_t) * m * Words);
+		Fitness         = (double*)malloc(sizeof(double) * m);
+		Heap            = (size_t*)malloc(sizeof(size_t) * m);
+		ContenderList   = (int*)malloc(sizeof(int) * m);
+		CrossOverPoints = (int*)malloc(sizeof(int) * n);
+
+		PackRows(Population, m, n, Words, Genomes);
+		memcpy(Fitness, InputFitness, sizeof(double) * m);
+		RngSeed(Rng, (uint64_t)(nrhs > 3 ? mxGetScalar(prhs[3]) : (double)clock()));
+
+		/* Build the heap bottom-up in O(m), and find the best individual.						 */
+		BestRow = 0;
+		for (row = 0; row < m; row++) {
+			Heap[row] = row;
+			if (Fitness[row] > Fitness[BestRow]) {
+				BestRow = row;
+			}
+		}
+		for (Position = m / 2; Position-- > 0;) {
+			HeapSiftDown(Position);
+		}
+	}
+
+	/* ———————————————————————————————— Breed new offspring ———————————————————————————————————— */
+	else if (strcmp(Command, "breed") == 0) {
+		if (nrhs < 5) {
+			mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: 'breed' takes NoOffspring, k, N and Pm as inputs!");
+		}
+		NoOffspring = (size_t)mxGetScalar(prhs[1]);   // Input 2 (NoOffspring)
+		k           = (int)mxGetScalar(prhs[2]);      // Input 3 (k)
+		N           = (int)mxGetScalar(prhs[3]);      // Input 4 (N)
+		Pm          = mxGetScalar(prhs[4]);           // Input 5 (Pm)
+		if (k < 1 || k > (int)PopSize) {
+			mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: k must be between 1 and the population size!");
+		}
+		if (N < 1 || N > (int)Genes - 1) {
+			mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: Crossover points (N) must be between 1 and n-1!");
+		}
+
+		/* Children are made in pairs, with room for one extra child if NoOffspring is odd.		 */
+		Packed = (uint64_t*)malloc(sizeof(uint64_t) * (NoOffspring + 1) * Words);
+		for (row = 0; row < NoOffspring; row += 2) {
+			P1 = Tournament(k);
+			P2 = Tournament(k);
+			Crossover(N, Genomes + P1 * Words, Genomes + P2 * Words, Packed + row * Words, Packed + (row + 1) * Words);
+		}
+		for (row = 0; row < NoOffspring; row++) {
+			Mutate(Pm, Packed + row * Words);
+		}
+
+		plhs[0] = mxCreateLogicalMatrix(NoOffspring, Genes);
+		UnpackRows(Packed, NoOffspring, Genes, Words, mxGetLogicals(plhs[0]));
+		free(Packed);
+	}
+
+	/* ———————————————————————— Replace the worst by evaluated offspring ——————————————————————— */
+	else if (strcmp(Command, "insert") == 0) {
+		if (nrhs < 3 || !mxIsLogical(prhs[1]) || mxGetN(prhs[1]) != Genes || mxGetNumberOfElements(prhs[2]) != mxGetM(prhs[1])) {
+			mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: Offspring must be a logical matrix with n columns and one element of Fitness per row!");
+		}
+		Population   = mxGetLogicals(prhs[1]);    // Input 2 (Offspring)
+		InputFitness = mxGetPr(prhs[2]);          // Input 3 (Fitness)
+		m = mxGetM(prhs[1]);
+
+		plhs[0] = mxCreateDoubleMatrix(m, 1, mxREAL);
+		ReplacedOut = mxGetPr(plhs[0]);
+
+		Packed = (uint64_t*)malloc(sizeof(uint64_t) * m * Words);
+		PackRows(Population, m, Genes, Words, Packed);
+		for (row = 0; row < m; row++) {
+			Worst = Heap[0];
+			if (InputFitness[row] >= Fitness[Worst]) {
+				memcpy(Genomes + Worst * Words, Packed + row * Words, sizeof(uint64_t) * Words);
+				Fitness[Worst] = InputFitness[row];
+				HeapSiftDown(0);
+				if (Fitness[Worst] > Fitness[BestRow]) {
+					BestRow = Worst;
+				}
+				ReplacedOut[row] = (double)(Worst + 1);
+			}
+		}
+		free(Packed);
+	}
+
+	/* ————————————————————————————— Return the current population ————————————————————————————— */
+	else if (strcmp(Command, "get") == 0) {
+		plhs[0] = mxCreateLogicalMatrix(PopSize, Genes);
+		UnpackRows(Genomes, PopSize, Genes, Words, mxGetLogicals(plhs[0]));
+		plhs[1] = mxCreateDoubleMatrix(PopSize, 1, mxREAL);
+		FitnessOut = mxGetPr(plhs[1]);
+		memcpy(FitnessOut, Fitness, sizeof(double) * PopSize);
+		plhs[2] = mxCreateDoubleScalar((double)(BestRow + 1));
+	}
+	else {
+		mexErrMsgIdAndTxt("MATLAB:SteadyStateGA:invalidinputs", "Error: Unknown command '%s'!", Command);
+	}
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing the rows of a column-major boolean matrix into 64-bit words.			 */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed){
+	size_t row, gene;
+	memset(Packed, 0, sizeof(uint64_t) * m * Words);
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < m; row++) {
+			Packed[row * Words + gene / 64] |= (uint64_t)(Population[row + m * gene] != 0) << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for unpacking packed rows into a column-major boolean matrix.						 */
+void UnpackRows(const uint64_t *Packed, size_t m, size_t n, size_t Words, bool *Population){
+	size_t row, gene;
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < m; row++) {
+			Population[row + m * gene] = (Packed[row * Words + gene / 64] >> (gene % 64)) & 1;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for holding one tournament among k unique contenders. Returns the winning row.		 */
+int Tournament(int k){
+
+	int Contender, ContenderIndex, row, WinnerIndex;
+	bool AlreadyInTour;
+
+	Contender = 0;
+	WinnerIndex = 0;
+	while (Contender < k){
+		ContenderIndex = (int)RandBelow(Rng, (unsigned int)PopSize);
+		AlreadyInTour = false;
+		for (row = 0; row < Contender; row++) {
+			if (ContenderIndex == ContenderList[row]) {
+				AlreadyInTour = true;
+			}
+		}
+		if (AlreadyInTour == false) {
+			ContenderList[Contender] = ContenderIndex;
+			if (Contender == 0 || Fitness[ContenderIndex] > Fitness[WinnerIndex]) {
+				WinnerIndex = ContenderIndex;
+			}
+			Contender++;
+		}
+	}
+	return WinnerIndex;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for N-point crossover of two packed parents into two children. Segments alternate	 */
+/* between the parents at N unique crossover points, and the bits of every second segment are	 */
+/* swapped between the children word by word.													 */
+void Crossover(int N, const uint64_t *P1, const uint64_t *P2, uint64_t *C1, uint64_t *C2){
+
+	int i, j, CandidatePoint, Point;
+	size_t Start, End, word;
+	uint64_t Mask, Diff;
+	bool AlreadyChosen;
+
+	memcpy(C1, P1, sizeof(uint64_t) * Words);
+	memcpy(C2, P2, sizeof(uint64_t) * Words);
+
+	/* Pick N unique crossover points in 1..n-1, sorted by insertion.							 */
+	i = 0;
+	while (i < N) {
+		CandidatePoint = 1 + (int)RandBelow(Rng, (unsigned int)Genes - 1);
+		AlreadyChosen = false;
+		for (j = 0; j < i; j++) {
+			if (CandidatePoint == CrossOverPoints[j]) {
+				AlreadyChosen = true;
+			}
+		}
+		if (AlreadyChosen == false) {
+			for (j = i; j > 0 && CrossOverPoints[j - 1] > CandidatePoint; j--) {
+				CrossOverPoints[j] = CrossOverPoints[j - 1];
+			}
+			CrossOverPoints[j] = CandidatePoint;
+			i++;
+		}
+	}
+
+	/* Swap the genes of every second segment, [Point_1, Point_2), [Point_3, Point_4) etc.		 */
+	for (Point = 0; Point < N; Point += 2) {
+		Start = (size_t)CrossOverPoints[Point];
+		End   = Point + 1 < N ? (size_t)CrossOverPoints[Point + 1] : Genes;
+		for (word = Start / 64; word <= (End - 1) / 64; word++) {
+			Mask = ~(uint64_t)0;
+			if (word == Start / 64) {
+				Mask &= ~(uint64_t)0 << (Start % 64);
+			}
+			if (word == (End - 1) / 64 && End % 64 != 0) {
+				Mask &= ((uint64_t)1 << (End % 64)) - 1;
+			}
+			Diff = (C1[word] ^ C2[word]) & Mask;
+			C1[word] ^= Diff;
+			C2[word] ^= Diff;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for bitflip mutation of a packed chromosome using skip sampling: the number of		 */
+/* genes skipped before the next flip is geometrically distributed with parameter Pm. log1p		 */
+/* keeps log(1 - Pm) accurate for tiny Pm, where 1 - Pm rounds to 1, and the skip is clamped	 */
+/* to the chromosome length before it is cast, as it is huge or infinite for such Pm.			 */
+void Mutate(double Pm, uint64_t *Genome){
+
+	size_t gene;
+	double LogQ, Skip;
+
+	if (Pm <= 0) {
+		return;
+	}
+	if (Pm >= 1) {
+		for (gene = 0; gene < Genes; gene++) {
+			Genome[gene / 64] ^= (uint64_t)1 << (gene % 64);
+		}
+		return;
+	}
+
+	LogQ = log1p(-Pm);
+	Skip = floor(log(RandUnit(Rng)) / LogQ);
+	gene = Skip < (double)Genes ? (size_t)Skip : Genes;
+	while (gene < Genes) {
+		Genome[gene / 64] ^= (uint64_t)1 << (gene % 64);
+		Skip = floor(log(RandUnit(Rng)) / LogQ);
+		gene += 1 + (Skip < (double)Genes ? (size_t)Skip : Genes);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for restoring the min-heap below a position whose fitness has increased.			 */
+void HeapSiftDown(size_t Position){
+
+	size_t Child, Row = Heap[Position];
+
+	while ((Child = 2 * Position + 1) < PopSize) {
+		if (Child + 1 < PopSize && Fitness[Heap[Child + 1]] < Fitness[Heap[Child]]) {
+			Child++;
+		}
+		if (Fitness[Heap[Child]] >= Fitness[Row]) {
+			break;
+		}
+		Heap[Position] = Heap[Child];
+		Position = Child;
+	}
+	Heap[Position] = Row;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for freeing the population, also registered with mexAtExit.							 */
+void StateFree(void){
+	free(Genomes);
+	free(Fitness);
+	free(Heap);
+	free(ContenderList);
+	free(CrossOverPoints);
+	Genomes = NULL;
+	Fitness = NULL;
+	Heap = NULL;
+	ContenderList = NULL;
+	CrossOverPoints = NULL;
+	PopSize = 0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Random number generator (xoshiro256**), kept between calls so that consecutive 'breed' calls	 */
+/* continue the same stream. Seeded through splitmix64.											 */
+uint64_t RngNext(uint64_t *s){
+	uint64_t Result = s[1] * 5;
+	uint64_t t = s[1] << 17;
+	Result = ((Result << 7) | (Result >> 57)) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return Result;
+}
+
+void RngSeed(uint64_t *s, uint64_t Seed){
+	int i;
+	uint64_t z;
+	for (i = 0; i < 4; i++) {
+		Seed += 0x9E3779B97F4A7C15ULL;
+		z = Seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s[i] = z ^ (z >> 31);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer in the range 0 to Range-1.								 */
+unsigned int RandBelow(uint64_t *s, unsigned int Range){
+	return (unsigned int)(((RngNext(s) >> 32) * Range) >> 32);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random number in the range (0,1].										 */
+double RandUnit(uint64_t *s){
+	return ((RngNext(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,232 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Batched bitflip mutation operator.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which performs bitflip mutation, as in BitflipMutation, on R independent
+runs of a genetic algorithm in one call. The populations of the runs are stacked along the third
+dimension, and the runs are handed out dynamically to the threads of an OpenMP team (compile with
+OpenMP enabled, see below). Many small replicates, e.g. for tuning the parameters of the
+algorithm, then pay the call overhead of Matlab once per generation instead of once per run, and
+fill all cores even when each run has only a few hundred individuals.
+
+Every gene of the rows after the first ElitismNo of a run is flipped with the probability Pm of the
+run. The genes are visited by skip sampling: the number of genes skipped before the next flip is
+geometrically distributed with parameter Pm, so the random numbers drawn scale with the number of
+flips rather than with m*n. Each run draws its random numbers from a generator of its own
+(xoshiro256**), seeded through splitmix64 from Seed and the run r = 0..R-1, so the mutations of a
+run depend only on Seed and r and not on the number of threads or on the other runs. See
+BatchTournamentSelection for how to pick the seeds of a loop.
+
+The function takes 4 inputs:
+* Input 1: a [m x n x R] boolean array 'Population' containing the populations of the R runs. A
+[m x n] matrix is a single run.
+* Input 2: a [1 x 1] scalar, or a vector with one element per run, 'Pm' specifying the mutation
+probability of each gene.
+* Input 3: a [1 x 1] scalar, or a vector with one element per run, 'ElitismNo' specifying how many
+rows, starting from the top, should be excluded from mutation due to elitism.
+* Input 4: (optional) a [1 x 1] scalar 'Seed' of the random number generators of the runs.
+Defaults to the number of clock cycles since start.
+
+The function outputs 1 variable:
+* Output 1: a [m x n x R] array 'MutatedPopulation' containing the mutated populations.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64 with OpenMP enabled
+>> mex COMPFLAGS="$COMPFLAGS /openmp" BatchBitflipMutation.c
+>> mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" BatchBitflipMutation.c
+
+% Run from Matlab when compiled, here 100 runs with Pm from 0.5/n to 2/n:
+>> R = 100;
+>> Population = logical(randi([0 1], 200, 256, R));
+>> Pm = linspace(0.5, 2, R) / 256;
+
+>> [ MutatedPopulation ] = BatchBitflipMutation( Population, Pm, 2, 201 );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-17 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used as default seed.
+#include <math.h>   // Needed for log() and log1p() in the skip sampling.
+#include <string.h> // Needed for memcpy.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#include <stddef.h> // Needed for ptrdiff_t.
+
+/* Typed data access of the R2018a API when compiled with mex -R2018a, else the legacy API.		 */
+#if MX_HAS_INTERLEAVED_COMPLEX
+#define GetDoubles(Array) mxGetDoubles(Array)
+#else
+#define GetDoubles(Array) mxGetPr(Array)
+#endif
+
+/* New outputs are not zero-filled, except under Octave where older versions lack the function.	 */
+#ifdef HAVE_OCTAVE
+#define CreateUninitArray(ndim, dims, Class) mxCreateNumericArray(ndim, dims, Class, mxREAL)
+#else
+#define CreateUninitArray(ndim, dims, Class) mxCreateUninitNumericArray(ndim, dims, Class, mxREAL)
+#endif
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void BatchBitflip(const bool *Population, size_t m, size_t n, size_t R, const double *Pm, size_t PmStride, const double *ElitismNo, size_t EliteStride, uint64_t Seed, bool *MutatedPopulation);
+
+void BitflipRun(bool *MutatedPopulation, size_t m, size_t n, double Pm, size_t ElitismNo, uint64_t *Rng);
+
+size_t RunStride(const mxArray *Array, size_t R, const char *Message);
+
+uint64_t RngNext(uint64_t *s);
+
+void RngSeed(uint64_t *s, uint64_t Seed);
+
+uint64_t RunSeed(uint64_t Seed, uint64_t Run);
+
+double RandUnit(uint64_t *s);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const bool *Population;
+	const double *Pm, *ElitismNo;
+	const mwSize *Dims;
+	uint64_t Seed;
+
+	bool *MutatedPopulation;
+
+	size_t m, n, R, run, PmStride, EliteStride;
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 3 || !mxIsLogical(prhs[0]) || mxGetNumberOfDimensions(prhs[0]) > 3) {
+		mexErrMsgIdAndTxt("MATLAB:BatchBitflipMutation:invalidinputs", "Error: Inputs must be a logical [m x n x R] Population, Pm and ElitismNo!");
+	}
+	Population = mxGetLogicals(prhs[0]);      // Input 1 (Population)
+	Seed       = nrhs > 3 ? (uint64_t)mxGetScalar(prhs[3]) : (uint64_t)clock(); // Input 4 (Seed)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	Dims = mxGetDimensions(prhs[0]);
+	m = Dims[0];                              // Number of rows in each population.
+	n = Dims[1];                              // Number of columns in each population.
+	R = mxGetNumberOfDimensions(prhs[0]) > 2 ? Dims[2] : 1; // Number of runs.
+
+	PmStride    = RunStride(prhs[1], R, "Error: Pm must be a real double scalar or a vector with one element per run!");
+	EliteStride = RunStride(prhs[2], R, "Error: ElitismNo must be a real double scalar or a vector with one element per run!");
+	Pm          = GetDoubles(prhs[1]);        // Input 2 (Pm)
+	ElitismNo   = GetDoubles(prhs[2]);        // Input 3 (Elitism rows)
+
+	/* The checks are made for every run before any of them starts, as the runs cannot stop the	 */
+	/* call with an error once they are spread over the threads.								 */
+	for (run = 0; run < R; run++) {
+		if (!(ElitismNo[run * EliteStride] >= 0)) {
+			mexErrMsgIdAndTxt("MATLAB:BatchBitflipMutation:invalidinputs", "Error: ElitismNo must not be negative, in any run!");
+		}
+	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	plhs[0] = CreateUninitArray(mxGetNumberOfDimensions(prhs[0]), Dims, mxLOGICAL_CLASS);
+	MutatedPopulation = mxGetLogicals(plhs[0]);
+
+	/* ——————————————————————————————————— Bitflip Mutation ———————————————————————————————————— */
+	BatchBitflip(Population, m, n, R, Pm, PmStride, ElitismNo, EliteStride, Seed, MutatedPopulation);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for copying and mutating R runs stacked along the third dimension. The runs are		 */
+/* handed out one at a time to the OpenMP threads, each with a generator of its own, and the	 */
+/* thread that mutates a run also copies it, so that the run is in its cache.					 */
+void BatchBitflip(const bool *Population, size_t m, size_t n, size_t R, const double *Pm, size_t PmStride, const double *ElitismNo, size_t EliteStride, uint64_t Seed, bool *MutatedPopulation){
+
+	ptrdiff_t run;
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (run = 0; run < (ptrdiff_t)R; run++) {
+		uint64_t Rng[4];
+		RngSeed(Rng, RunSeed(Seed, (uint64_t)run));
+		memcpy(MutatedPopulation + run * m * n, Population + run * m * n, sizeof(bool) * m * n);
+		BitflipRun(MutatedPopulation + run * m * n, m, n, Pm[run * PmStride], (size_t)ElitismNo[run * EliteStride], Rng);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for flipping every gene of the rows after the first ElitismNo of one run with the	 */
+/* probability Pm. The non-elite genes are numbered column by column, as they lie in memory, and */
+/* the number of genes skipped before the next flip is geometrically distributed with parameter	 */
+/* Pm. A Pm of 1 or more flips every gene.														 */
+void BitflipRun(bool *MutatedPopulation, size_t m, size_t n, double Pm, size_t ElitismNo, uint64_t *Rng){
+
+	size_t Rows, Genes, gene;
+	double LogQ, Skip;
+
+	if (ElitismNo >= m || !(Pm > 0)) {
+		return;
+	}
+	Rows  = m - ElitismNo;
+	Genes = Rows * n;
+	LogQ  = Pm < 1 ? log1p(-Pm) : 0;
+
+	gene = 0;
+	for (;;) {
+		Skip = Pm < 1 ? floor(log(RandUnit(Rng)) / LogQ) : 0;
+		if (Skip >= (double)(Genes - gene)) {
+			break;
+		}
+		gene += (size_t)Skip;
+		MutatedPopulation[ElitismNo + gene % Rows + m * (gene / Rows)] ^= true;
+		gene++;
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking that a per-run parameter is a real double scalar, shared by all runs,	 */
+/* or a vector with one element per run. Returns the step between the elements of consecutive	 */
+/* runs.																						 */
+size_t RunStride(const mxArray *Array, size_t R, const char *Message){
+	if (!mxIsDouble(Array) || mxIsComplex(Array) || (mxGetNumberOfElements(Array) != 1 && mxGetNumberOfElements(Array) != R)) {
+		mexErrMsgIdAndTxt("MATLAB:BatchBitflipMutation:invalidinputs", Message);
+	}
+	return mxGetNumberOfElements(Array) == 1 ? 0 : 1;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Random number generator (xoshiro256**), one per run so that the runs do not share the state	 */
+/* of rand(). Seeded through splitmix64.														 */
+uint64_t RngNext(uint64_t *s){
+	uint64_t Result = s[1] * 5;
+	uint64_t t = s[1] << 17;
+	Result = ((Result << 7) | (Result >> 57)) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return Result;
+}
+
+void RngSeed(uint64_t *s, uint64_t Seed){
+	int i;
+	uint64_t z;
+	for (i = 0; i < 4; i++) {
+		Seed += 0x9E3779B97F4A7C15ULL;
+		z = Seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s[i] = z ^ (z >> 31);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for deriving the seed of a run. Seed is hashed with splitmix64, and the runs of the	 */
+/* call take consecutive blocks of 4 from the splitmix64 sequence after the hash, one per state	 */
+/* word, so the streams of two calls only meet if their hashed seeds happen to be close. Unlike	 */
+/* Seed + r, nearby seeds then give unrelated runs.												 */
+uint64_t RunSeed(uint64_t Seed, uint64_t Run){
+	uint64_t z = Seed;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (z ^ (z >> 31)) + Run * 4 * 0x9E3779B97F4A7C15ULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random number in the range (0,1].										 */
+double RandUnit(uint64_t *s){
+	return ((RngNext(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
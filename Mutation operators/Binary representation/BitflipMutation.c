@@ -13,19 +13,73 @@ original.
 For reference, see p. 52 A.  Eiben and J.  Smith, Introduction to evolutionary computing. 
 New York: Springer, 2003.
 
+Pm can be one rate for the whole population, one rate per individual or one rate per gene. With
+one rate for the population or per individual, the genes of each individual are mutated by skip
+sampling: the number of genes up to the next flipped gene is geometrically distributed, so it is
+drawn directly, and about n*Pm random numbers are drawn per individual instead of n. With one rate
+per gene, one random number is drawn per gene.
+
+The rates can also be adapted by the function before the mutation, and returned for the next call:
+* The 1/5th success rule scales all rates by a factor, up if more than a fifth of the recent
+mutations improved the individual and down if fewer did. The caller measures the success rate,
+e.g. as the fraction of mutated individuals that are fitter than before the mutation.
+* Log-normal self-adaptation gives every individual a rate of its own, which is mutated before the
+individual itself, as Pm' = 1 / (1 + (1 - Pm) / Pm * exp(-Tau * N(0,1))). Rates that produce fit
+individuals then survive along with them. The rates belong to the rows of the population, so they
+have to be reordered along with the individuals by the selection. For reference, see T. Bäck and
+M. Schütz, Intelligent mutation rate control in canonical genetic algorithms, ISMIS 1996.
+The adapted rates are kept between MinPm and MaxPm.
+
 The function takes 3 inputs:
 * Input 1: a [m x n] population matrix of logical values, with one individual per row.
-* Input 2: a [1 x 1] scalar 'Pm' specifying a mutation probability between 0 and 1.
+* Input 2: a [1 x 1] scalar 'Pm' specifying a mutation probability between 0 and 1, or a [m x 1]
+vector with the probability of each individual, or a [1 x n] vector with the probability of each
+gene.
 * Input 3: a [1 x 1] scalar 'ElitismNo' specifying how many individuals, starting from the top row
 should be excluded from the mutation process. If set to 0 all individuals are mutated. If set to 1
 the first chromosome of the population is skipped in the mutation process etc.
+* Input 4: (optional) a preallocated [m x n] logical matrix 'MutatedPopulation', into which the
+mutated population is written in place instead of into a new output. It may be the Population
+itself, which is then mutated in place. The function then only returns the optional outputs
+after MutatedPopulation. Give [] to get a new output when Input 5 is given.
+* Input 5: (optional) a struct 'Adaptation' to adapt Pm with, with the fields:
+	Scheme      - 'onefifth' for the 1/5th success rule or 'lognormal' for log-normal
+	              self-adaptation, see above.
+	SuccessRate - (onefifth) fraction of the recent mutations that were successful, between 0
+	              and 1.
+	Factor      - (onefifth) factor by which the rates are scaled down, or divided to scale them
+	              up (default 0.817).
+	Tau         - (lognormal) learning rate (default 0.22).
+	MinPm       - smallest adapted rate (default 0.1/n).
+	MaxPm       - largest adapted rate (default 0.5).
+With 'lognormal' Pm must have one rate per individual, or be a scalar which is then given to all
+individuals. The rates of the first ElitismNo individuals are not mutated.
 
-The function outputs 1 variable:
+The function outputs up to 3 variables:
 * Output 1: a [m x n] boolean matrix containing the mutated population.
+* Output 2: (only with Input 5) the adapted Pm that the population was mutated with, of the same
+size as Pm, or [m x 1] if a scalar Pm was adapted with 'lognormal'.
+* Output 2 or 3: (optional) a [F x 2] matrix 'Flips' with the individual and gene of each of the F
+flipped genes, sorted by individual and then by gene. It can be given to DeltaFitness to update
+the fitness of the mutated individuals from the flipped genes only, instead of evaluating them
+from scratch.
+* Last output: (only when compiled with GA_INSTRUMENT) a struct 'Counters' with the number of
+random numbers drawn with rand() (RngDraws), of genes flipped (Flips) and of bytes copied from the
+population into the output (BytesCopied), and the wall time in seconds of the copy (CopyTime), the
+mutation (MutationTime) and the sorting of the flip list (SortTime). It follows Flips.
+
+A new output is not zero-filled before the population is copied into it. Writing into a
+preallocated output saves the allocation as well, which is a noticeable part of the run time for
+small populations. The preallocated matrix must not share its data with another variable (e.g.
+after B = MutatedPopulation), as Matlab would not know that both are changed.
 
 Example on how to compile and run from Matlab:
 % Compile .C to .mexw64
 >> mex BitflipMutation.c
+% or with the typed data API of Matlab R2018a and later
+>> mex -R2018a BitflipMutation.c
+% or with the instrumentation counters
+>> mex -DGA_INSTRUMENT BitflipMutation.c
 
 % Run from Matlab when compiled:
 >> Population = logical(randi([0 1],10000, 256));
@@ -33,6 +87,27 @@ Example on how to compile and run from Matlab:
 >> ElitismNo = 3;
 
 >> [ MutatedPopulation ] = BitflipMutation( Population , Pm, ElitismNo );
+>> [ MutatedPopulation, Flips ] = BitflipMutation( Population , Pm, ElitismNo );
+
+% Or write into a preallocated output, e.g. once per generation:
+>> MutatedPopulation = false(size(Population));
+>> BitflipMutation( Population , Pm, ElitismNo, MutatedPopulation );
+
+% Or adapt Pm by the 1/5th success rule, with the success rate of the previous generation:
+>> [ MutatedPopulation, Pm ] = BitflipMutation( Population , Pm, ElitismNo, [], struct('Scheme', 'onefifth', 'SuccessRate', 0.1) );
+
+% Or by log-normal self-adaptation, with one rate per individual:
+>> Pm = repmat(1/256, 10000, 1);
+>> [ MutatedPopulation, Pm ] = BitflipMutation( Population , Pm, ElitismNo, [], struct('Scheme', 'lognormal') );
+
+Example on how to compile and run from GNU Octave:
+% Compile .C to .mex, or to a native .oct together with the Octave gateway BitflipMutation.cc,
+% which passes the Octave arrays to Bitflip without converting them to and from mxArrays
+>> mkoctfile --mex BitflipMutation.c
+>> mkoctfile -DGA_NO_MEX BitflipMutation.cc BitflipMutation.c
+
+% Run from Octave when compiled, exactly as from Matlab:
+>> [ MutatedPopulation, Flips ] = BitflipMutation( Population , Pm, ElitismNo );
 
 Example of compatible C compilers:
 * Microsoft Visual C++ 2013 Professional (C)
@@ -43,58 +118,463 @@ Written 2017-09-10 by
 petter.stefansson@nmbu.no
 ———————————————————————————————————————————————————————————————————————————————————————————————— */
 
+#ifndef GA_NO_MEX
 #include <mex.h>	// Needed to communicate with matlab.
+
+/* Typed data access of the R2018a API when compiled with mex -R2018a, else the legacy API.		 */
+#if MX_HAS_INTERLEAVED_COMPLEX
+#define GetDoubles(Array) mxGetDoubles(Array)
+#else
+#define GetDoubles(Array) mxGetPr(Array)
+#endif
+
+/* New outputs are not zero-filled, except under Octave where older versions lack the function.	 */
+#ifdef HAVE_OCTAVE
+#define CreateUninitMatrix(m, n, Class) mxCreateNumericMatrix(m, n, Class, mxREAL)
+#else
+#define CreateUninitMatrix(m, n, Class) mxCreateUninitNumericMatrix(m, n, Class, mxREAL)
+#endif
+#else
+#include <stdlib.h>  // Needed for rand, realloc and calloc when compiled for the native Octave gateway.
+#include <stdbool.h> // Needed for bool when compiled for the native Octave gateway.
+#endif
 #include <time.h>   // Needed for counting CPU clock cycle which is used to set seed for rand().
 #include <string.h> // Needed to avoid compiler warning due to memcpy when using old compilers.
+#include <math.h>   // Needed for log() and log1p() in the skip sampling and exp() in the self-adaptation.
+
+/* Layouts of Pm.																				 */
+#define PM_SCALAR 0         // [1 x 1], one rate for the whole population.
+#define PM_PER_INDIVIDUAL 1 // [m x 1], one rate per individual.
+#define PM_PER_GENE 2       // [1 x n], one rate per gene.
+
+/* Adaptation schemes of Pm, and the defaults of their parameters.								 */
+#define ADAPT_NONE 0
+#define ADAPT_ONE_FIFTH 1
+#define ADAPT_LOGNORMAL 2
+#define ONE_FIFTH_FACTOR 0.817
+#define LOGNORMAL_TAU 0.22
+
+/* ——————————————————————————————————————— Instrumentation ————————————————————————————————————— */
+/* When compiled with GA_INSTRUMENT defined the operator counts its random numbers, flips and	 */
+/* copied bytes, and times its phases in seconds of wall time. The counters of the last call	 */
+/* are kept in BitflipCounters, named by BitflipCounterNames. Without GA_INSTRUMENT the			 */
+/* counting compiles to nothing.																 */
+#ifdef GA_INSTRUMENT
+#include <stdio.h>  // Needed for snprintf.
+#include <string.h> // Needed for memset.
+#ifdef _WIN32
+#include <windows.h> // Needed for QueryPerformanceCounter.
+#endif
+enum { RNG_DRAWS, FLIPS, BYTES_COPIED, COPY_TIME, MUTATION_TIME, SORT_TIME, BITFLIP_NO_COUNTERS };
+const int BitflipNoCounters = BITFLIP_NO_COUNTERS;
+const char *BitflipCounterNames[BITFLIP_NO_COUNTERS] = { "RngDraws", "Flips", "BytesCopied", "CopyTime", "MutationTime", "SortTime" };
+double BitflipCounters[BITFLIP_NO_COUNTERS];
+#define COUNT(Counter, Amount) (BitflipCounters[Counter] += (double)(Amount))
+#define COUNTERS_OUTPUT 1
+#else
+#define COUNT(Counter, Amount) ((void)0)
+#define COUNTERS_OUTPUT 0
+#endif
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+size_t Bitflip(const bool *Population, bool *MutatedPopulation, size_t m, size_t n, const double *Pm, int PmLayout, int ElitismNo, int **FlipList);
+
+void FlipGene(bool *MutatedPopulation, size_t m, int individual, int gene, int **Flips, size_t *NoFlips, size_t *FlipCapacity);
+
+void SortFlips(const int *FlipList, size_t NoFlips, size_t m, double *FlipsOut);
+
+int PmLayoutOf(size_t Rows, size_t Cols, size_t m, size_t n);
+
+void AdaptPm(double *Pm, size_t NoRates, int Scheme, int ElitismNo, double SuccessRate, double Factor, double Tau, double MinPm, double MaxPm);
 
+double RandUnit(void);
+
+double RandNormal(void);
+
+#ifdef GA_INSTRUMENT
+double WallTime(void);
+
+int BitflipCountersJson(char *Buffer, size_t Size);
+
+#ifndef GA_NO_MEX
+mxArray *CountersStruct(void);
+#endif
+#endif
+
+#ifndef GA_NO_MEX
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n);
+
+double GetOption(const mxArray *Options, const char *Name, double Default);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
 
-	/* Before starting set the seed of the RNG to the number of clock cycles since start.        */
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.		 */
 	srand(clock());
+#ifdef GA_INSTRUMENT
+	memset(BitflipCounters, 0, sizeof(BitflipCounters));
+#endif
 
 	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
 	const bool *Population;
 	bool *MutatedPopulation;
-	const double *Pm;						   
+	const double *Pm;
+	double PmScalar, *AdaptedPm, SuccessRate, Factor, Tau, MinPm, MaxPm;
+	const mxArray *Adaptation;
+	mxArray *Field, *AdaptedPmArray;
+	char Scheme[16];
 	
-	int individual, gene, ElitismNo;
-	double RandNr;
-	size_t m, n;
+	int ElitismNo, PmLayout, AdaptScheme, Output, FlipsOutput;
+	size_t m, n, NoRates, i;
+
+	int *FlipList;
+	size_t NoFlips;
 
 	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
 	Population = mxGetLogicals(prhs[0]);      // Input 1 (Population)
-	Pm         = mxGetPr(prhs[1]);            // Input 2 (Pm)
 	ElitismNo  = (int)mxGetScalar(prhs[2]);   // Input 3 (Elitism rows)
 
     /* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
 	m = mxGetM(prhs[0]);                      // Number of rows in Population.
 	n = mxGetN(prhs[0]);                      // Number of columns in Population.
 
+	if (Population == NULL) {
+		mexErrMsgIdAndTxt("MATLAB:BitflipMutation:invalidinputs", "Error: Population must be a logical matrix!");
+	}
+
+	/* Pm is one rate for the population, one per individual or one per gene.					 */
+	PmLayout = PmLayoutOf(mxGetM(prhs[1]), mxGetN(prhs[1]), m, n);
+	if (PmLayout < 0 || (PmLayout != PM_SCALAR && (!mxIsDouble(prhs[1]) || mxIsComplex(prhs[1])))) {
+		mexErrMsgIdAndTxt("MATLAB:BitflipMutation:invalidinputs", "Error: Pm must be a scalar, a [m x 1] vector with one rate per individual or a [1 x n] vector with one rate per gene!");
+	}
+	PmScalar = mxGetScalar(prhs[1]);
+	Pm = PmLayout == PM_SCALAR ? &PmScalar : GetDoubles(prhs[1]);  // Input 2 (Pm)
+
+	/* ——————————————————————————————— Get the adaptation scheme ——————————————————————————————— */
+	Adaptation = nrhs > 4 ? prhs[4] : NULL;                         // Input 5 (Adaptation)
+	AdaptScheme = ADAPT_NONE;
+	if (Adaptation != NULL) {
+		Field = mxIsStruct(Adaptation) ? mxGetField(Adaptation, 0, "Scheme") : NULL;
+		if (Field == NULL || mxGetString(Field, Scheme, sizeof(Scheme)) != 0 || (strcmp(Scheme, "onefifth") != 0 && strcmp(Scheme, "lognormal") != 0)) {
+			mexErrMsgIdAndTxt("MATLAB:BitflipMutation:invalidinputs", "Error: Adaptation must be a struct with the Scheme 'onefifth' or 'lognormal'!");
+		}
+		AdaptScheme = strcmp(Scheme, "onefifth") == 0 ? ADAPT_ONE_FIFTH : ADAPT_LOGNORMAL;
+		SuccessRate = GetOption(Adaptation, "SuccessRate", -1);
+		Factor      = GetOption(Adaptation, "Factor", ONE_FIFTH_FACTOR);
+		Tau         = GetOption(Adaptation, "Tau", LOGNORMAL_TAU);
+		MinPm       = GetOption(Adaptation, "MinPm", 0.1 / (double)n);
+		MaxPm       = GetOption(Adaptation, "MaxPm", 0.5);
+
+		if (AdaptScheme == ADAPT_ONE_FIFTH && !(SuccessRate >= 0 && SuccessRate <= 1)) {
+			mexErrMsgIdAndTxt("MATLAB:BitflipMutation:invalidinputs", "Error: The 'onefifth' scheme needs the SuccessRate of the recent mutations, between 0 and 1!");
+		}
+		if (AdaptScheme == ADAPT_LOGNORMAL && PmLayout == PM_PER_GENE) {
+			mexErrMsgIdAndTxt("MATLAB:BitflipMutation:invalidinputs", "Error: The 'lognormal' scheme needs one rate per individual!");
+		}
+	}
+
 	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
-	plhs[0] = mxCreateLogicalMatrix(m, n);
-	MutatedPopulation = mxGetLogicals(plhs[0]);
-	memcpy(MutatedPopulation, Population, sizeof(bool) * m * n );
+	/* The adapted Pm and Flips follow the mutated population, or are the first outputs if the	 */
+	/* population is written in place.															 */
+	Output = 0;
+	if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+		if (nlhs > (AdaptScheme != ADAPT_NONE) + 1 + COUNTERS_OUTPUT || !IsPreallocated(prhs[3], mxLOGICAL_CLASS, m, n)) {
+			mexErrMsgIdAndTxt("MATLAB:BitflipMutation:invalidinputs", "Error: Preallocated MutatedPopulation must be a [m x n] logical matrix, and is not returned!");
+		}
+		MutatedPopulation = mxGetLogicals(prhs[3]);
+	}
+	else {
+		plhs[Output++] = CreateUninitMatrix(m, n, mxLOGICAL_CLASS);
+		MutatedPopulation = mxGetLogicals(plhs[0]);
+	}
+
+	/* ———————————————————————————————————— Adapt the rates ———————————————————————————————————— */
+	/* The adapted rates are copied from Pm, and given to all individuals if a scalar Pm is		 */
+	/* adapted with 'lognormal'. They are only returned if requested.							 */
+	AdaptedPmArray = NULL;
+	if (AdaptScheme != ADAPT_NONE) {
+		NoRates = PmLayout == PM_SCALAR && AdaptScheme != ADAPT_LOGNORMAL ? 1 : PmLayout == PM_PER_GENE ? n : m;
+		AdaptedPmArray = PmLayout == PM_PER_GENE ? CreateUninitMatrix(1, n, mxDOUBLE_CLASS) : CreateUninitMatrix(NoRates, 1, mxDOUBLE_CLASS);
+		AdaptedPm = GetDoubles(AdaptedPmArray);
+		for (i = 0; i < NoRates; i++) {
+			AdaptedPm[i] = Pm[PmLayout == PM_SCALAR ? 0 : i];
+		}
+		if (AdaptScheme == ADAPT_LOGNORMAL) {
+			PmLayout = PM_PER_INDIVIDUAL;
+		}
+		AdaptPm(AdaptedPm, NoRates, AdaptScheme, ElitismNo, SuccessRate, Factor, Tau, MinPm, MaxPm);
+		Pm = AdaptedPm;
+
+		if (nlhs > Output) {
+			plhs[Output] = AdaptedPmArray;
+			AdaptedPmArray = NULL;
+		}
+		Output++;
+	}
+	FlipsOutput = Output;
 
 	/* ——————————————————————————————————— Bitflip Mutation ———————————————————————————————————— */
+	/* The flips are only remembered if the flip list is requested.								 */
+	NoFlips = Bitflip(Population, MutatedPopulation, m, n, Pm, PmLayout, ElitismNo, nlhs > FlipsOutput ? &FlipList : NULL);
+
+	if (nlhs > FlipsOutput) {
+		plhs[FlipsOutput] = CreateUninitMatrix(NoFlips, 2, mxDOUBLE_CLASS);
+		SortFlips(FlipList, NoFlips, m, GetDoubles(plhs[FlipsOutput]));
+		free(FlipList);
+	}
+	if (AdaptedPmArray != NULL) {
+		mxDestroyArray(AdaptedPmArray);
+	}
+
+#ifdef GA_INSTRUMENT
+	if (nlhs > FlipsOutput + 1) {
+		plhs[FlipsOutput + 1] = CountersStruct();
+	}
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking that a preallocated output is a real [m x n] array of the given class.	 */
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n){
+	return mxGetClassID(Array) == Class && !mxIsComplex(Array) && mxGetNumberOfDimensions(Array) == 2
+		&& mxGetM(Array) == m && mxGetN(Array) == n;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading a scalar field of the options struct, or its default if missing.		 */
+double GetOption(const mxArray *Options, const char *Name, double Default){
+	mxArray *Field = Options ? mxGetField(Options, 0, Name) : NULL;
+	return Field != NULL && !mxIsEmpty(Field) ? mxGetScalar(Field) : Default;
+}
+#endif
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for copying the population into MutatedPopulation, unless they are the same, and	 */
+/* flipping every gene of the rows after the first ElitismNo there, with the probability given	 */
+/* by Pm in the layout PmLayout. If FlipList is not NULL, the individual and gene of each flip	 */
+/* are stored in a list allocated with realloc, which the caller frees. Returns the number of	 */
+/* flips.																						 */
+size_t Bitflip(const bool *Population, bool *MutatedPopulation, size_t m, size_t n, const double *Pm, int PmLayout, int ElitismNo, int **FlipList){
+
+	int individual, gene;
+	double RandNr, Rate, LogQ, Skip;
+	int *Flips;
+	size_t NoFlips, FlipCapacity;
+
+	NoFlips = 0;
+	FlipCapacity = 0;
+	Flips = NULL;
+
+	COUNT(COPY_TIME, -WallTime());
+	if (MutatedPopulation != Population) {
+		memcpy(MutatedPopulation, Population, sizeof(bool) * m * n );
+		COUNT(BYTES_COPIED, (double)m * n);
+	}
+	COUNT(COPY_TIME, WallTime());
 
-	/* Loop all genes.																			 */
-	for (gene = 0; gene < n; gene++) {
+	COUNT(MUTATION_TIME, -WallTime());
+	if (PmLayout == PM_PER_GENE) {
+		COUNT(RNG_DRAWS, (double)(m > (size_t)ElitismNo ? m - ElitismNo : 0) * n);
+
+		/* Loop all genes.																		 */
+		for (gene = 0; gene < n; gene++) {
+			/* Loop individuals of population, starting after elites.							 */
+			for (individual = ElitismNo; individual < m; individual++) {
+
+				/* Trigger mutation if Pm of the gene is greater than a random number in the	 */
+				/* range 0-1.																	 */
+				RandNr = (double)rand() / RAND_MAX;
+				if (RandNr < Pm[gene]) {
+					FlipGene(MutatedPopulation, m, individual, gene, FlipList != NULL ? &Flips : NULL, &NoFlips, &FlipCapacity);
+				}
+			}
+		}
+	}
+	else {
 		/* Loop individuals of population, starting after elites.								 */
 		for (individual = ElitismNo; individual < m; individual++) {
-			
-			/* Trigger mutation if Pm is greater than a random number in the range 0-1.			 */
-			RandNr = (double)rand() / RAND_MAX;
-			if (RandNr < (*Pm) ) {
-
-				/* If triggered turn active gene into inactive or vice versa.				     */
-				if (MutatedPopulation[individual + gene*m] == true) {
-					MutatedPopulation[individual + gene*m] = false;
-				}
-				else {
-					MutatedPopulation[individual + gene*m] = true;
+			Rate = Pm[PmLayout == PM_PER_INDIVIDUAL ? individual : 0];
+			if (!(Rate > 0)) {
+				continue;
+			}
+
+			/* Skip the genes up to the next flipped gene, whose number is geometrically		 */
+			/* distributed, until the end of the row. A rate of 1 or more flips every gene.		 */
+			LogQ = Rate < 1 ? log1p(-Rate) : 0;
+			gene = -1;
+			for (;;) {
+				Skip = Rate < 1 ? floor(log(RandUnit()) / LogQ) : 0;
+				if (Skip >= (double)n - 1 - gene) {
+					break;
 				}
+				gene += 1 + (int)Skip;
+				FlipGene(MutatedPopulation, m, individual, gene, FlipList != NULL ? &Flips : NULL, &NoFlips, &FlipCapacity);
 			}
 		}
-	}	
-}
\ No newline at end of file
+	}
+
+	if (FlipList != NULL) {
+		*FlipList = Flips;
+	}
+	COUNT(MUTATION_TIME, WallTime());
+	return NoFlips;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for turning an active gene into an inactive one or vice versa, and appending the	 */
+/* flip to the list in Flips if it is not NULL. The list grows with realloc.					 */
+void FlipGene(bool *MutatedPopulation, size_t m, int individual, int gene, int **Flips, size_t *NoFlips, size_t *FlipCapacity){
+
+	COUNT(FLIPS, 1);
+	if (MutatedPopulation[individual + gene*m] == true) {
+		MutatedPopulation[individual + gene*m] = false;
+	}
+	else {
+		MutatedPopulation[individual + gene*m] = true;
+	}
+
+	/* Remember the flip if the flip list is requested.											 */
+	if (Flips != NULL) {
+		if (*NoFlips == *FlipCapacity) {
+			*FlipCapacity = *FlipCapacity > 0 ? 2 * *FlipCapacity : 1024;
+			*Flips = (int*)realloc(*Flips, sizeof(int) * 2 * *FlipCapacity);
+		}
+		(*Flips)[2 * *NoFlips]     = individual;
+		(*Flips)[2 * *NoFlips + 1] = gene;
+		(*NoFlips)++;
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding the layout of a [Rows x Cols] Pm for a [m x n] population, or -1 if it	 */
+/* has none of them. A [1 x 1] Pm is a scalar, also if m or n is 1.								 */
+int PmLayoutOf(size_t Rows, size_t Cols, size_t m, size_t n){
+	if (Rows == 1 && Cols == 1) {
+		return PM_SCALAR;
+	}
+	if (Rows == m && Cols == 1) {
+		return PM_PER_INDIVIDUAL;
+	}
+	if (Rows == 1 && Cols == n) {
+		return PM_PER_GENE;
+	}
+	return -1;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for adapting the NoRates rates in Pm by the 1/5th success rule (ADAPT_ONE_FIFTH) or	 */
+/* by log-normal self-adaptation (ADAPT_LOGNORMAL), and keeping them between MinPm and MaxPm.	 */
+/* The log-normal self-adaptation leaves the rates of the first ElitismNo individuals as they	 */
+/* are, since the elites are not mutated.														 */
+void AdaptPm(double *Pm, size_t NoRates, int Scheme, int ElitismNo, double SuccessRate, double Factor, double Tau, double MinPm, double MaxPm){
+
+	size_t i;
+
+	for (i = 0; i < NoRates; i++) {
+		if (Scheme == ADAPT_ONE_FIFTH) {
+			/* Larger steps while more than a fifth of the mutations succeed, else smaller.		 */
+			if (SuccessRate > 0.2) {
+				Pm[i] /= Factor;
+			}
+			else if (SuccessRate < 0.2) {
+				Pm[i] *= Factor;
+			}
+		}
+		else if (Scheme == ADAPT_LOGNORMAL && i >= (size_t)ElitismNo) {
+			/* Log-normal step of the odds Pm/(1-Pm), which keeps the rate between 0 and 1.		 */
+			Pm[i] = 1.0 / (1.0 + (1.0 - Pm[i]) / Pm[i] * exp(-Tau * RandNormal()));
+		}
+		if (!(Pm[i] >= MinPm)) {
+			Pm[i] = MinPm;
+		}
+		if (Pm[i] > MaxPm) {
+			Pm[i] = MaxPm;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a uniform random number in (0, 1]. Two numbers of rand() are combined,	 */
+/* as RAND_MAX is only 32767 with some compilers, which would cut off the long skips.			 */
+double RandUnit(void){
+	double Range = (double)RAND_MAX + 1.0;
+	COUNT(RNG_DRAWS, 2);
+	return ((double)rand() * Range + (double)rand() + 1.0) / (Range * Range);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a standard normally distributed random number (Box-Muller).				 */
+double RandNormal(void){
+	double U1 = RandUnit();
+	double U2 = RandUnit();
+	return sqrt(-2.0 * log(U1)) * cos(6.283185307179586 * U2);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for writing the flip list as a [NoFlips x 2] matrix of 1-based individuals and genes. */
+/* With one rate per gene the genes are looped in the outer loop, so the flips are sorted by	 */
+/* individual with a stable counting sort, which keeps the genes of each individual in			 */
+/* increasing order.																			 */
+void SortFlips(const int *FlipList, size_t NoFlips, size_t m, double *FlipsOut){
+
+	int individual, *FlipStart;
+	size_t f;
+
+	COUNT(SORT_TIME, -WallTime());
+	FlipStart = (int*)calloc(m + 1, sizeof(int));
+	for (f = 0; f < NoFlips; f++) {
+		FlipStart[FlipList[2 * f] + 1]++;
+	}
+	for (individual = 0; individual < m; individual++) {
+		FlipStart[individual + 1] += FlipStart[individual];
+	}
+	for (f = 0; f < NoFlips; f++) {
+		individual = FlipList[2 * f];
+		FlipsOut[FlipStart[individual]]           = individual + 1;
+		FlipsOut[FlipStart[individual] + NoFlips] = FlipList[2 * f + 1] + 1;
+		FlipStart[individual]++;
+	}
+	free(FlipStart);
+	COUNT(SORT_TIME, WallTime());
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+#ifdef GA_INSTRUMENT
+/* Function for reading a monotonic wall clock in seconds.										 */
+double WallTime(void){
+#ifdef _WIN32
+	LARGE_INTEGER Count, Frequency;
+	QueryPerformanceCounter(&Count);
+	QueryPerformanceFrequency(&Frequency);
+	return (double)Count.QuadPart / (double)Frequency.QuadPart;
+#else
+	struct timespec Now;
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (double)Now.tv_sec + 1e-9 * (double)Now.tv_nsec;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for writing the counters as a JSON object into a buffer of Size bytes, which like	 */
+/* snprintf returns the length of the full text and truncates it if the buffer is too small.	 */
+int BitflipCountersJson(char *Buffer, size_t Size){
+
+	size_t Used = 0;
+	int Counter;
+
+	for (Counter = 0; Counter < BitflipNoCounters; Counter++) {
+		Used += snprintf(Used < Size ? Buffer + Used : NULL, Used < Size ? Size - Used : 0, "%s\"%s\": %.17g",
+			Counter == 0 ? "{" : ", ", BitflipCounterNames[Counter], BitflipCounters[Counter]);
+	}
+	Used += snprintf(Used < Size ? Buffer + Used : NULL, Used < Size ? Size - Used : 0, "}");
+	return (int)Used;
+}
+#ifndef GA_NO_MEX
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for returning the counters to Matlab as a struct with one scalar field per			 */
+/* counter.																						 */
+mxArray *CountersStruct(void){
+
+	mxArray *Counters;
+	int Counter;
+
+	Counters = mxCreateStructMatrix(1, 1, BitflipNoCounters, BitflipCounterNames);
+	for (Counter = 0; Counter < BitflipNoCounters; Counter++) {
+		mxSetFieldByNumber(Counters, 0, Counter, mxCreateDoubleScalar(BitflipCounters[Counter]));
+	}
+	return Counters;
+}
+#endif
+#endif
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,155 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Bitflip mutation operator, native GNU Octave gateway.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is an Octave function (.oct) with the same inputs and outputs as the MEX function in
+BitflipMutation.c, whose Bitflip, AdaptPm and SortFlips it calls, except that it has no
+preallocated output: Input 4 must be [] when the Adaptation struct is given. Octave passes its own
+arrays to a MEX function by converting them to mxArrays, and converts the outputs back. This
+gateway instead lets Bitflip copy the population once, directly from the input Octave array to the
+output Octave array, and mutate it there.
+
+BitflipMutation.c has to be compiled with GA_NO_MEX defined, which leaves out its MEX gateway.
+When both files are compiled with GA_INSTRUMENT defined, the last output holds the counters of the
+call, as a struct with the same fields as in BitflipMutation.c.
+
+Example on how to compile and run from GNU Octave:
+% Compile .CC and .C to .oct
+>> mkoctfile -DGA_NO_MEX BitflipMutation.cc BitflipMutation.c
+% or with the instrumentation counters
+>> mkoctfile -DGA_NO_MEX -DGA_INSTRUMENT BitflipMutation.cc BitflipMutation.c
+
+% Run from Octave when compiled:
+>> [ MutatedPopulation, Flips ] = BitflipMutation( rand(10000,256) > 0.5, 1/256, 3 );
+>> [ MutatedPopulation, Pm ] = BitflipMutation( rand(10000,256) > 0.5, 1/256, 3, [], struct('Scheme', 'lognormal') );
+
+Example of compatible C++ compilers:
+* GCC 7 and later, with GNU Octave 4.4 and later
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <octave/oct.h> // Needed to communicate with Octave.
+#include <cstdlib>      // Needed for srand() and free().
+#include <ctime>        // Needed for counting CPU clock cycle which is used to set seed for rand().
+#include <cstring>      // Needed for memset.
+#include <string>       // Needed for the name of the adaptation scheme.
+
+/* Layouts of Pm and adaptation schemes, as in BitflipMutation.c.								 */
+#define PM_SCALAR 0
+#define PM_PER_INDIVIDUAL 1
+#define PM_PER_GENE 2
+#define ADAPT_NONE 0
+#define ADAPT_ONE_FIFTH 1
+#define ADAPT_LOGNORMAL 2
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+extern "C" size_t Bitflip(const bool *Population, bool *MutatedPopulation, size_t m, size_t n, const double *Pm, int PmLayout, int ElitismNo, int **FlipList);
+
+extern "C" void SortFlips(const int *FlipList, size_t NoFlips, size_t m, double *FlipsOut);
+
+extern "C" int PmLayoutOf(size_t Rows, size_t Cols, size_t m, size_t n);
+
+extern "C" void AdaptPm(double *Pm, size_t NoRates, int Scheme, int ElitismNo, double SuccessRate, double Factor, double Tau, double MinPm, double MaxPm);
+
+static double GetOption(const octave_scalar_map &Options, const char *Name, double Default);
+
+#ifdef GA_INSTRUMENT
+extern "C" const int BitflipNoCounters;
+extern "C" const char *BitflipCounterNames[];
+extern "C" double BitflipCounters[];
+#endif
+
+/* ——————————————————————————————————— Octave gateway start ———————————————————————————————————— */
+DEFUN_DLD(BitflipMutation, args, nargout,
+	"[ MutatedPopulation, Flips ] = BitflipMutation( Population, Pm, ElitismNo )\n"
+	"[ MutatedPopulation, Pm, Flips ] = BitflipMutation( Population, Pm, ElitismNo, [], Adaptation )"){
+
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.        */
+	srand(clock());
+#ifdef GA_INSTRUMENT
+	memset(BitflipCounters, 0, sizeof(double) * BitflipNoCounters);
+#endif
+
+	if ((args.length() != 3 && args.length() != 5) || !args(0).islogical() || (args.length() == 5 && (!args(3).isempty() || !args(4).isstruct()))) {
+		error_with_id("Octave:BitflipMutation:invalidinputs", "Error: Inputs must be a logical Population, Pm and ElitismNo, optionally followed by [] and an Adaptation struct!");
+	}
+
+	/* ———————————————————————— Get the input variables without copying ———————————————————————— */
+	const boolNDArray Population = args(0).bool_array_value(); // Input 1 (Population)
+	NDArray Pm                   = args(1).array_value();      // Input 2 (Pm)
+	int ElitismNo                = args(2).int_value();        // Input 3 (Elitism rows)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	size_t m = Population.rows();                              // Number of rows in Population.
+	size_t n = Population.columns();                           // Number of columns in Population.
+
+	int PmLayout = PmLayoutOf(Pm.rows(), Pm.columns(), m, n);
+	if (PmLayout < 0) {
+		error_with_id("Octave:BitflipMutation:invalidinputs", "Error: Pm must be a scalar, a [m x 1] vector with one rate per individual or a [1 x n] vector with one rate per gene!");
+	}
+
+	/* ———————————————————————————————————— Adapt the rates ———————————————————————————————————— */
+	/* Pm is a copy of the input, which Octave makes unique before it is changed.				 */
+	bool Adapt = args.length() == 5;
+	if (Adapt) {
+		octave_scalar_map Adaptation = args(4).scalar_map_value();   // Input 5 (Adaptation)
+		std::string Scheme = Adaptation.isfield("Scheme") ? Adaptation.contents("Scheme").string_value() : "";
+		if (Scheme != "onefifth" && Scheme != "lognormal") {
+			error_with_id("Octave:BitflipMutation:invalidinputs", "Error: Adaptation must be a struct with the Scheme 'onefifth' or 'lognormal'!");
+		}
+		int AdaptScheme    = Scheme == "onefifth" ? ADAPT_ONE_FIFTH : ADAPT_LOGNORMAL;
+		double SuccessRate = GetOption(Adaptation, "SuccessRate", -1);
+		if (AdaptScheme == ADAPT_ONE_FIFTH && !(SuccessRate >= 0 && SuccessRate <= 1)) {
+			error_with_id("Octave:BitflipMutation:invalidinputs", "Error: The 'onefifth' scheme needs the SuccessRate of the recent mutations, between 0 and 1!");
+		}
+		if (AdaptScheme == ADAPT_LOGNORMAL) {
+			if (PmLayout == PM_PER_GENE) {
+				error_with_id("Octave:BitflipMutation:invalidinputs", "Error: The 'lognormal' scheme needs one rate per individual!");
+			}
+			if (PmLayout == PM_SCALAR) {
+				Pm = NDArray(dim_vector(m, 1), Pm(0));
+			}
+			PmLayout = PM_PER_INDIVIDUAL;
+		}
+		AdaptPm(Pm.fortran_vec(), Pm.numel(), AdaptScheme, ElitismNo, SuccessRate,
+			GetOption(Adaptation, "Factor", 0.817), GetOption(Adaptation, "Tau", 0.22),
+			GetOption(Adaptation, "MinPm", 0.1 / (double)n), GetOption(Adaptation, "MaxPm", 0.5));
+	}
+
+	/* ——————————————————————————————— Specify Octave outputs —————————————————————————————————— */
+	boolMatrix MutatedPopulation(m, n);
+
+	/* ——————————————————————————————————— Bitflip Mutation ———————————————————————————————————— */
+	/* The flips are only remembered if the flip list is requested.								 */
+	int FlipsOutput = Adapt ? 2 : 1;
+	int *FlipList = NULL;
+	size_t NoFlips = Bitflip(Population.data(), MutatedPopulation.fortran_vec(), m, n, Pm.data(), PmLayout, ElitismNo, nargout > FlipsOutput ? &FlipList : NULL);
+
+	octave_value_list Outputs = ovl(MutatedPopulation);
+	if (Adapt) {
+		Outputs(1) = Pm;
+	}
+	if (nargout > FlipsOutput) {
+		Matrix Flips(NoFlips, 2);
+		SortFlips(FlipList, NoFlips, m, Flips.fortran_vec());
+		free(FlipList);
+		Outputs(FlipsOutput) = Flips;
+	}
+#ifdef GA_INSTRUMENT
+	if (nargout > FlipsOutput + 1) {
+		octave_scalar_map Counters;
+		for (int Counter = 0; Counter < BitflipNoCounters; Counter++) {
+			Counters.assign(BitflipCounterNames[Counter], BitflipCounters[Counter]);
+		}
+		Outputs(FlipsOutput + 1) = Counters;
+	}
+#endif
+	return Outputs;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for reading a scalar field of the options struct, or its default if missing.		 */
+static double GetOption(const octave_scalar_map &Options, const char *Name, double Default){
+	return Options.isfield(Name) && !Options.contents(Name).isempty() ? Options.contents(Name).double_value() : Default;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,972 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Genetic operators for Python.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a Python extension module which makes the tournament selection, N-point crossover, uniform
+crossover and bitflip mutation of the MEX functions available from Python, so that GA runs driven
+from Python can use the C operators instead of operators written in NumPy.
+
+The operators take and return NumPy arrays without copying them: the inputs are read in place
+through the Python buffer protocol, with any memory layout (C or Fortran order, or a strided view
+of a larger array), and the outputs are NumPy arrays which the operators write directly. The
+bitflip mutation can also mutate its input in place. The Python interpreter lock is released while
+an operator runs, so operators called from several Python threads run in parallel.
+
+A population is either a [m x n] NumPy array of booleans, with one individual per row, or a
+PackedPopulation, which holds the m individuals packed into 64-bit words (gene j in bit j%64 of
+word j/64, one row of words per individual) as in IslandGA and PopulationCheckpoint. The operators
+return a population of the same kind as their input. On a PackedPopulation the crossover swaps
+whole words between the parents and the selection copies whole words, and it takes 8 times less
+memory than a boolean array. A PackedPopulation supports the buffer protocol as a [m x Words]
+array of uint64, so numpy.asarray(Packed) gives a view of its words without copying.
+
+The module contains:
+* TournamentSelection(k, Fitness, Population, NoSurvivors, Eliterows=0, Seed=None) returns
+(Survivors, SurvivorFitness), as TournamentSelection.
+* NpointCrossover(Parentpool, N, my, Seed=None) returns my children made in pairs from randomly
+chosen pairs of parents with N unique crossover points, as NpointCrossover.
+* UniformCrossover(Parentpool, my, Seed=None) returns my children made in pairs from randomly
+chosen pairs of parents, where each gene is taken from either parent with probability 0.5.
+* BitflipMutation(Population, Pm, ElitismNo=0, Seed=None, InPlace=False) returns the population
+with every gene of the individuals after the first ElitismNo flipped with probability Pm, as
+BitflipMutation. With InPlace=True the input population is mutated and returned.
+* PackedPopulation(Population) packs a boolean population. Its method Unpack() returns the
+boolean population, and its attributes Rows and Genes give the size of the population.
+The fitness is a vector of float64 with one element per individual, higher better. Seed defaults to
+a number drawn from a generator seeded from the clock when the module is imported.
+
+Example on how to compile and run from Python:
+% Compile and install the module (NumPy is needed at run time only)
+$ pip install "Python bindings/Binary representation"
+
+% Run from Python when compiled:
+>>> import numpy as np
+>>> import GeneticOperators as go
+>>> Population = np.random.rand(10000, 256) < 0.5
+>>> Fitness = Population.sum(axis=1).astype(np.float64)
+>>> Survivors, SurvivorFitness = go.TournamentSelection(3, Fitness, Population, 5000, 0)
+>>> Children = go.NpointCrossover(Survivors, 2, 10000)
+>>> go.BitflipMutation(Children, 1/256, InPlace=True)
+>>> Packed = go.PackedPopulation(Children)
+>>> Words = np.asarray(Packed)
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2015 Professional (C)
+* GCC 4.8 and later
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>		// Needed to communicate with Python.
+#include <structmember.h>	// Needed for the attributes of PackedPopulation.
+#include <stdbool.h>	// Needed for bool.
+#include <stdint.h>		// Needed for fixed width 64-bit integers.
+#include <string.h>		// Needed for memcpy, memset and strchr.
+#include <math.h>		// Needed for log() and log1p() in the skip sampling of the mutation.
+#include <time.h>		// Needed for the clock which is used to seed the default seeds.
+
+/* ——————————————————————————————————————————— Types ——————————————————————————————————————————— */
+/* Population packed into 64-bit words, one row of Words words per individual.					 */
+typedef struct {
+	PyObject_HEAD
+	uint64_t *Genomes;          // [Rows x Words] packed individuals.
+	Py_ssize_t Rows, Genes, Words;
+	Py_ssize_t Shape[2], Strides[2];
+} PackedPopulation;
+
+/* Boolean population exported through the buffer protocol. Gene j of individual i is the byte	 */
+/* at Data + i*RowStride + j*GeneStride.														 */
+typedef struct {
+	Py_buffer View;
+	char *Data;
+	Py_ssize_t Rows, Genes, RowStride, GeneStride;
+} BoolMatrix;
+
+/* Population of either kind, as taken by the operators.										 */
+typedef struct {
+	PackedPopulation *Packed;   // NULL for a boolean population.
+	BoolMatrix Bool;
+	Py_ssize_t Rows, Genes;
+} Population;
+
+static PyTypeObject PackedPopulationType;
+
+/* numpy.empty, used to create the output arrays, and the generator of the default seeds.		 */
+static PyObject *NumpyEmpty;
+static uint64_t SeedRng[4];
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+int GetPopulation(PyObject *Object, Population *Pop, bool Writable);
+
+void ReleasePopulation(Population *Pop);
+
+PyObject *NewPopulation(const Population *Like, Py_ssize_t Rows, Population *Out);
+
+int GetFitness(PyObject *Object, Py_ssize_t m, Py_buffer *View, Py_ssize_t *Stride);
+
+PyObject *NewArray(Py_ssize_t Rows, Py_ssize_t Columns, const char *Dtype, Py_buffer *View);
+
+int GetSeed(PyObject *Object, uint64_t *Rng);
+
+bool FormatIs(const Py_buffer *View, char Code);
+
+PackedPopulation *NewPacked(Py_ssize_t Rows, Py_ssize_t Genes);
+
+void CopyRow(const Population *From, Py_ssize_t FromRow, Population *To, Py_ssize_t ToRow);
+
+void TourSel(int k, const double *Fitness, Py_ssize_t FitnessStride, Py_ssize_t m, int NoSurvivors, int Eliterows, uint64_t *Rng, Py_ssize_t *ContenderList, Py_ssize_t *Winners, double *SurvivorFitness);
+
+void DrawParents(uint64_t *Rng, Py_ssize_t m, Py_ssize_t *P1, Py_ssize_t *P2);
+
+void DrawCrossoverPoints(uint64_t *Rng, Py_ssize_t n, int N, int *CrossOverPoints);
+
+void CrossPair(const Population *Parents, Py_ssize_t P1, Py_ssize_t P2, const uint64_t *Mask, Population *Children, Py_ssize_t Child);
+
+void Mutate(Population *Pop, double Pm, Py_ssize_t ElitismNo, uint64_t *Rng);
+
+uint64_t DrawSkip(uint64_t *Rng, double LogQ, uint64_t Genes);
+
+void SetBitRange(uint64_t *Mask, size_t Start, size_t End);
+
+int cmpfunc(const void * a, const void * b);
+
+uint64_t RngNext(uint64_t *s);
+
+void RngSeed(uint64_t *s, uint64_t Seed);
+
+unsigned int RandBelow(uint64_t *s, unsigned int Range);
+
+double RandUnit(uint64_t *s);
+
+/* ———————————————————————————————————— Tournament selection ——————————————————————————————————— */
+static PyObject *TournamentSelection(PyObject *Self, PyObject *Args, PyObject *Kwargs){
+
+	static char *Keywords[] = { "k", "Fitness", "Population", "NoSurvivors", "Eliterows", "Seed", NULL };
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	int k, NoSurvivors, Eliterows = 0, Tournament;
+	PyObject *FitnessObject, *PopulationObject, *SeedObject = Py_None;
+	PyObject *Survivors = NULL, *SurvivorFitness = NULL;
+	Population Pop, Out;
+	Py_buffer FitnessView, SurvivorFitnessView;
+	Py_ssize_t FitnessStride, *Winners, *ContenderList;
+	uint64_t Rng[4];
+
+	/* ———————————————————————————————————— Get the inputs ————————————————————————————————————— */
+	if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "iOOi|iO:TournamentSelection", Keywords,
+		&k, &FitnessObject, &PopulationObject, &NoSurvivors, &Eliterows, &SeedObject)) {
+		return NULL;
+	}
+	if (GetSeed(SeedObject, Rng) < 0 || GetPopulation(PopulationObject, &Pop, false) < 0) {
+		return NULL;
+	}
+	if (GetFitness(FitnessObject, Pop.Rows, &FitnessView, &FitnessStride) < 0) {
+		ReleasePopulation(&Pop);
+		return NULL;
+	}
+	if (NoSurvivors < 0 || Eliterows < 0 || k < 1 || Eliterows + k > Pop.Rows) {
+		PyErr_SetString(PyExc_ValueError, "Error: k must be at least 1 and at most the number of rows after Eliterows, and NoSurvivors must not be negative!");
+		goto Done;
+	}
+
+	/* ——————————————————————————————————— Create the outputs —————————————————————————————————— */
+	Survivors = NewPopulation(&Pop, NoSurvivors, &Out);
+	if (Survivors == NULL) {
+		goto Done;
+	}
+	SurvivorFitness = NewArray(NoSurvivors, -1, "float64", &SurvivorFitnessView);
+	if (SurvivorFitness == NULL) {
+		ReleasePopulation(&Out);
+		Py_CLEAR(Survivors);
+		goto Done;
+	}
+	Winners = (Py_ssize_t*)PyMem_Malloc(sizeof(Py_ssize_t) * (NoSurvivors + 1));
+	ContenderList = (Py_ssize_t*)PyMem_Malloc(sizeof(Py_ssize_t) * k);
+	if (Winners == NULL || ContenderList == NULL) {
+		PyMem_Free(Winners);
+		PyMem_Free(ContenderList);
+		ReleasePopulation(&Out);
+		PyBuffer_Release(&SurvivorFitnessView);
+		Py_CLEAR(Survivors);
+		Py_CLEAR(SurvivorFitness);
+		PyErr_NoMemory();
+		goto Done;
+	}
+
+	/* ——————————————————————————————— Tournament selection ———————————————————————————————————— */
+	Py_BEGIN_ALLOW_THREADS
+	TourSel(k, (const double*)FitnessView.buf, FitnessStride, Pop.Rows, NoSurvivors, Eliterows, Rng, ContenderList, Winners, (double*)SurvivorFitnessView.buf);
+	for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+		CopyRow(&Pop, Winners[Tournament], &Out, Tournament);
+	}
+	Py_END_ALLOW_THREADS
+
+	PyMem_Free(Winners);
+	PyMem_Free(ContenderList);
+	ReleasePopulation(&Out);
+	PyBuffer_Release(&SurvivorFitnessView);
+
+Done:
+	PyBuffer_Release(&FitnessView);
+	ReleasePopulation(&Pop);
+	if (Survivors == NULL) {
+		return NULL;
+	}
+	return Py_BuildValue("NN", Survivors, SurvivorFitness);
+}
+
+/* ————————————————————————————————————— N-point crossover ————————————————————————————————————— */
+static PyObject *NpointCrossover(PyObject *Self, PyObject *Args, PyObject *Kwargs){
+
+	static char *Keywords[] = { "Parentpool", "N", "my", "Seed", NULL };
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	int N, my, i;
+	PyObject *ParentObject, *SeedObject = Py_None, *Children;
+	Population Parents, Out;
+	Py_ssize_t Child, P1, P2, Words;
+	int *CrossOverPoints;
+	uint64_t *Mask, Rng[4];
+
+	/* ———————————————————————————————————— Get the inputs ————————————————————————————————————— */
+	if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "Oii|O:NpointCrossover", Keywords,
+		&ParentObject, &N, &my, &SeedObject)) {
+		return NULL;
+	}
+	if (GetSeed(SeedObject, Rng) < 0 || GetPopulation(ParentObject, &Parents, false) < 0) {
+		return NULL;
+	}
+	if (N < 1 || N >= Parents.Genes) {
+		PyErr_SetString(PyExc_ValueError, "Error: Crossover points (N) must be between 1 and the number of genes minus 1!");
+		ReleasePopulation(&Parents);
+		return NULL;
+	}
+	if (Parents.Rows < 2 || my < 0) {
+		PyErr_SetString(PyExc_ValueError, "Error: Parentpool must hold at least 2 parents, and my must not be negative!");
+		ReleasePopulation(&Parents);
+		return NULL;
+	}
+
+	/* ——————————————————————————————————— Create the output ——————————————————————————————————— */
+	Children = NewPopulation(&Parents, my, &Out);
+	if (Children == NULL) {
+		ReleasePopulation(&Parents);
+		return NULL;
+	}
+	Words = (Parents.Genes + 63) / 64;
+	CrossOverPoints = (int*)PyMem_Malloc(sizeof(int) * N);
+	Mask = (uint64_t*)PyMem_Malloc(sizeof(uint64_t) * Words);
+	if (CrossOverPoints == NULL || Mask == NULL) {
+		PyMem_Free(CrossOverPoints);
+		PyMem_Free(Mask);
+		ReleasePopulation(&Out);
+		ReleasePopulation(&Parents);
+		Py_DECREF(Children);
+		return PyErr_NoMemory();
+	}
+
+	/* ——————————————————————————————————— N-point crossover ——————————————————————————————————— */
+	/* The children are made in pairs from the same parents and crossover points, and every		 */
+	/* second segment, starting with the second, comes from the second parent.					 */
+	Py_BEGIN_ALLOW_THREADS
+	for (Child = 0; Child < my; Child += 2) {
+		DrawParents(Rng, Parents.Rows, &P1, &P2);
+		DrawCrossoverPoints(Rng, Parents.Genes, N, CrossOverPoints);
+		memset(Mask, 0, sizeof(uint64_t) * Words);
+		for (i = 0; i < N; i += 2) {
+			SetBitRange(Mask, CrossOverPoints[i], i + 1 < N ? (size_t)CrossOverPoints[i + 1] : (size_t)Parents.Genes);
+		}
+		CrossPair(&Parents, P1, P2, Mask, &Out, Child);
+	}
+	Py_END_ALLOW_THREADS
+
+	PyMem_Free(CrossOverPoints);
+	PyMem_Free(Mask);
+	ReleasePopulation(&Out);
+	ReleasePopulation(&Parents);
+	return Children;
+}
+
+/* ————————————————————————————————————— Uniform crossover ————————————————————————————————————— */
+static PyObject *UniformCrossover(PyObject *Self, PyObject *Args, PyObject *Kwargs){
+
+	static char *Keywords[] = { "Parentpool", "my", "Seed", NULL };
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	int my;
+	PyObject *ParentObject, *SeedObject = Py_None, *Children;
+	Population Parents, Out;
+	Py_ssize_t Child, P1, P2, Words, word;
+	uint64_t *Mask, Rng[4];
+
+	/* ———————————————————————————————————— Get the inputs ————————————————————————————————————— */
+	if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "Oi|O:UniformCrossover", Keywords,
+		&ParentObject, &my, &SeedObject)) {
+		return NULL;
+	}
+	if (GetSeed(SeedObject, Rng) < 0 || GetPopulation(ParentObject, &Parents, false) < 0) {
+		return NULL;
+	}
+	if (Parents.Rows < 2 || my < 0) {
+		PyErr_SetString(PyExc_ValueError, "Error: Parentpool must hold at least 2 parents, and my must not be negative!");
+		ReleasePopulation(&Parents);
+		return NULL;
+	}
+
+	/* ——————————————————————————————————— Create the output ——————————————————————————————————— */
+	Children = NewPopulation(&Parents, my, &Out);
+	if (Children == NULL) {
+		ReleasePopulation(&Parents);
+		return NULL;
+	}
+	Words = (Parents.Genes + 63) / 64;
+	Mask = (uint64_t*)PyMem_Malloc(sizeof(uint64_t) * Words);
+	if (Mask == NULL) {
+		ReleasePopulation(&Out);
+		ReleasePopulation(&Parents);
+		Py_DECREF(Children);
+		return PyErr_NoMemory();
+	}
+
+	/* ——————————————————————————————————— Uniform crossover ——————————————————————————————————— */
+	/* One random bit per gene decides which parent the gene of the first child comes from.		 */
+	Py_BEGIN_ALLOW_THREADS
+	for (Child = 0; Child < my; Child += 2) {
+		DrawParents(Rng, Parents.Rows, &P1, &P2);
+		for (word = 0; word < Words; word++) {
+			Mask[word] = RngNext(Rng);
+		}
+		CrossPair(&Parents, P1, P2, Mask, &Out, Child);
+	}
+	Py_END_ALLOW_THREADS
+
+	PyMem_Free(Mask);
+	ReleasePopulation(&Out);
+	ReleasePopulation(&Parents);
+	return Children;
+}
+
+/* —————————————————————————————————————— Bitflip mutation ————————————————————————————————————— */
+static PyObject *BitflipMutation(PyObject *Self, PyObject *Args, PyObject *Kwargs){
+
+	static char *Keywords[] = { "Population", "Pm", "ElitismNo", "Seed", "InPlace", NULL };
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	double Pm;
+	Py_ssize_t ElitismNo = 0, row;
+	int InPlace = 0;
+	PyObject *PopulationObject, *SeedObject = Py_None, *Mutated;
+	Population Pop, Out;
+	uint64_t Rng[4];
+
+	/* ———————————————————————————————————— Get the inputs ————————————————————————————————————— */
+	if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "Od|nOp:BitflipMutation", Keywords,
+		&PopulationObject, &Pm, &ElitismNo, &SeedObject, &InPlace)) {
+		return NULL;
+	}
+	if (Pm < 0 || Pm > 1 || ElitismNo < 0) {
+		PyErr_SetString(PyExc_ValueError, "Error: Pm must be between 0 and 1, and ElitismNo must not be negative!");
+		return NULL;
+	}
+	if (GetSeed(SeedObject, Rng) < 0 || GetPopulation(PopulationObject, &Pop, InPlace != 0) < 0) {
+		return NULL;
+	}
+
+	/* —————————————————————————————— Create or reuse the output ——————————————————————————————— */
+	if (InPlace) {
+		Out = Pop;
+		Mutated = PopulationObject;
+		Py_INCREF(Mutated);
+	}
+	else {
+		Mutated = NewPopulation(&Pop, Pop.Rows, &Out);
+		if (Mutated == NULL) {
+			ReleasePopulation(&Pop);
+			return NULL;
+		}
+	}
+
+	/* ——————————————————————————————————— Bitflip mutation ———————————————————————————————————— */
+	Py_BEGIN_ALLOW_THREADS
+	if (!InPlace) {
+		for (row = 0; row < Pop.Rows; row++) {
+			CopyRow(&Pop, row, &Out, row);
+		}
+	}
+	Mutate(&Out, Pm, ElitismNo, Rng);
+	Py_END_ALLOW_THREADS
+
+	if (!InPlace) {
+		ReleasePopulation(&Pop);
+	}
+	ReleasePopulation(&Out);
+	return Mutated;
+}
+
+/* ————————————————————————————————————— PackedPopulation —————————————————————————————————————— */
+static PyObject *PackedPopulation_new(PyTypeObject *Type, PyObject *Args, PyObject *Kwargs){
+
+	static char *Keywords[] = { "Population", NULL };
+
+	PyObject *PopulationObject;
+	PackedPopulation *Packed;
+	BoolMatrix *Bool;
+	Population Pop;
+	Py_ssize_t row, gene;
+	uint64_t *Genome;
+
+	if (!PyArg_ParseTupleAndKeywords(Args, Kwargs, "O:PackedPopulation", Keywords, &PopulationObject)) {
+		return NULL;
+	}
+	if (GetPopulation(PopulationObject, &Pop, false) < 0) {
+		return NULL;
+	}
+	if (Pop.Packed != NULL) {
+		PyErr_SetString(PyExc_TypeError, "Error: Population is already packed!");
+		ReleasePopulation(&Pop);
+		return NULL;
+	}
+	Packed = NewPacked(Pop.Rows, Pop.Genes);
+	if (Packed == NULL) {
+		ReleasePopulation(&Pop);
+		return NULL;
+	}
+
+	/* Pack the genes of each row into the words of the row.									 */
+	Bool = &Pop.Bool;
+	Py_BEGIN_ALLOW_THREADS
+	for (row = 0; row < Pop.Rows; row++) {
+		Genome = Packed->Genomes + row * Packed->Words;
+		for (gene = 0; gene < Pop.Genes; gene++) {
+			if (Bool->Data[row * Bool->RowStride + gene * Bool->GeneStride]) {
+				Genome[gene / 64] |= (uint64_t)1 << (gene % 64);
+			}
+		}
+	}
+	Py_END_ALLOW_THREADS
+
+	ReleasePopulation(&Pop);
+	return (PyObject*)Packed;
+}
+
+static PyObject *PackedPopulation_Unpack(PackedPopulation *Self, PyObject *Unused){
+
+	PyObject *Unpacked;
+	Py_buffer View;
+	Py_ssize_t row, gene;
+	const uint64_t *Genome;
+	bool *Out;
+
+	Unpacked = NewArray(Self->Rows, Self->Genes, "bool", &View);
+	if (Unpacked == NULL) {
+		return NULL;
+	}
+	Out = (bool*)View.buf;
+	Py_BEGIN_ALLOW_THREADS
+	for (row = 0; row < Self->Rows; row++) {
+		Genome = Self->Genomes + row * Self->Words;
+		for (gene = 0; gene < Self->Genes; gene++) {
+			Out[row * Self->Genes + gene] = (Genome[gene / 64] >> (gene % 64)) & 1;
+		}
+	}
+	Py_END_ALLOW_THREADS
+
+	PyBuffer_Release(&View);
+	return Unpacked;
+}
+
+static int PackedPopulation_getbuffer(PackedPopulation *Self, Py_buffer *View, int Flags){
+	View->obj = (PyObject*)Self;
+	Py_INCREF(Self);
+	View->buf = Self->Genomes;
+	View->len = sizeof(uint64_t) * Self->Rows * Self->Words;
+	View->readonly = 0;
+	View->itemsize = sizeof(uint64_t);
+	View->format = (Flags & PyBUF_FORMAT) ? "Q" : NULL;
+	View->ndim = 2;
+	View->shape = (Flags & PyBUF_ND) ? Self->Shape : NULL;
+	View->strides = (Flags & PyBUF_STRIDES) == PyBUF_STRIDES ? Self->Strides : NULL;
+	View->suboffsets = NULL;
+	View->internal = NULL;
+	if (View->shape == NULL) {
+		View->ndim = 1;
+	}
+	return 0;
+}
+
+static void PackedPopulation_dealloc(PackedPopulation *Self){
+	PyMem_Free(Self->Genomes);
+	Py_TYPE(Self)->tp_free((PyObject*)Self);
+}
+
+static PyMemberDef PackedPopulation_members[] = {
+	{ "Rows", T_PYSSIZET, offsetof(PackedPopulation, Rows), READONLY, "Number of individuals." },
+	{ "Genes", T_PYSSIZET, offsetof(PackedPopulation, Genes), READONLY, "Number of genes per individual." },
+	{ NULL }
+};
+
+static PyMethodDef PackedPopulation_methods[] = {
+	{ "Unpack", (PyCFunction)PackedPopulation_Unpack, METH_NOARGS, "Unpack() returns the population as a [Rows x Genes] boolean array." },
+	{ NULL }
+};
+
+static PyBufferProcs PackedPopulation_as_buffer = {
+	(getbufferproc)PackedPopulation_getbuffer,
+	NULL
+};
+
+static PyTypeObject PackedPopulationType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	"GeneticOperators.PackedPopulation",        // tp_name
+	sizeof(PackedPopulation),                   // tp_basicsize
+};
+
+/* —————————————————————————————————————— Module definition ———————————————————————————————————— */
+static PyMethodDef GeneticOperatorsMethods[] = {
+	{ "TournamentSelection", (PyCFunction)TournamentSelection, METH_VARARGS | METH_KEYWORDS,
+	  "TournamentSelection(k, Fitness, Population, NoSurvivors, Eliterows=0, Seed=None) -> (Survivors, SurvivorFitness)" },
+	{ "NpointCrossover", (PyCFunction)NpointCrossover, METH_VARARGS | METH_KEYWORDS,
+	  "NpointCrossover(Parentpool, N, my, Seed=None) -> Children" },
+	{ "UniformCrossover", (PyCFunction)UniformCrossover, METH_VARARGS | METH_KEYWORDS,
+	  "UniformCrossover(Parentpool, my, Seed=None) -> Children" },
+	{ "BitflipMutation", (PyCFunction)BitflipMutation, METH_VARARGS | METH_KEYWORDS,
+	  "BitflipMutation(Population, Pm, ElitismNo=0, Seed=None, InPlace=False) -> Population" },
+	{ NULL }
+};
+
+static struct PyModuleDef GeneticOperatorsModule = {
+	PyModuleDef_HEAD_INIT,
+	"GeneticOperators",
+	"Tournament selection, N-point and uniform crossover and bitflip mutation on NumPy arrays.",
+	-1,
+	GeneticOperatorsMethods
+};
+
+PyMODINIT_FUNC PyInit_GeneticOperators(void){
+
+	PyObject *Module, *Numpy;
+
+	PackedPopulationType.tp_doc = "PackedPopulation(Population) packs a [m x n] boolean population into 64-bit words.";
+	PackedPopulationType.tp_flags = Py_TPFLAGS_DEFAULT;
+	PackedPopulationType.tp_new = PackedPopulation_new;
+	PackedPopulationType.tp_dealloc = (destructor)PackedPopulation_dealloc;
+	PackedPopulationType.tp_members = PackedPopulation_members;
+	PackedPopulationType.tp_methods = PackedPopulation_methods;
+	PackedPopulationType.tp_as_buffer = &PackedPopulation_as_buffer;
+	if (PyType_Ready(&PackedPopulationType) < 0) {
+		return NULL;
+	}
+
+	Numpy = PyImport_ImportModule("numpy");
+	if (Numpy == NULL) {
+		return NULL;
+	}
+	NumpyEmpty = PyObject_GetAttrString(Numpy, "empty");
+	Py_DECREF(Numpy);
+	if (NumpyEmpty == NULL) {
+		return NULL;
+	}
+	RngSeed(SeedRng, (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32));
+
+	Module = PyModule_Create(&GeneticOperatorsModule);
+	if (Module == NULL) {
+		return NULL;
+	}
+	Py_INCREF(&PackedPopulationType);
+	if (PyModule_AddObject(Module, "PackedPopulation", (PyObject*)&PackedPopulationType) < 0) {
+		Py_DECREF(&PackedPopulationType);
+		Py_DECREF(Module);
+		return NULL;
+	}
+	return Module;
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for getting a population of either kind. A boolean population is exported through	 */
+/* the buffer protocol, so that it is read (or, if Writable, mutated) in place.					 */
+int GetPopulation(PyObject *Object, Population *Pop, bool Writable){
+
+	BoolMatrix *Bool = &Pop->Bool;
+
+	if (PyObject_TypeCheck(Object, &PackedPopulationType)) {
+		Pop->Packed = (PackedPopulation*)Object;
+		Pop->Rows = Pop->Packed->Rows;
+		Pop->Genes = Pop->Packed->Genes;
+		return 0;
+	}
+	Pop->Packed = NULL;
+	if (PyObject_GetBuffer(Object, &Bool->View, PyBUF_STRIDES | PyBUF_FORMAT | (Writable ? PyBUF_WRITABLE : 0)) < 0) {
+		return -1;
+	}
+	if (Bool->View.ndim != 2 || Bool->View.itemsize != 1 || !FormatIs(&Bool->View, '?')) {
+		PyErr_SetString(PyExc_TypeError, "Error: Population must be a [m x n] array of booleans or a PackedPopulation!");
+		PyBuffer_Release(&Bool->View);
+		return -1;
+	}
+	Bool->Data = (char*)Bool->View.buf;
+	Bool->Rows = Pop->Rows = Bool->View.shape[0];
+	Bool->Genes = Pop->Genes = Bool->View.shape[1];
+	Bool->RowStride = Bool->View.strides[0];
+	Bool->GeneStride = Bool->View.strides[1];
+	return 0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for releasing a population got by GetPopulation or NewPopulation.					 */
+void ReleasePopulation(Population *Pop){
+	if (Pop->Packed == NULL) {
+		PyBuffer_Release(&Pop->Bool.View);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for creating an output population of the same kind and number of genes as Like.		 */
+PyObject *NewPopulation(const Population *Like, Py_ssize_t Rows, Population *Out){
+
+	PyObject *Object;
+
+	if (Like->Packed != NULL) {
+		Object = (PyObject*)NewPacked(Rows, Like->Genes);
+	}
+	else {
+		Object = NewArray(Rows, Like->Genes, "bool", &Out->Bool.View);
+		if (Object != NULL) {
+			PyBuffer_Release(&Out->Bool.View);
+		}
+	}
+	if (Object == NULL || GetPopulation(Object, Out, true) < 0) {
+		Py_XDECREF(Object);
+		return NULL;
+	}
+	return Object;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for getting the fitness vector, which must hold one float64 per individual.			 */
+int GetFitness(PyObject *Object, Py_ssize_t m, Py_buffer *View, Py_ssize_t *Stride){
+	if (PyObject_GetBuffer(Object, View, PyBUF_STRIDES | PyBUF_FORMAT) < 0) {
+		return -1;
+	}
+	if (View->ndim != 1 || View->shape[0] != m || !FormatIs(View, 'd')) {
+		PyErr_SetString(PyExc_ValueError, "Error: Fitness must be a vector of float64 with one element per individual in Population!");
+		PyBuffer_Release(View);
+		return -1;
+	}
+	*Stride = View->strides[0];
+	return 0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for creating a C-ordered NumPy array of [Rows x Columns] elements, or of [Rows]		 */
+/* elements if Columns is negative, and exporting its memory for writing.						 */
+PyObject *NewArray(Py_ssize_t Rows, Py_ssize_t Columns, const char *Dtype, Py_buffer *View){
+
+	PyObject *Array;
+
+	if (Columns < 0) {
+		Array = PyObject_CallFunction(NumpyEmpty, "(n)s", Rows, Dtype);
+	}
+	else {
+		Array = PyObject_CallFunction(NumpyEmpty, "(nn)s", Rows, Columns, Dtype);
+	}
+	if (Array == NULL) {
+		return NULL;
+	}
+	if (PyObject_GetBuffer(Array, View, PyBUF_CONTIG) < 0) {
+		Py_DECREF(Array);
+		return NULL;
+	}
+	return Array;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for seeding the generator of an operator from the Seed input, or if the Seed is		 */
+/* None from the generator of the default seeds, which is only used with the lock held.			 */
+int GetSeed(PyObject *Object, uint64_t *Rng){
+
+	uint64_t Seed;
+
+	if (Object == Py_None) {
+		Seed = RngNext(SeedRng);
+	}
+	else {
+		Seed = (uint64_t)PyLong_AsUnsignedLongLongMask(Object);
+		if (PyErr_Occurred()) {
+			return -1;
+		}
+	}
+	RngSeed(Rng, Seed);
+	return 0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking the element type of a buffer, with or without native byte order prefix. */
+bool FormatIs(const Py_buffer *View, char Code){
+	const char *Format = View->format;
+	if (Format == NULL) {
+		return Code == 'B';
+	}
+	if (*Format != '\0' && strchr("@=<", *Format) != NULL) {
+		Format++;
+	}
+	return Format[0] == Code && Format[1] == '\0';
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for creating an empty packed population, with all genes and padding bits cleared.	 */
+PackedPopulation *NewPacked(Py_ssize_t Rows, Py_ssize_t Genes){
+
+	PackedPopulation *Packed;
+
+	Packed = PyObject_New(PackedPopulation, &PackedPopulationType);
+	if (Packed == NULL) {
+		return NULL;
+	}
+	Packed->Rows = Rows;
+	Packed->Genes = Genes;
+	Packed->Words = (Genes + 63) / 64;
+	Packed->Shape[0] = Rows;
+	Packed->Shape[1] = Packed->Words;
+	Packed->Strides[0] = sizeof(uint64_t) * Packed->Words;
+	Packed->Strides[1] = sizeof(uint64_t);
+	Packed->Genomes = (uint64_t*)PyMem_Calloc(Rows * Packed->Words + 1, sizeof(uint64_t));
+	if (Packed->Genomes == NULL) {
+		Py_DECREF(Packed);
+		return (PackedPopulation*)PyErr_NoMemory();
+	}
+	return Packed;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for copying one individual between two populations of the same kind.				 */
+void CopyRow(const Population *From, Py_ssize_t FromRow, Population *To, Py_ssize_t ToRow){
+
+	const BoolMatrix *Source = &From->Bool;
+	BoolMatrix *Target = &To->Bool;
+	Py_ssize_t gene;
+
+	if (From->Packed != NULL) {
+		memcpy(To->Packed->Genomes + ToRow * To->Packed->Words, From->Packed->Genomes + FromRow * From->Packed->Words,
+			sizeof(uint64_t) * From->Packed->Words);
+	}
+	else if (Source->GeneStride == 1) {
+		memcpy(Target->Data + ToRow * Target->RowStride, Source->Data + FromRow * Source->RowStride, From->Genes);
+	}
+	else {
+		for (gene = 0; gene < From->Genes; gene++) {
+			Target->Data[ToRow * Target->RowStride + gene] = Source->Data[FromRow * Source->RowStride + gene * Source->GeneStride];
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for holding NoSurvivors tournaments of k unique contenders among the non-elite rows. */
+/* The row of each winner is stored in Winners, and ties go to the first contender drawn. The	 */
+/* caller allocates ContenderList, with room for k rows, as this runs without the GIL.			 */
+void TourSel(int k, const double *Fitness, Py_ssize_t FitnessStride, Py_ssize_t m, int NoSurvivors, int Eliterows, uint64_t *Rng, Py_ssize_t *ContenderList, Py_ssize_t *Winners, double *SurvivorFitness){
+
+	int Tournament, Contender, row;
+	Py_ssize_t ContenderIndex, WinnerIndex;
+	double ContenderFitness, Winner;
+	bool AlreadyInTour;
+
+	for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+		Contender = 0;
+		WinnerIndex = 0;
+		Winner = 0;
+		while (Contender < k) {
+			/* Draw a contender, and keep it if it is not already in the tournament.			 */
+			ContenderIndex = Eliterows + RandBelow(Rng, (unsigned int)(m - Eliterows));
+			AlreadyInTour = false;
+			for (row = 0; row < Contender; row++) {
+				if (ContenderIndex == ContenderList[row]) {
+					AlreadyInTour = true;
+				}
+			}
+			if (AlreadyInTour) {
+				continue;
+			}
+			ContenderList[Contender] = ContenderIndex;
+
+			/* Find winner of the tournament. A contender beats a winner whose fitness is NaN,	 */
+			/* so NaN is treated as the worst fitness, as in TournamentSelection.				 */
+			ContenderFitness = *(const double*)((const char*)Fitness + ContenderIndex * FitnessStride);
+			if (Contender == 0 || ContenderFitness > Winner || Winner != Winner) {
+				Winner = ContenderFitness;
+				WinnerIndex = ContenderIndex;
+			}
+			Contender++;
+		}
+		Winners[Tournament] = WinnerIndex;
+		SurvivorFitness[Tournament] = Winner;
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for randomly picking two different parents.											 */
+void DrawParents(uint64_t *Rng, Py_ssize_t m, Py_ssize_t *P1, Py_ssize_t *P2){
+	*P1 = RandBelow(Rng, (unsigned int)m);
+	*P2 = RandBelow(Rng, (unsigned int)m);
+	while (*P1 == *P2) {
+		*P2 = RandBelow(Rng, (unsigned int)m);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for picking N unique crossover points between 1 and n-1, sorted in increasing		 */
+/* order. Point p means that a new segment starts at gene p.									 */
+void DrawCrossoverPoints(uint64_t *Rng, Py_ssize_t n, int N, int *CrossOverPoints){
+
+	int i, j, CandidatePoint;
+	bool AlreadyChosen;
+
+	i = 0;
+	while (i < N) {
+		CandidatePoint = 1 + (int)RandBelow(Rng, (unsigned int)n - 1);
+		AlreadyChosen = false;
+		for (j = 0; j < i; j++) {
+			if (CandidatePoint == CrossOverPoints[j]) {
+				AlreadyChosen = true;
+			}
+		}
+		if (AlreadyChosen == false) {
+			CrossOverPoints[i] = CandidatePoint;
+			i += 1;
+		}
+	}
+	qsort(CrossOverPoints, N, sizeof(int), cmpfunc);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for making a pair of children, where the first child takes the genes set in Mask	 */
+/* from parent 2 and the other genes from parent 1, and the second child the other way round.	 */
+/* The second child is left out if Child is the last row of the children.						 */
+void CrossPair(const Population *Parents, Py_ssize_t P1, Py_ssize_t P2, const uint64_t *Mask, Population *Children, Py_ssize_t Child){
+
+	const BoolMatrix *Source = &Parents->Bool;
+	BoolMatrix *Target = &Children->Bool;
+	bool Second = Child + 1 < Children->Rows, FromP2;
+	const uint64_t *G1, *G2;
+	uint64_t *C1, *C2;
+	Py_ssize_t word, gene, Words;
+	char Gene1, Gene2;
+
+	if (Parents->Packed != NULL) {
+		Words = Parents->Packed->Words;
+		G1 = Parents->Packed->Genomes + P1 * Words;
+		G2 = Parents->Packed->Genomes + P2 * Words;
+		C1 = Children->Packed->Genomes + Child * Words;
+		C2 = C1 + Words;
+		for (word = 0; word < Words; word++) {
+			C1[word] = G1[word] ^ ((G1[word] ^ G2[word]) & Mask[word]);
+			if (Second) {
+				C2[word] = G2[word] ^ ((G1[word] ^ G2[word]) & Mask[word]);
+			}
+		}
+		return;
+	}
+
+	for (gene = 0; gene < Parents->Genes; gene++) {
+		FromP2 = (Mask[gene / 64] >> (gene % 64)) & 1;
+		Gene1 = Source->Data[P1 * Source->RowStride + gene * Source->GeneStride];
+		Gene2 = Source->Data[P2 * Source->RowStride + gene * Source->GeneStride];
+		Target->Data[Child * Target->RowStride + gene] = FromP2 ? Gene2 : Gene1;
+		if (Second) {
+			Target->Data[(Child + 1) * Target->RowStride + gene] = FromP2 ? Gene1 : Gene2;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for flipping every gene of the rows after the first ElitismNo with probability Pm.	 */
+/* The number of genes skipped before the next flip is geometrically distributed, so no random	 */
+/* number is drawn per gene. The genes are counted row by row over the whole population.		 */
+void Mutate(Population *Pop, double Pm, Py_ssize_t ElitismNo, uint64_t *Rng){
+
+	BoolMatrix *Bool = &Pop->Bool;
+	double LogQ = Pm > 0 && Pm < 1 ? log1p(-Pm) : 0;
+	uint64_t NextFlip, End;
+	Py_ssize_t row, gene;
+	char *Gene;
+
+	if (Pm <= 0 || ElitismNo >= Pop->Rows) {
+		return;
+	}
+	NextFlip = (uint64_t)ElitismNo * Pop->Genes;
+	End = (uint64_t)Pop->Rows * Pop->Genes;
+	if (Pm < 1) {
+		NextFlip += DrawSkip(Rng, LogQ, End);
+	}
+
+	while (NextFlip < End) {
+		row  = (Py_ssize_t)(NextFlip / Pop->Genes);
+		gene = (Py_ssize_t)(NextFlip % Pop->Genes);
+		if (Pop->Packed != NULL) {
+			Pop->Packed->Genomes[row * Pop->Packed->Words + gene / 64] ^= (uint64_t)1 << (gene % 64);
+		}
+		else {
+			Gene = Bool->Data + row * Bool->RowStride + gene * Bool->GeneStride;
+			*Gene = !*Gene;
+		}
+		if (Pm < 1) {
+			NextFlip += 1 + DrawSkip(Rng, LogQ, End);
+		}
+		else {
+			NextFlip++;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing the number of genes skipped before the next flip, capped at the			 */
+/* number of genes of the population so that it fits in 64 bits however small Pm is.			 */
+uint64_t DrawSkip(uint64_t *Rng, double LogQ, uint64_t Genes){
+	double Skip = floor(log(RandUnit(Rng)) / LogQ);
+	return Skip < (double)Genes ? (uint64_t)Skip : Genes;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for setting the bits Start to End-1 of a mask.										 */
+void SetBitRange(uint64_t *Mask, size_t Start, size_t End){
+	size_t word;
+	uint64_t Bits;
+	for (word = Start / 64; word * 64 < End; word++) {
+		Bits = ~(uint64_t)0;
+		if (word == Start / 64) {
+			Bits &= ~(uint64_t)0 << (Start % 64);
+		}
+		if (word == (End - 1) / 64 && End % 64 != 0) {
+			Bits &= ((uint64_t)1 << (End % 64)) - 1;
+		}
+		Mask[word] |= Bits;
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort vector.														 */
+int cmpfunc(const void * a, const void * b){
+	return (*(int*)a - *(int*)b);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Functions for the xoshiro256** random number generator, seeded through splitmix64.			 */
+uint64_t RngNext(uint64_t *s){
+	uint64_t Result = s[1] * 5;
+	uint64_t t = s[1] << 17;
+	Result = ((Result << 7) | (Result >> 57)) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return Result;
+}
+
+void RngSeed(uint64_t *s, uint64_t Seed){
+	int i;
+	uint64_t z;
+	for (i = 0; i < 4; i++) {
+		Seed += 0x9E3779B97F4A7C15ULL;
+		z = Seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s[i] = z ^ (z >> 31);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer in the range 0 to Range-1.								 */
+unsigned int RandBelow(uint64_t *s, unsigned int Range){
+	return (unsigned int)(((RngNext(s) >> 32) * Range) >> 32);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random number in the range (0,1].										 */
+double RandUnit(uint64_t *s){
+	return ((RngNext(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
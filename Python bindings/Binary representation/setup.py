@@ -0,0 +1,15 @@
+# Build script of the GeneticOperators Python extension module, see GeneticOperators.c.
+#
+# Compile and install with:
+# $ pip install "Python bindings/Binary representation"
+from setuptools import setup, Extension
+
+setup(
+    name="GeneticOperators",
+    version="1.0",
+    description="Genetic operators on NumPy arrays and packed populations.",
+    author="Petter Stefansson",
+    author_email="petter.stefansson@nmbu.no",
+    ext_modules=[Extension("GeneticOperators", ["GeneticOperators.c"])],
+    install_requires=["numpy"],
+)
@@ -0,0 +1,264 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Batched N-point crossover operator.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which performs N-point crossover, as in NpointCrossover, on R independent
+runs of a genetic algorithm in one call. The parent pools of the runs are stacked along the third
+dimension, and the runs are handed out dynamically to the threads of an OpenMP team (compile with
+OpenMP enabled, see below). Many small replicates, e.g. for tuning the parameters of the
+algorithm, then pay the call overhead of Matlab once per generation instead of once per run, and
+fill all cores even when each run has only a few hundred individuals.
+
+Each child is made from two randomly picked parents of its own run, with its N crossover points
+drawn without repetition, and takes every other segment from each parent starting with the first.
+Each run draws its random numbers from a generator of its own (xoshiro256**), seeded through
+splitmix64 from Seed and the run r = 0..R-1, so the children of a run depend only on Seed and r and
+not on the number of threads or on the other runs. See BatchTournamentSelection for how to pick the
+seeds of a loop.
+
+The function takes 4 inputs:
+* Input 1: a [m x n x R] Parentpool array of logical values, with one individual per row and one
+parent pool per run. A [m x n] matrix is a single run.
+* Input 2: a [1 x 1] scalar, or a vector with one element per run, 'N' specifying how many
+crossover points should be used. N ∈ [1,size(Parentpool,2)]
+* Input 3: a [1 x 1] scalar 'my' specifying how many new individuals should be generated in
+every run.
+* Input 4: (optional) a [1 x 1] scalar 'Seed' of the random number generators of the runs.
+Defaults to the number of clock cycles since start.
+
+The function outputs 1 variable:
+* Output 1: a [my x n x R] array containing the generated children of each run.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64 with OpenMP enabled
+>> mex COMPFLAGS="$COMPFLAGS /openmp" BatchNpointCrossover.c
+>> mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" BatchNpointCrossover.c
+
+% Run from Matlab when compiled, here 100 runs with 1 to 4 crossover points:
+>> R = 100;
+>> Parentpool = logical(randi([0 1], 100, 256, R));
+>> N = randi([1 4], R, 1);
+
+>> [ Children ] = BatchNpointCrossover( Parentpool, N, 200, 101 );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-17 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used as default seed.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#include <stddef.h> // Needed for ptrdiff_t.
+
+/* Typed data access of the R2018a API when compiled with mex -R2018a, else the legacy API.		 */
+#if MX_HAS_INTERLEAVED_COMPLEX
+#define GetDoubles(Array) mxGetDoubles(Array)
+#else
+#define GetDoubles(Array) mxGetPr(Array)
+#endif
+
+/* New outputs are not zero-filled, except under Octave where older versions lack the function.	 */
+#ifdef HAVE_OCTAVE
+#define CreateUninitArray(ndim, dims, Class) mxCreateNumericArray(ndim, dims, Class, mxREAL)
+#else
+#define CreateUninitArray(ndim, dims, Class) mxCreateUninitNumericArray(ndim, dims, Class, mxREAL)
+#endif
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void BatchNpointCross(const bool *Parentpool, size_t m, size_t n, size_t R, const double *N, size_t NStride, int my, uint64_t Seed, bool *Children);
+
+void NpointCrossRun(const bool *Parentpool, size_t m, size_t n, int N, int my, uint64_t *Rng, bool *Children);
+
+int cmpfunc(const void * a, const void * b);
+
+size_t RunStride(const mxArray *Array, size_t R, const char *Message);
+
+uint64_t RngNext(uint64_t *s);
+
+void RngSeed(uint64_t *s, uint64_t Seed);
+
+uint64_t RunSeed(uint64_t Seed, uint64_t Run);
+
+unsigned int RandBelow(uint64_t *s, unsigned int Range);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const bool *Parentpool;
+	const double *N;
+	const mwSize *Dims;
+	int my;
+	uint64_t Seed;
+
+	bool *Children;
+
+	size_t m, n, R, run, NStride;
+	mwSize OutDims[3];
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 3 || !mxIsLogical(prhs[0]) || mxGetNumberOfDimensions(prhs[0]) > 3) {
+		mexErrMsgIdAndTxt("MATLAB:BatchNpointCrossover:invalidinputs", "Error: Inputs must be a logical [m x n x R] Parentpool, N and my!");
+	}
+	Parentpool = mxGetLogicals(prhs[0]);      // Input 1 (Parentpool)
+	my         = (int)mxGetScalar(prhs[2]);   // Input 3 (my)
+	Seed       = nrhs > 3 ? (uint64_t)mxGetScalar(prhs[3]) : (uint64_t)clock(); // Input 4 (Seed)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	Dims = mxGetDimensions(prhs[0]);
+	m = Dims[0];                              // Number of rows in each parent pool.
+	n = Dims[1];                              // Number of columns in each parent pool.
+	R = mxGetNumberOfDimensions(prhs[0]) > 2 ? Dims[2] : 1; // Number of runs.
+
+	NStride = RunStride(prhs[1], R, "Error: N must be a real double scalar or a vector with one element per run!");
+	N       = GetDoubles(prhs[1]);            // Input 2 (N)
+
+	/* The checks are made for every run before any of them starts, as the runs cannot stop the	 */
+	/* call with an error once they are spread over the threads.								 */
+	if (m < 2 || my < 0) {
+		mexErrMsgIdAndTxt("MATLAB:BatchNpointCrossover:invalidinputs", "Error: Parentpool must hold at least 2 parents per run, and my must not be negative!");
+	}
+	for (run = 0; run < R; run++) {
+		if (!(N[run * NStride] >= 1) || N[run * NStride] > (double)n) {
+			mexErrMsgIdAndTxt("MATLAB:BatchNpointCrossover:invalidinputs", "Error: Crossover points (N) must be between 1 and the number of genes, in every run!");
+		}
+	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	OutDims[0] = my;
+	OutDims[1] = n;
+	OutDims[2] = R;
+	plhs[0] = CreateUninitArray(3, OutDims, mxLOGICAL_CLASS);
+	Children = mxGetLogicals(plhs[0]);
+
+	/* —————————————————————————————————— N-point crossover ———————————————————————————————————— */
+	BatchNpointCross(Parentpool, m, n, R, N, NStride, my, Seed, Children);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for performing N-point crossover on R runs stacked along the third dimension. The	 */
+/* runs are handed out one at a time to the OpenMP threads, each with a generator of its own.	 */
+void BatchNpointCross(const bool *Parentpool, size_t m, size_t n, size_t R, const double *N, size_t NStride, int my, uint64_t Seed, bool *Children){
+
+	ptrdiff_t run;
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (run = 0; run < (ptrdiff_t)R; run++) {
+		uint64_t Rng[4];
+		RngSeed(Rng, RunSeed(Seed, (uint64_t)run));
+		NpointCrossRun(Parentpool + run * m * n, m, n, (int)N[run * NStride], my, Rng, Children + run * my * n);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for performing N-point crossover of randomly picked pairs of parents of one run.	 */
+void NpointCrossRun(const bool *Parentpool, size_t m, size_t n, int N, int my, uint64_t *Rng, bool *Children){
+
+	int *CrossOverPoints;
+	int i, j, e, child, P1, P2, CandidatePoint;
+	size_t gene;
+	bool AlreadyChosen;
+
+	CrossOverPoints = (int*)malloc(sizeof(int) * N);
+
+	for (child = 0; child < my; child++) {
+		/* ————————————————————————————————————————————————————————————————————————————————————— */
+		/* Randomly pick two different parents.													 */
+		P1 = (int)RandBelow(Rng, (unsigned int)m);
+		P2 = (int)RandBelow(Rng, (unsigned int)m - 1);
+		if (P2 >= P1) {
+			P2++;
+		}
+		/* ————————————————————————————————————————————————————————————————————————————————————— */
+		/* Pick N number of crossover points, drawing again those already chosen.				 */
+		i = 0;
+		while (i < N) {
+			CandidatePoint = (int)RandBelow(Rng, (unsigned int)n);
+			AlreadyChosen = false;
+			for (j = 0; j < i; j++) {
+				if (CandidatePoint == CrossOverPoints[j]) {
+					AlreadyChosen = true;
+				}
+			}
+			if (AlreadyChosen == false) {
+				CrossOverPoints[i] = CandidatePoint;
+				i++;
+			}
+		}
+		/* Sort CrossOverPoints from smallest to largest using quicksort.						 */
+		qsort(CrossOverPoints, N, sizeof(int), cmpfunc);
+
+		/* ————————————————————————————————————————————————————————————————————————————————————— */
+		/* Perform crossover while alternating which of the N segments comes from which parent.	 */
+		e = 0;
+		for (gene = 0; gene < n; gene++) {
+			if (e < N && (int)gene > CrossOverPoints[e]) {
+				e++;
+			}
+			Children[child + gene * my] = Parentpool[((e % 2) == 0 ? P1 : P2) + gene * m];
+		}
+	}
+
+	free(CrossOverPoints);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort vector.														 */
+int cmpfunc(const void * a, const void * b){
+	return (*(int*)a - *(int*)b);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking that a per-run parameter is a real double scalar, shared by all runs,	 */
+/* or a vector with one element per run. Returns the step between the elements of consecutive	 */
+/* runs.																						 */
+size_t RunStride(const mxArray *Array, size_t R, const char *Message){
+	if (!mxIsDouble(Array) || mxIsComplex(Array) || (mxGetNumberOfElements(Array) != 1 && mxGetNumberOfElements(Array) != R)) {
+		mexErrMsgIdAndTxt("MATLAB:BatchNpointCrossover:invalidinputs", Message);
+	}
+	return mxGetNumberOfElements(Array) == 1 ? 0 : 1;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Random number generator (xoshiro256**), one per run so that the runs do not share the state	 */
+/* of rand(). Seeded through splitmix64.														 */
+uint64_t RngNext(uint64_t *s){
+	uint64_t Result = s[1] * 5;
+	uint64_t t = s[1] << 17;
+	Result = ((Result << 7) | (Result >> 57)) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return Result;
+}
+
+void RngSeed(uint64_t *s, uint64_t Seed){
+	int i;
+	uint64_t z;
+	for (i = 0; i < 4; i++) {
+		Seed += 0x9E3779B97F4A7C15ULL;
+		z = Seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s[i] = z ^ (z >> 31);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for deriving the seed of a run. Seed is hashed with splitmix64, and the runs of the	 */
+/* call take consecutive blocks of 4 from the splitmix64 sequence after the hash, one per state	 */
+/* word, so the streams of two calls only meet if their hashed seeds happen to be close. Unlike	 */
+/* Seed + r, nearby seeds then give unrelated runs.												 */
+uint64_t RunSeed(uint64_t Seed, uint64_t Run){
+	uint64_t z = Seed;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (z ^ (z >> 31)) + Run * 4 * 0x9E3779B97F4A7C15ULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer in the range 0 to Range-1.								 */
+unsigned int RandBelow(uint64_t *s, unsigned int Range){
+	return (unsigned int)(((RngNext(s) >> 32) * Range) >> 32);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,194 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Lazy N-point crossover operator.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which performs the same N-point crossover as NpointCrossover, followed by an
+optional bitflip mutation as in BitflipMutation, but does not copy any genes. Each child is instead
+recorded by the rows of its two parents, its N crossover points and the list of genes flipped by
+the mutation, which takes O(N) memory per child rather than O(n).
+
+The genes of the children are only produced when needed: MaterializeOffspring returns the children
+as a boolean matrix (or only some of them), and EvaluatePopulation can evaluate its built-in fitness
+functions directly on the lazy children. This saves the copying of every child that is rejected
+before full evaluation, e.g. by a surrogate model screening the offspring on their parents.
+
+Child i takes genes 1 to CrossOverPoints(i,1) from parent Parents(i,1), genes CrossOverPoints(i,1)+1
+to CrossOverPoints(i,2) from parent Parents(i,2), and so on alternating between the two parents.
+
+For reference, see p. 53 A.  Eiben and J.  Smith, Introduction to evolutionary computing.
+New York: Springer, 2003.
+
+The function takes 4 inputs:
+* Input 1: a [m x n] Parentpool matrix of logical values, with one individual per row.
+* Input 2: a [1 x 1] scalar 'N' specifying how many crossover points should be used. N ∈ [1,n-1]
+* Input 3: a [1 x 1] scalar 'my' specifying how many new individuals should be generated.
+* Input 4: (optional) a [1 x 1] scalar 'Pm' specifying a mutation probability between 0 and 1.
+
+The function outputs 1 variable:
+* Output 1: a struct 'Offspring' describing the children, with the fields:
+	Parents         - [my x 2] rows in Parentpool of the two parents of each child.
+	CrossOverPoints - [my x N] sorted crossover points of each child, in the range 1 to n-1.
+	Flips           - [F x 2] child and gene of each mutated gene, sorted by child.
+	Genes           - [1 x 1] number of genes n.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex LazyNpointCrossover.c
+
+% Run from Matlab when compiled:
+>> Parentpool = logical(randi([0 1],10000, 256));
+>> [ Offspring ] = LazyNpointCrossover( Parentpool, 2, 5000, 1/256 );
+>> Keep = find( MySurrogate( Parentpool(Offspring.Parents(:,1),:) ) > Threshold );
+>> [ Children ] = MaterializeOffspring( Parentpool, Offspring, Keep );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used to set seed for rand().
+#include <math.h>   // Needed for log() and log1p() in the skip sampling of the mutation.
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+int randr(unsigned int min, unsigned int max);
+
+int cmpfunc(const void * a, const void * b);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.		 */
+	srand(clock());
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const char *FieldNames[] = { "Parents", "CrossOverPoints", "Flips", "Genes" };
+	int N, my;
+	double Pm, LogQ, RandNr, Skip;
+
+	double *ParentsOut, *PointsOut, *FlipsOut;
+	int *CrossOverPoints, *FlipList;
+	size_t m, n, NoFlips, FlipCapacity, gene, f;
+	int child, i, j, P1, P2, CandidatePoint;
+	bool AlreadyChosen;
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 3 || !mxIsLogical(prhs[0])) {
+		mexErrMsgIdAndTxt("MATLAB:LazyNpointCrossover:invalidinputs", "Error: Inputs must be a logical Parentpool, N and my!");
+	}
+	N  = (int)mxGetScalar(prhs[1]);           // Input 2 (N)
+	my = (int)mxGetScalar(prhs[2]);           // Input 3 (my)
+	Pm = nrhs > 3 ? mxGetScalar(prhs[3]) : 0; // Input 4 (Pm)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[0]);                      // Number of rows in Parentpool.
+	n = mxGetN(prhs[0]);                      // Number of columns in Parentpool.
+
+	if (N <= 0 || N > (int)n - 1) {
+		mexErrMsgIdAndTxt("MATLAB:LazyNpointCrossover:invalidinputs", "Error: Crossover points (N) must be between 1 and the number of genes minus 1!");
+	}
+	if (m < 2 || my < 0) {
+		mexErrMsgIdAndTxt("MATLAB:LazyNpointCrossover:invalidinputs", "Error: Parentpool must have at least 2 rows and my must not be negative!");
+	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	plhs[0] = mxCreateStructMatrix(1, 1, 4, FieldNames);
+	mxSetField(plhs[0], 0, "Parents", mxCreateDoubleMatrix(my, 2, mxREAL));
+	mxSetField(plhs[0], 0, "CrossOverPoints", mxCreateDoubleMatrix(my, N, mxREAL));
+	mxSetField(plhs[0], 0, "Genes", mxCreateDoubleScalar((double)n));
+	ParentsOut = mxGetPr(mxGetField(plhs[0], 0, "Parents"));
+	PointsOut  = mxGetPr(mxGetField(plhs[0], 0, "CrossOverPoints"));
+
+	/* —————————————————————————————— Lazy N-point crossover ——————————————————————————————————— */
+	CrossOverPoints = (int*)malloc(sizeof(int) * N);
+	FlipCapacity = 1024;
+	FlipList = (int*)malloc(sizeof(int) * 2 * FlipCapacity);
+	NoFlips = 0;
+	LogQ = Pm > 0 && Pm < 1 ? log1p(-Pm) : 0;
+
+	for (child = 0; child < my; child++) {
+		/* Randomly pick two different parents.													 */
+		P1 = randr(0, (unsigned int)m - 1);
+		P2 = randr(0, (unsigned int)m - 1);
+		while (P1 == P2) {
+			P2 = randr(0, (unsigned int)m - 1);
+		}
+		ParentsOut[child]      = P1 + 1;
+		ParentsOut[child + my] = P2 + 1;
+
+		/* Pick N unique crossover points, each the last gene before a change of parent.		 */
+		i = 0;
+		while (i < N) {
+			CandidatePoint = randr(1, (unsigned int)n - 1);
+			AlreadyChosen = false;
+			for (j = 0; j < i; j++) {
+				if (CandidatePoint == CrossOverPoints[j]) {
+					AlreadyChosen = true;
+				}
+			}
+			if (AlreadyChosen == false) {
+				CrossOverPoints[i] = CandidatePoint;
+				i += 1;
+			}
+		}
+		qsort(CrossOverPoints, N, sizeof(int), cmpfunc);
+		for (i = 0; i < N; i++) {
+			PointsOut[child + (size_t)my * i] = CrossOverPoints[i];
+		}
+
+		/* Record the genes flipped by the mutation. The number of genes skipped before the		 */
+		/* next flip is geometrically distributed, so no random number is drawn per gene. The	 */
+		/* skip is clamped to n before the cast, as it overflows size_t for tiny Pm.			 */
+		if (Pm <= 0) {
+			continue;
+		}
+		gene = 0;
+		if (Pm < 1) {
+			RandNr = ((double)rand() + 1.0) / ((double)RAND_MAX + 1.0);
+			Skip = floor(log(RandNr) / LogQ);
+			gene = Skip < (double)n ? (size_t)Skip : n;
+		}
+		while (gene < n) {
+			if (NoFlips == FlipCapacity) {
+				FlipCapacity *= 2;
+				FlipList = (int*)realloc(FlipList, sizeof(int) * 2 * FlipCapacity);
+			}
+			FlipList[2 * NoFlips]     = child + 1;
+			FlipList[2 * NoFlips + 1] = (int)gene + 1;
+			NoFlips++;
+			if (Pm < 1) {
+				RandNr = ((double)rand() + 1.0) / ((double)RAND_MAX + 1.0);
+				Skip = floor(log(RandNr) / LogQ);
+				gene += 1 + (Skip < (double)n ? (size_t)Skip : n);
+			}
+			else {
+				gene++;
+			}
+		}
+	}
+
+	mxSetField(plhs[0], 0, "Flips", mxCreateDoubleMatrix(NoFlips, 2, mxREAL));
+	FlipsOut = mxGetPr(mxGetField(plhs[0], 0, "Flips"));
+	for (f = 0; f < NoFlips; f++) {
+		FlipsOut[f]           = FlipList[2 * f];
+		FlipsOut[f + NoFlips] = FlipList[2 * f + 1];
+	}
+
+	free(CrossOverPoints);
+	free(FlipList);
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer that lies within range.								 */
+int randr(unsigned int min, unsigned int max) {
+	return min + rand() / (RAND_MAX / (max - min + 1) + 1);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort vector.														 */
+int cmpfunc(const void * a, const void * b){
+	return (*(int*)a - *(int*)b);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,150 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Materialisation of lazy offspring.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which produces the genes of children recorded by LazyNpointCrossover, i.e.
+by the rows of their two parents, their crossover points and the genes flipped by the mutation.
+Only the requested children are produced, so children that are rejected before evaluation never
+have their genes copied.
+
+Each child is built by copying its genes segment by segment from alternating parents, after which
+its mutated genes are flipped. The flips are sorted by child, so the flips of each child are found
+by a binary search in the flip list.
+
+The function takes 3 inputs:
+* Input 1: a [m x n] Parentpool matrix of logical values, the one given to LazyNpointCrossover.
+* Input 2: a struct 'Offspring' as returned by LazyNpointCrossover.
+* Input 3: (optional) a [r x 1] vector 'Rows' of the children to produce. Defaults to all children.
+
+The function outputs 1 variable:
+* Output 1: a [r x n] matrix containing the children, in the order given by Rows.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex MaterializeOffspring.c
+
+% Run from Matlab when compiled:
+>> Parentpool = logical(randi([0 1],10000, 256));
+>> [ Offspring ] = LazyNpointCrossover( Parentpool, 2, 5000, 1/256 );
+>> [ Children ] = MaterializeOffspring( Parentpool, Offspring, 1:100 );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+const double *GetOffspringField(const mxArray *Offspring, const char *Name, size_t Rows, size_t Columns);
+
+size_t FirstFlip(const double *Flips, size_t NoFlips, double Child);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const bool *Parentpool;
+	const mxArray *Offspring, *Field;
+	const double *Parents, *Points, *Flips, *Rows;
+
+	bool *Children;
+	size_t m, n, my, N, r, NoFlips, row, child, Start, End, gene, f, Parent, Gene;
+	int Point;
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 2 || !mxIsLogical(prhs[0]) || !mxIsStruct(prhs[1])) {
+		mexErrMsgIdAndTxt("MATLAB:MaterializeOffspring:invalidinputs", "Error: Inputs must be a logical Parentpool and an Offspring struct from LazyNpointCrossover!");
+	}
+	Parentpool = mxGetLogicals(prhs[0]);      // Input 1 (Parentpool)
+	Offspring  = prhs[1];                     // Input 2 (Offspring)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[0]);                      // Number of rows in Parentpool.
+	n = mxGetN(prhs[0]);                      // Number of columns in Parentpool.
+
+	Field = mxGetField(Offspring, 0, "Genes");
+	if (Field == NULL || mxGetScalar(Field) != (double)n || mxGetField(Offspring, 0, "CrossOverPoints") == NULL) {
+		mexErrMsgIdAndTxt("MATLAB:MaterializeOffspring:invalidinputs", "Error: Offspring was not created from a Parentpool with this number of genes!");
+	}
+	Field = mxGetField(Offspring, 0, "CrossOverPoints");
+	my = mxGetM(Field);                       // Number of lazy children.
+	N  = mxGetN(Field);                       // Number of crossover points per child.
+	Points  = GetOffspringField(Offspring, "CrossOverPoints", my, N);
+	Parents = GetOffspringField(Offspring, "Parents", my, 2);
+	Field   = mxGetField(Offspring, 0, "Flips");
+	NoFlips = Field != NULL ? mxGetM(Field) : 0;
+	Flips   = NoFlips > 0 ? GetOffspringField(Offspring, "Flips", NoFlips, 2) : NULL;
+
+	if (nrhs > 2) {
+		Rows = mxGetPr(prhs[2]);              // Input 3 (Rows)
+		r = mxGetNumberOfElements(prhs[2]);
+	}
+	else {
+		Rows = NULL;
+		r = my;
+	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	plhs[0] = mxCreateLogicalMatrix(r, n);
+	Children = mxGetLogicals(plhs[0]);
+
+	/* ———————————————————————————————— Materialise the children ——————————————————————————————— */
+	for (row = 0; row < r; row++) {
+		child = Rows != NULL ? (size_t)Rows[row] - 1 : row;
+		if (Rows != NULL && (Rows[row] < 1 || child >= my)) {
+			mexErrMsgIdAndTxt("MATLAB:MaterializeOffspring:invalidinputs", "Error: Rows must be between 1 and the number of children!");
+		}
+
+		/* Copy segment by segment, alternating between the parents.							 */
+		Start = 0;
+		for (Point = 0; Point <= (int)N; Point++) {
+			End    = Point < (int)N ? (size_t)Points[child + my * Point] : n;
+			Parent = (size_t)Parents[child + my * (Point % 2)] - 1;
+			if (Parent >= m || End > n || End < Start) {
+				mexErrMsgIdAndTxt("MATLAB:MaterializeOffspring:invalidinputs", "Error: Offspring has parents or crossover points outside Parentpool!");
+			}
+			for (gene = Start; gene < End; gene++) {
+				Children[row + r * gene] = Parentpool[Parent + m * gene];
+			}
+			Start = End;
+		}
+
+		/* Flip the mutated genes of this child.												 */
+		for (f = FirstFlip(Flips, NoFlips, (double)(child + 1)); f < NoFlips && Flips[f] == (double)(child + 1); f++) {
+			Gene = (size_t)Flips[f + NoFlips] - 1;
+			if (Gene < n) {
+				Children[row + r * Gene] = !Children[row + r * Gene];
+			}
+		}
+	}
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for getting a field of the Offspring struct, checking that it has the given size.	 */
+const double *GetOffspringField(const mxArray *Offspring, const char *Name, size_t Rows, size_t Columns){
+	const mxArray *Field = mxGetField(Offspring, 0, Name);
+	if (Field == NULL || !mxIsDouble(Field) || mxGetM(Field) != Rows || mxGetN(Field) != Columns) {
+		mexErrMsgIdAndTxt("MATLAB:MaterializeOffspring:invalidinputs", "Error: Offspring.%s is missing or has the wrong size!", Name);
+	}
+	return mxGetPr(Field);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding the first flip of a child in the flip list, which is sorted by child.	 */
+size_t FirstFlip(const double *Flips, size_t NoFlips, double Child){
+	size_t Low = 0, High = NoFlips, Mid;
+	while (Low < High) {
+		Mid = Low + (High - Low) / 2;
+		if (Flips[Mid] < Child) {
+			Low = Mid + 1;
+		}
+		else {
+			High = Mid;
+		}
+	}
+	return Low;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
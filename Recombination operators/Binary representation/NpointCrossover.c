@@ -12,20 +12,49 @@ The function takes 3 inputs:
 * Input 1: a [m x n] Parentpool matrix of logical values, with one individual per row.
 * Input 2: a [1 x 1] scalar 'N' specifying how many crossover points should be used. N ∈ [1,size(Parentpool,2)]
 * Input 3: a [1 x 1] scalar 'my' specifying how many new individuals should be generated.
+* Input 4: (optional) a preallocated [my x n] logical matrix 'Children', into which the children
+are written in place instead of into a new output. The function then has no outputs.
 
 The function outputs 1 variable:
 * Output 1: a [my x n] matrix containing the generated children.
+* Output 2: (only when compiled with GA_INSTRUMENT) a struct 'Counters' with the number of random
+numbers drawn (RngDraws), of second parents drawn again because they equalled the first
+(ParentRetries), of crossover points drawn again because they were already chosen (PointRetries)
+and of bytes written into the children (BytesCopied), and the wall time of the crossover in
+seconds (CrossoverTime). With a preallocated output it is the only output.
+
+A new output is not zero-filled before the children are written, as it is overwritten completely.
+Writing into a preallocated output saves the allocation as well, which is a noticeable part of
+the run time for small populations. The preallocated matrix must not share its data with another
+variable (e.g. after B = Children), as Matlab would not know that both are changed.
 
 Example on how to compile and run from Matlab:
 % Compile .C to .mexw64
 >> mex NpointCrossover.c
+% or with the typed data API of Matlab R2018a and later
+>> mex -R2018a NpointCrossover.c
+% or with the instrumentation counters
+>> mex -DGA_INSTRUMENT NpointCrossover.c
 
 % Run from Matlab when compiled:
 >> Parentpool = logical(randi([0 1],10000, 256));
 >> N = 2;
 >> my = round(size(Parentpool,1)/2);
 
->> [ Children ] = BitflipMutation( Parentpool , N, my );
+>> [ Children ] = NpointCrossover( Parentpool , N, my );
+
+% Or write into a preallocated output, e.g. once per generation:
+>> Children = false(my, 256);
+>> NpointCrossover( Parentpool , N, my, Children );
+
+Example on how to compile and run from GNU Octave:
+% Compile .C to .mex, or to a native .oct together with the Octave gateway NpointCrossover.cc,
+% which passes the Octave arrays to NpointCross without converting them to and from mxArrays
+>> mkoctfile --mex NpointCrossover.c
+>> mkoctfile -DGA_NO_MEX NpointCrossover.cc NpointCrossover.c
+
+% Run from Octave when compiled, exactly as from Matlab:
+>> [ Children ] = NpointCrossover( Parentpool , N, my );
 
 Example of compatible C compilers:
 * Microsoft Visual C++ 2013 Professional (C)
@@ -36,26 +65,84 @@ Written 2017-09-11 by
 petter.stefansson@nmbu.no
 ———————————————————————————————————————————————————————————————————————————————————————————————— */
 
+#ifndef GA_NO_MEX
 #include <mex.h>	// Needed to communicate with matlab.
+
+/* Typed data access of the R2018a API when compiled with mex -R2018a, else the legacy API.		 */
+#if MX_HAS_INTERLEAVED_COMPLEX
+#define GetDoubles(Array) mxGetDoubles(Array)
+#else
+#define GetDoubles(Array) mxGetPr(Array)
+#endif
+
+/* New outputs are not zero-filled, except under Octave where older versions lack the function.	 */
+#ifdef HAVE_OCTAVE
+#define CreateUninitMatrix(m, n, Class) mxCreateNumericMatrix(m, n, Class, mxREAL)
+#else
+#define CreateUninitMatrix(m, n, Class) mxCreateUninitNumericMatrix(m, n, Class, mxREAL)
+#endif
+#else
+#include <stdlib.h>  // Needed for malloc, rand and qsort when compiled for the native Octave gateway.
+#include <stdbool.h> // Needed for bool when compiled for the native Octave gateway.
+#endif
 #include <time.h>   // Needed for counting CPU clock cycle which is used to set seed for rand().
 
+/* ——————————————————————————————————————— Instrumentation ————————————————————————————————————— */
+/* When compiled with GA_INSTRUMENT defined the operator counts its random numbers, redrawn		 */
+/* parents and crossover points and copied bytes, and times its phases in seconds of wall		 */
+/* time. The counters of the last call are kept in NpointCrossCounters, named by				 */
+/* NpointCrossCounterNames. Without GA_INSTRUMENT the counting compiles to nothing.				 */
+#ifdef GA_INSTRUMENT
+#include <stdio.h>  // Needed for snprintf.
+#include <string.h> // Needed for memset.
+#ifdef _WIN32
+#include <windows.h> // Needed for QueryPerformanceCounter.
+#endif
+enum { RNG_DRAWS, PARENT_RETRIES, POINT_RETRIES, BYTES_COPIED, CROSSOVER_TIME, NPOINTCROSS_NO_COUNTERS };
+const int NpointCrossNoCounters = NPOINTCROSS_NO_COUNTERS;
+const char *NpointCrossCounterNames[NPOINTCROSS_NO_COUNTERS] = { "RngDraws", "ParentRetries", "PointRetries", "BytesCopied", "CrossoverTime" };
+double NpointCrossCounters[NPOINTCROSS_NO_COUNTERS];
+#define COUNT(Counter, Amount) (NpointCrossCounters[Counter] += (double)(Amount))
+#define COUNTERS_OUTPUT 1
+#else
+#define COUNT(Counter, Amount) ((void)0)
+#define COUNTERS_OUTPUT 0
+#endif
+
 /* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void NpointCross(const bool *Parentpool, size_t m, size_t n, int N, int my, bool *Children);
+
 int randr(unsigned int min, unsigned int max);
 
 int cmpfunc(const void * a, const void * b);
 
+#ifdef GA_INSTRUMENT
+double WallTime(void);
+
+int NpointCrossCountersJson(char *Buffer, size_t Size);
+
+#ifndef GA_NO_MEX
+mxArray *CountersStruct(void);
+#endif
+#endif
+
+#ifndef GA_NO_MEX
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n);
+
 /* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 
-	/* Before starting set the seed of the RNG to the number of clock cycles since start.        */
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.		 */
 	srand(clock());
+#ifdef GA_INSTRUMENT
+	memset(NpointCrossCounters, 0, sizeof(NpointCrossCounters));
+#endif
 
 	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
 	const bool *Parentpool;
 	int N, my;
 
 	bool *Children; // add conditional checks against other data types?
-	double RandNr;
 	size_t m, n;
 
 	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
@@ -67,23 +154,58 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 	m = mxGetM(prhs[0]);                      // Number of rows in Parentpool.
 	n = mxGetN(prhs[0]);                      // Number of columns in Parentpool.
 
-	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
-	plhs[0] = mxCreateLogicalMatrix(my, n);
-	Children = mxGetLogicals(plhs[0]);
-
+	if (Parentpool == NULL || m < 2 || my < 0) {
+		mexErrMsgIdAndTxt("MATLAB:NpointCrossover:invalidinputs", "Error: Parentpool must be a logical matrix of at least 2 parents, and my must not be negative!");
+	}
 	if (N > n) {
 		mexErrMsgIdAndTxt("MATLAB:NpointCrossover:invalidinputs", "Error: Crossover points (N) must be lower than number of genes!");
 	}
 	if (N <= 0) {
 		mexErrMsgIdAndTxt("MATLAB:NpointCrossover:invalidinputs", "Error: Crossover points (N) must be greater or equal to 1!");
 	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	if (nrhs > 3) {
+		if (nlhs > COUNTERS_OUTPUT || !IsPreallocated(prhs[3], mxLOGICAL_CLASS, my, n)) {
+			mexErrMsgIdAndTxt("MATLAB:NpointCrossover:invalidinputs", "Error: Preallocated Children must be a [my x n] logical matrix, and nothing is returned!");
+		}
+		Children = mxGetLogicals(prhs[3]);
+	}
+	else {
+		plhs[0] = CreateUninitMatrix(my, n, mxLOGICAL_CLASS);
+		Children = mxGetLogicals(plhs[0]);
+	}
+
 	/* ——————————————————————————————————— N-point crossover ———————————————————————————————————— */
+	NpointCross(Parentpool, m, n, N, my, Children);
+
+#ifdef GA_INSTRUMENT
+	if (nlhs > (nrhs > 3 ? 0 : 1)) {
+		plhs[nrhs > 3 ? 0 : 1] = CountersStruct();
+	}
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking that a preallocated output is a real [m x n] array of the given class.	 */
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n){
+	return mxGetClassID(Array) == Class && !mxIsComplex(Array) && mxGetNumberOfDimensions(Array) == 2
+		&& mxGetM(Array) == m && mxGetN(Array) == n;
+}
+#endif
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for performing N-point crossover of randomly picked pairs of parents.				 */
+void NpointCross(const bool *Parentpool, size_t m, size_t n, int N, int my, bool *Children){
+
 	int *CrossOverPoints;
 	int j, e, childrow, GeneratedChild;
 	int P1, P2, i, CandidatePoint, gene;
 	bool AlreadyChosen;
 	CrossOverPoints = (int*)malloc(sizeof(int)    * N); // [n-by-1]
 
+	COUNT(CROSSOVER_TIME, -WallTime());
+	COUNT(BYTES_COPIED, (double)my * n);
+
 	GeneratedChild = 0;
 	while (GeneratedChild < my){
 		/* ————————————————————————————————————————————————————————————————————————————————————— */
@@ -92,6 +214,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 		P2 = randr(0, m - 1);
 		while (P1 == P2) {
 			P2 = randr(0, m - 1);
+			COUNT(PARENT_RETRIES, 1);
 		}
 		/* ————————————————————————————————————————————————————————————————————————————————————— */
 		/* Pick N number of crossover points.													 */
@@ -109,6 +232,9 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 				CrossOverPoints[i] = CandidatePoint;
 				i += 1;
 			}
+			else {
+				COUNT(POINT_RETRIES, 1);
+			}
 		}
 		/* ————————————————————————————————————————————————————————————————————————————————————— */
 		/* Sort CrossOverPoints from smallest to largest using quicksort.						 */
@@ -119,20 +245,20 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 		e = 0;
 		for (gene = 0; gene < n; gene++) {
 
-			if (gene > CrossOverPoints[e]){
+			if (e < N && gene > CrossOverPoints[e]){
 				e++;
 			}
 
 			/* Alternate between segments which is parent 1 and 2.								 */
 			if ((e % 2) == 0){
 				Children[GeneratedChild + gene*my] = Parentpool[P1 + gene*m];
-				if (GeneratedChild < my){
+				if (GeneratedChild + 1 < my){
 					Children[GeneratedChild+1 + gene*my] = Parentpool[P2 + gene*m];
 				}
 			}
 			else {
 				Children[GeneratedChild + gene*my] = Parentpool[P2 + gene*m];
-				if (GeneratedChild < my) {
+				if (GeneratedChild + 1 < my) {
 					Children[GeneratedChild+1 + gene*my] = Parentpool[P1 + gene*m];
 				}
 			}
@@ -141,11 +267,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 	}
 
 	free(CrossOverPoints);
+	COUNT(CROSSOVER_TIME, WallTime());
 }
 
 /* ————————————————————————————————————————————————————————————————————————————————————————————— */
 /* Function for drawing a random integer that lies within range.								 */
 int randr(unsigned int min, unsigned int max) {
+	COUNT(RNG_DRAWS, 1);
 	return min + rand() / (RAND_MAX / (max - min + 1) + 1);
 }
 /* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -155,4 +283,51 @@ int randr(unsigned int min, unsigned int max) {
 int cmpfunc(const void * a, const void * b){
 	return (*(int*)a - *(int*)b);
 }
-/* ————————————————————————————————————————————————————————————————————————————————————————————— */
\ No newline at end of file
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+#ifdef GA_INSTRUMENT
+/* Function for reading a monotonic wall clock in seconds.										 */
+double WallTime(void){
+#ifdef _WIN32
+	LARGE_INTEGER Count, Frequency;
+	QueryPerformanceCounter(&Count);
+	QueryPerformanceFrequency(&Frequency);
+	return (double)Count.QuadPart / (double)Frequency.QuadPart;
+#else
+	struct timespec Now;
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (double)Now.tv_sec + 1e-9 * (double)Now.tv_nsec;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for writing the counters as a JSON object into a buffer of Size bytes, which like	 */
+/* snprintf returns the length of the full text and truncates it if the buffer is too small.	 */
+int NpointCrossCountersJson(char *Buffer, size_t Size){
+
+	size_t Used = 0;
+	int Counter;
+
+	for (Counter = 0; Counter < NpointCrossNoCounters; Counter++) {
+		Used += snprintf(Used < Size ? Buffer + Used : NULL, Used < Size ? Size - Used : 0, "%s\"%s\": %.17g",
+			Counter == 0 ? "{" : ", ", NpointCrossCounterNames[Counter], NpointCrossCounters[Counter]);
+	}
+	Used += snprintf(Used < Size ? Buffer + Used : NULL, Used < Size ? Size - Used : 0, "}");
+	return (int)Used;
+}
+#ifndef GA_NO_MEX
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for returning the counters to Matlab as a struct with one scalar field per			 */
+/* counter.																						 */
+mxArray *CountersStruct(void){
+
+	mxArray *Counters;
+	int Counter;
+
+	Counters = mxCreateStructMatrix(1, 1, NpointCrossNoCounters, NpointCrossCounterNames);
+	for (Counter = 0; Counter < NpointCrossNoCounters; Counter++) {
+		mxSetFieldByNumber(Counters, 0, Counter, mxCreateDoubleScalar(NpointCrossCounters[Counter]));
+	}
+	return Counters;
+}
+#endif
+#endif
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
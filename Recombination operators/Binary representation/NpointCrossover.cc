@@ -0,0 +1,94 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+N-point crossover operator, native GNU Octave gateway.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is an Octave function (.oct) with the same inputs and outputs as the MEX function in
+NpointCrossover.c, whose NpointCross it calls. Octave passes its own arrays to a MEX function by
+converting them to mxArrays, and converts the outputs back. This gateway instead reads the parent
+pool directly from the Octave array, and NpointCross writes the children directly into the Octave
+output array.
+
+NpointCrossover.c has to be compiled with GA_NO_MEX defined, which leaves out its MEX gateway.
+When both files are compiled with GA_INSTRUMENT defined, a second output holds the counters of
+the call, as a struct with the same fields as in NpointCrossover.c.
+
+Example on how to compile and run from GNU Octave:
+% Compile .CC and .C to .oct
+>> mkoctfile -DGA_NO_MEX NpointCrossover.cc NpointCrossover.c
+% or with the instrumentation counters
+>> mkoctfile -DGA_NO_MEX -DGA_INSTRUMENT NpointCrossover.cc NpointCrossover.c
+
+% Run from Octave when compiled:
+>> [ Children ] = NpointCrossover( rand(10000,256) > 0.5, 2, 5000 );
+
+Example of compatible C++ compilers:
+* GCC 7 and later, with GNU Octave 4.4 and later
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <octave/oct.h> // Needed to communicate with Octave.
+#include <cstdlib>      // Needed for srand().
+#include <ctime>        // Needed for counting CPU clock cycle which is used to set seed for rand().
+#include <cstring>      // Needed for memset.
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+extern "C" void NpointCross(const bool *Parentpool, size_t m, size_t n, int N, int my, bool *Children);
+
+#ifdef GA_INSTRUMENT
+extern "C" const int NpointCrossNoCounters;
+extern "C" const char *NpointCrossCounterNames[];
+extern "C" double NpointCrossCounters[];
+#endif
+
+/* ——————————————————————————————————— Octave gateway start ———————————————————————————————————— */
+DEFUN_DLD(NpointCrossover, args, nargout,
+	"[ Children ] = NpointCrossover( Parentpool, N, my )"){
+
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.        */
+	srand(clock());
+#ifdef GA_INSTRUMENT
+	memset(NpointCrossCounters, 0, sizeof(double) * NpointCrossNoCounters);
+#endif
+
+	if (args.length() != 3 || !args(0).islogical()) {
+		error_with_id("Octave:NpointCrossover:invalidinputs", "Error: Inputs must be a logical Parentpool, N and my!");
+	}
+
+	/* ———————————————————————— Get the input variables without copying ———————————————————————— */
+	const boolNDArray Parentpool = args(0).bool_array_value(); // Input 1 (Parentpool)
+	int N                        = args(1).int_value();        // Input 2 (N)
+	int my                       = args(2).int_value();        // Input 3 (my)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	size_t m = Parentpool.rows();                              // Number of rows in Parentpool.
+	size_t n = Parentpool.columns();                           // Number of columns in Parentpool.
+
+	if (N > (int)n) {
+		error_with_id("Octave:NpointCrossover:invalidinputs", "Error: Crossover points (N) must be lower than number of genes!");
+	}
+	if (N <= 0) {
+		error_with_id("Octave:NpointCrossover:invalidinputs", "Error: Crossover points (N) must be greater or equal to 1!");
+	}
+	if (m < 2 || my < 0) {
+		error_with_id("Octave:NpointCrossover:invalidinputs", "Error: Parentpool must hold at least 2 parents, and my must not be negative!");
+	}
+
+	/* ——————————————————————————————— Specify Octave outputs —————————————————————————————————— */
+	boolMatrix Children(my, n);
+
+	/* ——————————————————————————————————— N-point crossover ———————————————————————————————————— */
+	NpointCross(Parentpool.data(), m, n, N, my, Children.fortran_vec());
+
+	octave_value_list Outputs = ovl(Children);
+#ifdef GA_INSTRUMENT
+	if (nargout > 1) {
+		octave_scalar_map Counters;
+		for (int Counter = 0; Counter < NpointCrossNoCounters; Counter++) {
+			Counters.assign(NpointCrossCounterNames[Counter], NpointCrossCounters[Counter]);
+		}
+		Outputs(1) = Counters;
+	}
+#endif
+	return Outputs;
+}
@@ -0,0 +1,272 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Batched tournament selection operator.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which performs tournament selection, as in TournamentSelection, on R
+independent runs of a genetic algorithm in one call. The populations of the runs are stacked along
+the third dimension, and the runs are handed out dynamically to the threads of an OpenMP team
+(compile with OpenMP enabled, see below). Many small replicates, e.g. for tuning the parameters of
+the algorithm, then pay the call overhead of Matlab once per generation instead of once per run,
+and fill all cores even when each run has only a few hundred individuals.
+
+Each run draws its random numbers from a generator of its own (xoshiro256**), seeded through
+splitmix64 from Seed and the run r = 0..R-1, so the survivors of a run depend only on Seed and r
+and not on the number of threads or on the other runs. Seed is hashed before the runs are added, so
+nearby seeds, e.g. Seed and Seed + 1, give unrelated runs. The generators start again from Seed in
+every call, so a loop over generations should pass a new seed each time, and the batched crossover
+and mutation other seeds, e.g. 3*g, 3*g + 1 and 3*g + 2 in generation g.
+
+The function takes 6 inputs:
+* Input 1: a [1 x 1] scalar, or a vector with one element per run, 'k' specifying how many
+contenders are involved in each tournament.
+* Input 2: a [m x R] matrix 'Fitness' containing the fitness of each individual, higher better,
+with one column per run.
+* Input 3: a [m x n x R] boolean array 'Population' containing the populations of the R runs. A
+[m x n] matrix is a single run.
+* Input 4: a [1 x 1] scalar 'NoSurvivors' specifying the number of survivors after selection, the
+same for every run.
+* Input 5: a [1 x 1] scalar, or a vector with one element per run, 'Eliterows' specifying how many
+rows, starting from the top, should be excluded from the selection process due to elitism.
+* Input 6: (optional) a [1 x 1] scalar 'Seed' of the random number generators of the runs.
+Defaults to the number of clock cycles since start.
+
+The function outputs 2 variables:
+* Output 1: a [NoSurvivors x n x R] boolean array containing the survivors of each run.
+* Output 2: a [NoSurvivors x R] matrix with the fitness of the survivors of each run.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64 with OpenMP enabled
+>> mex COMPFLAGS="$COMPFLAGS /openmp" BatchTournamentSelection.c
+>> mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" BatchTournamentSelection.c
+
+% Run from Matlab when compiled, here 100 runs with k from 2 to 5:
+>> R = 100;
+>> k = randi([2 5], R, 1);
+>> Fitness = rand(200, R);
+>> Population = logical(randi([0 1], 200, 256, R));
+
+>> [ Survivors, SurvivorFitness ] = BatchTournamentSelection( k, Fitness, Population, 100, 2, 1 );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-17 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used as default seed.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#include <stddef.h> // Needed for ptrdiff_t.
+
+/* Typed data access of the R2018a API when compiled with mex -R2018a, else the legacy API.		 */
+#if MX_HAS_INTERLEAVED_COMPLEX
+#define GetDoubles(Array) mxGetDoubles(Array)
+#else
+#define GetDoubles(Array) mxGetPr(Array)
+#endif
+
+/* New outputs are not zero-filled, except under Octave where older versions lack the function.	 */
+#ifdef HAVE_OCTAVE
+#define CreateUninitArray(ndim, dims, Class) mxCreateNumericArray(ndim, dims, Class, mxREAL)
+#else
+#define CreateUninitArray(ndim, dims, Class) mxCreateUninitNumericArray(ndim, dims, Class, mxREAL)
+#endif
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void BatchTourSel(const double *k, size_t kStride, const double *Fitness, const bool *Population, int NoSurvivors, const double *Eliterows, size_t EliteStride, size_t m, size_t n, size_t R, uint64_t Seed, bool *Survivors, double *SurvivorFitness);
+
+void TourSelRun(int k, const double *Fitness, const bool *Population, int NoSurvivors, int Eliterows, size_t m, size_t n, uint64_t *Rng, bool *Survivors, double *SurvivorFitness);
+
+size_t RunStride(const mxArray *Array, size_t R, const char *Message);
+
+uint64_t RngNext(uint64_t *s);
+
+void RngSeed(uint64_t *s, uint64_t Seed);
+
+uint64_t RunSeed(uint64_t Seed, uint64_t Run);
+
+unsigned int RandBelow(uint64_t *s, unsigned int Range);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const double *k, *Fitness, *Eliterows;
+	const bool *Population;
+	const mwSize *Dims;
+	int NoSurvivors;
+	uint64_t Seed;
+
+	double *SurvivorFitness;
+	bool *Survivors;
+
+	size_t m, n, R, run, kStride, EliteStride;
+	mwSize OutDims[3];
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 5 || !mxIsLogical(prhs[2]) || mxGetNumberOfDimensions(prhs[2]) > 3) {
+		mexErrMsgIdAndTxt("MATLAB:BatchTournamentSelection:invalidinputs", "Error: Inputs must be k, Fitness, a logical [m x n x R] Population, NoSurvivors and Eliterows!");
+	}
+	Population  = mxGetLogicals(prhs[2]);     // Input 3 (Population)
+	NoSurvivors = (int)mxGetScalar(prhs[3]);  // Input 4 (Number of survivors)
+	Seed        = nrhs > 5 ? (uint64_t)mxGetScalar(prhs[5]) : (uint64_t)clock(); // Input 6 (Seed)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	Dims = mxGetDimensions(prhs[2]);
+	m = Dims[0];                              // Number of rows in each population.
+	n = Dims[1];                              // Number of columns in each population.
+	R = mxGetNumberOfDimensions(prhs[2]) > 2 ? Dims[2] : 1; // Number of runs.
+
+	Fitness = GetDoubles(prhs[1]);            // Input 2 (Fitness)
+	if (Fitness == NULL || mxIsComplex(prhs[1]) || mxGetM(prhs[1]) != m || mxGetN(prhs[1]) != R) {
+		mexErrMsgIdAndTxt("MATLAB:BatchTournamentSelection:invalidinputs", "Error: Fitness must be a real double [m x R] matrix with one column per run!");
+	}
+	kStride     = RunStride(prhs[0], R, "Error: k must be a real double scalar or a vector with one element per run!");
+	EliteStride = RunStride(prhs[4], R, "Error: Eliterows must be a real double scalar or a vector with one element per run!");
+	k           = GetDoubles(prhs[0]);        // Input 1 (k)
+	Eliterows   = GetDoubles(prhs[4]);        // Input 5 (Number of elitism rows)
+
+	/* The checks are made for every run before any of them starts, as the runs cannot stop the	 */
+	/* call with an error once they are spread over the threads.								 */
+	if (NoSurvivors < 0) {
+		mexErrMsgIdAndTxt("MATLAB:BatchTournamentSelection:invalidinputs", "Error: NoSurvivors must not be negative!");
+	}
+	for (run = 0; run < R; run++) {
+		if (!(k[run * kStride] >= 1) || !(Eliterows[run * EliteStride] >= 0) || Eliterows[run * EliteStride] + k[run * kStride] > (double)m) {
+			mexErrMsgIdAndTxt("MATLAB:BatchTournamentSelection:invalidinputs", "Error: k must be at least 1 and at most the number of rows after Eliterows, in every run!");
+		}
+	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	OutDims[0] = NoSurvivors;
+	OutDims[1] = n;
+	OutDims[2] = R;
+	plhs[0] = CreateUninitArray(3, OutDims, mxLOGICAL_CLASS);
+	Survivors = mxGetLogicals(plhs[0]);
+	OutDims[1] = R;
+	plhs[1] = CreateUninitArray(2, OutDims, mxDOUBLE_CLASS);
+	SurvivorFitness = GetDoubles(plhs[1]);
+
+	/* ——————————————————————————————— Tournament selection ———————————————————————————————————— */
+	BatchTourSel(k, kStride, Fitness, Population, NoSurvivors, Eliterows, EliteStride, m, n, R, Seed, Survivors, SurvivorFitness);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for performing tournament selection on R runs stacked along the third dimension. The */
+/* runs are handed out one at a time to the OpenMP threads, each with a generator of its own.	 */
+void BatchTourSel(const double *k, size_t kStride, const double *Fitness, const bool *Population, int NoSurvivors, const double *Eliterows, size_t EliteStride, size_t m, size_t n, size_t R, uint64_t Seed, bool *Survivors, double *SurvivorFitness){
+
+	ptrdiff_t run;
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (run = 0; run < (ptrdiff_t)R; run++) {
+		uint64_t Rng[4];
+		RngSeed(Rng, RunSeed(Seed, (uint64_t)run));
+		TourSelRun((int)k[run * kStride], Fitness + run * m, Population + run * m * n, NoSurvivors,
+			(int)Eliterows[run * EliteStride], m, n, Rng, Survivors + run * NoSurvivors * n, SurvivorFitness + run * NoSurvivors);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for performing tournament selection on one run, drawing k unique contenders among	 */
+/* the non-elite rows for each tournament from the generator of the run.						 */
+void TourSelRun(int k, const double *Fitness, const bool *Population, int NoSurvivors, int Eliterows, size_t m, size_t n, uint64_t *Rng, bool *Survivors, double *SurvivorFitness){
+
+	int Tournament, Contender, ContenderIndex, row, WinnerIndex;
+	size_t col;
+	int *ContenderList;
+	bool AlreadyInTour;
+
+	ContenderList = (int*)malloc(sizeof(int) * k);
+
+	/* Hold tournaments until 'NoSurvivors' has been found.										 */
+	for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+
+		/* Randomly pick k contenders, drawing again those already in the tournament.			 */
+		Contender = 0;
+		while (Contender < k) {
+			ContenderIndex = Eliterows + (int)RandBelow(Rng, (unsigned int)(m - Eliterows));
+			AlreadyInTour = false;
+			for (row = 0; row < Contender; row++) {
+				if (ContenderIndex == ContenderList[row]) {
+					AlreadyInTour = true;
+				}
+			}
+			if (AlreadyInTour == false) {
+				ContenderList[Contender] = ContenderIndex;
+				Contender++;
+			}
+		}
+
+		/* Find winner of the tournament. Ties go to the earliest contender, and a contender	 */
+		/* beats a winner whose fitness is NaN, so NaN only wins if all contenders are NaN.		 */
+		WinnerIndex = ContenderList[0];
+		for (row = 1; row < k; row++) {
+			if (Fitness[ContenderList[row]] > Fitness[WinnerIndex] || Fitness[WinnerIndex] != Fitness[WinnerIndex]) {
+				WinnerIndex = ContenderList[row];
+			}
+		}
+
+		/* Extract the winner and place it in the pool of Survivors together with its fitness.	 */
+		SurvivorFitness[Tournament] = Fitness[WinnerIndex];
+		for (col = 0; col < n; col++) {
+			Survivors[Tournament + NoSurvivors * col] = Population[WinnerIndex + m * col];
+		}
+	}
+
+	free(ContenderList);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking that a per-run parameter is a real double scalar, shared by all runs,	 */
+/* or a vector with one element per run. Returns the step between the elements of consecutive	 */
+/* runs.																						 */
+size_t RunStride(const mxArray *Array, size_t R, const char *Message){
+	if (!mxIsDouble(Array) || mxIsComplex(Array) || (mxGetNumberOfElements(Array) != 1 && mxGetNumberOfElements(Array) != R)) {
+		mexErrMsgIdAndTxt("MATLAB:BatchTournamentSelection:invalidinputs", Message);
+	}
+	return mxGetNumberOfElements(Array) == 1 ? 0 : 1;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Random number generator (xoshiro256**), one per run so that the runs do not share the state	 */
+/* of rand(). Seeded through splitmix64.														 */
+uint64_t RngNext(uint64_t *s){
+	uint64_t Result = s[1] * 5;
+	uint64_t t = s[1] << 17;
+	Result = ((Result << 7) | (Result >> 57)) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return Result;
+}
+
+void RngSeed(uint64_t *s, uint64_t Seed){
+	int i;
+	uint64_t z;
+	for (i = 0; i < 4; i++) {
+		Seed += 0x9E3779B97F4A7C15ULL;
+		z = Seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s[i] = z ^ (z >> 31);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for deriving the seed of a run. Seed is hashed with splitmix64, and the runs of the	 */
+/* call take consecutive blocks of 4 from the splitmix64 sequence after the hash, one per state	 */
+/* word, so the streams of two calls only meet if their hashed seeds happen to be close. Unlike	 */
+/* Seed + r, nearby seeds then give unrelated runs.												 */
+uint64_t RunSeed(uint64_t Seed, uint64_t Run){
+	uint64_t z = Seed;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (z ^ (z >> 31)) + Run * 4 * 0x9E3779B97F4A7C15ULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer in the range 0 to Range-1.								 */
+unsigned int RandBelow(uint64_t *s, unsigned int Range){
+	return (unsigned int)(((RngNext(s) >> 32) * Range) >> 32);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
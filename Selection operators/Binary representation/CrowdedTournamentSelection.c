@@ -0,0 +1,382 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Crowded tournament selection operator (NSGA-II).
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which takes a population of chromosomes as input, together with a matrix of
+objective values (one column per objective), and performs multi-objective tournament selection as
+in NSGA-II. The population is first ranked into non-dominated fronts, the crowding distance of each
+individual within its front is computed, and tournaments are then won by the contender with the
+lowest front rank, or by the one with the largest crowding distance if the ranks are equal. The
+survivors are returned together with their objective values.
+
+All objectives are maximised (higher better), in the same way as the fitness in TournamentSelection.
+For two objectives the non-dominated sort is done in O(m log m) by sweeping the population sorted on
+the first objective and placing each individual in the first front whose last member does not
+dominate it (binary search over the fronts). For three or more objectives the efficient
+non-dominated sort with sequential search (ENS-SS) is used, which needs O(m) memory instead of the
+O(m^2) dominance lists of the original fast non-dominated sort and in practice only compares each
+individual against a small part of the population.
+
+For reference, see K. Deb et al., A fast and elitist multiobjective genetic algorithm: NSGA-II.
+IEEE Transactions on Evolutionary Computation, 6(2), 2002, and X. Zhang et al., An efficient
+approach to nondominated sorting for evolutionary multiobjective optimization. IEEE Transactions on
+Evolutionary Computation, 19(2), 2015.
+
+The function takes 4 inputs:
+* Input 1: a [1 x 1] scalar 'k' specifying how many contenders are involved in each tournament.
+* Input 2: a [m x M] matrix 'Objectives' containing the M objective values of each individual.
+* Input 3: a [m x n] boolean matrix 'Population' containing the population.
+* Input 4: a [1 x 1] scalar 'NoSurvivors' specifying the number of survivors after selection.
+
+The function outputs 4 variables:
+* Output 1: a [NoSurvivors x n] boolean matrix containing the survivors.
+* Output 2: a [NoSurvivors x M] matrix with the objective values of the survivors.
+* Output 3: a [m x 1] vector with the front rank of each individual in Population (1 = non-dominated).
+* Output 4: a [m x 1] vector with the crowding distance of each individual in Population.
+
+Output 3 and 4 can also be used for NSGA-II survivor selection in Matlab, e.g. by keeping the first
+rows of sortrows([Rank, -Crowding]).
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex CrowdedTournamentSelection.c
+
+% Run from Matlab when compiled:
+>> k = 2;
+>> Objectives = rand(100,2);
+>> Population = logical(randi([0 1],100, 256));
+>> NoSurvivors = 50;
+
+>> [ Survivors, SurvivorObjectives, Rank, Crowding ] = CrowdedTournamentSelection( k, Objectives, Population, NoSurvivors );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab
+#include <time.h>   // Needed for counting CPU clock cycle which is used to set seed for rand()
+#include <math.h>   // Needed for INFINITY
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void NonDominatedSort(const double *Objectives, size_t m, size_t M, int *Rank);
+
+void CrowdingDistance(const double *Objectives, const int *Rank, size_t m, size_t M, double *Crowding);
+
+void CrowdedTourSel(int k, const double *Objectives, const int *Rank, const double *Crowding, const bool *Population, int NoSurvivors, size_t m, size_t n, size_t M, bool *Survivors, double *SurvivorObjectives);
+
+bool Dominates(const double *Objectives, size_t m, size_t M, int a, int b);
+
+int randr(unsigned int min, unsigned int max);
+
+int cmplex(const void * a, const void * b);
+
+int cmpobj(const void * a, const void * b);
+
+/* State shared with the qsort() comparison functions, which take no user argument.				 */
+static const double *SortObjectives;
+static size_t SortRows, SortCols, SortObjective;
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.        */
+	srand(clock());
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	int k, NoSurvivors, i;
+	const double *Objectives;
+	const bool *Population;
+
+	double *SurvivorObjectives, *Crowding, *RankOut;
+	bool *Survivors;
+	int *Rank;
+
+	size_t m, n, M;
+
+	/* ————————————————————————— Get pointers from the input variables ————————————————————————— */
+	k           = (int)mxGetScalar(prhs[0]);  // Input 1 (k)
+	Objectives  = mxGetPr(prhs[1]);           // Input 2 (Objectives)
+	Population  = mxGetLogicals(prhs[2]);     // Input 3 (Population)
+	NoSurvivors = (int)mxGetScalar(prhs[3]);  // Input 4 (Number of survivors)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[2]);                      // Number of rows in Population.
+	n = mxGetN(prhs[2]);                      // Number of columns in Population.
+	M = mxGetN(prhs[1]);                      // Number of objectives.
+
+	if (mxGetM(prhs[1]) != m) {
+		mexErrMsgIdAndTxt("MATLAB:CrowdedTournamentSelection:invalidinputs", "Error: Objectives must have one row per individual in Population!");
+	}
+	if (k < 1 || k > (int)m) {
+		mexErrMsgIdAndTxt("MATLAB:CrowdedTournamentSelection:invalidinputs", "Error: Tournament size (k) must be between 1 and the population size!");
+	}
+
+	/* ———————————————————————————————— Specify Matlab outputs ————————————————————————————————— */
+	plhs[0] = mxCreateLogicalMatrix(NoSurvivors, n);
+	Survivors = mxGetLogicals(plhs[0]);
+	plhs[1] = mxCreateDoubleMatrix(NoSurvivors, M, mxREAL);
+	SurvivorObjectives = mxGetPr(plhs[1]);
+	plhs[2] = mxCreateDoubleMatrix(m, 1, mxREAL);
+	RankOut = mxGetPr(plhs[2]);
+	plhs[3] = mxCreateDoubleMatrix(m, 1, mxREAL);
+	Crowding = mxGetPr(plhs[3]);
+
+	/* —————————————————————— Non-dominated sorting and crowding distance —————————————————————— */
+	Rank = (int*)malloc(sizeof(int) * m);
+
+	NonDominatedSort(Objectives, m, M, Rank);
+	CrowdingDistance(Objectives, Rank, m, M, Crowding);
+
+	/* ————————————————————————————— Crowded tournament selection —————————————————————————————— */
+
+	     CrowdedTourSel(k,
+		       Objectives,
+		             Rank,
+		         Crowding,
+		       Population,
+		      NoSurvivors,
+		                m,
+		                n,
+		                M,
+		        Survivors,
+	   SurvivorObjectives);
+
+	/* Return the front ranks 1-based, as is customary in Matlab.								 */
+	for (i = 0; i < m; i++) {
+		RankOut[i] = Rank[i] + 1;
+	}
+
+	free(Rank);
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for sorting the population into non-dominated fronts. Rank[i] is set to the 0-based	 */
+/* front of individual i. In both variants the individuals are visited in lexicographically		 */
+/* decreasing order, so that an individual can only be dominated by individuals visited before it. */
+void NonDominatedSort(const double *Objectives, size_t m, size_t M, int *Rank){
+
+	int *Order, *FrontHead, *FrontLast, *NextInFront;
+	int i, q, p, NoFronts, Front, Low, High, Mid;
+	bool Dominated;
+
+	Order = (int*)malloc(sizeof(int) * m);
+	for (i = 0; i < m; i++) {
+		Order[i] = i;
+	}
+	SortObjectives = Objectives;
+	SortRows = m;
+	SortCols = M;
+	qsort(Order, m, sizeof(int), cmplex);
+
+	NoFronts = 0;
+	if (M == 2) {
+		/* Only the last individual added to a front can dominate a later one, since the front	 */
+		/* is sorted on the first objective and thus increasing in the second. The fronts are	 */
+		/* ordered, so the first non-dominating front is found by binary search.				 */
+		FrontLast = (int*)malloc(sizeof(int) * m);
+		for (i = 0; i < m; i++) {
+			q = Order[i];
+			Low = 0;
+			High = NoFronts;
+			while (Low < High) {
+				Mid = (Low + High) / 2;
+				if (Dominates(Objectives, m, M, FrontLast[Mid], q)) {
+					Low = Mid + 1;
+				}
+				else {
+					High = Mid;
+				}
+			}
+			if (Low == NoFronts) {
+				NoFronts++;
+			}
+			FrontLast[Low] = q;
+			Rank[q] = Low;
+		}
+		free(FrontLast);
+	}
+	else {
+		/* ENS-SS: check the fronts in order, comparing against the most recently added members	 */
+		/* of each front first. The members of a front are kept as a linked list, newest first.	 */
+		FrontHead   = (int*)malloc(sizeof(int) * m);
+		NextInFront = (int*)malloc(sizeof(int) * m);
+		for (i = 0; i < m; i++) {
+			q = Order[i];
+			for (Front = 0; Front < NoFronts; Front++) {
+				Dominated = false;
+				for (p = FrontHead[Front]; p >= 0; p = NextInFront[p]) {
+					if (Dominates(Objectives, m, M, p, q)) {
+						Dominated = true;
+						break;
+					}
+				}
+				if (Dominated == false) {
+					break;
+				}
+			}
+			if (Front == NoFronts) {
+				FrontHead[Front] = -1;
+				NoFronts++;
+			}
+			NextInFront[q] = FrontHead[Front];
+			FrontHead[Front] = q;
+			Rank[q] = Front;
+		}
+		free(FrontHead);
+		free(NextInFront);
+	}
+
+	free(Order);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for computing the crowding distance of each individual within its own front. The	 */
+/* boundary individuals of each objective get an infinite distance.								 */
+void CrowdingDistance(const double *Objectives, const int *Rank, size_t m, size_t M, double *Crowding){
+
+	int *Members, *FrontStart;
+	int i, Front, NoFronts, Start, Size, obj;
+	double Range;
+
+	/* Group the individuals by front with a counting sort on the rank.							 */
+	NoFronts = 0;
+	for (i = 0; i < m; i++) {
+		if (Rank[i] + 1 > NoFronts) {
+			NoFronts = Rank[i] + 1;
+		}
+		Crowding[i] = 0;
+	}
+	FrontStart = (int*)calloc(NoFronts + 1, sizeof(int));
+	Members    = (int*)malloc(sizeof(int) * m);
+	for (i = 0; i < m; i++) {
+		FrontStart[Rank[i] + 1]++;
+	}
+	for (Front = 0; Front < NoFronts; Front++) {
+		FrontStart[Front + 1] += FrontStart[Front];
+	}
+	for (i = 0; i < m; i++) {
+		Members[FrontStart[Rank[i]]++] = i;
+	}
+	for (Front = NoFronts; Front > 0; Front--) {
+		FrontStart[Front] = FrontStart[Front - 1];
+	}
+	FrontStart[0] = 0;
+
+	/* Sum the normalised distance between the neighbours along each objective.					 */
+	SortObjectives = Objectives;
+	SortRows = m;
+	for (Front = 0; Front < NoFronts; Front++) {
+		Start = FrontStart[Front];
+		Size  = FrontStart[Front + 1] - Start;
+		for (obj = 0; obj < M; obj++) {
+			SortObjective = obj;
+			qsort(Members + Start, Size, sizeof(int), cmpobj);
+
+			Crowding[Members[Start]] = INFINITY;
+			Crowding[Members[Start + Size - 1]] = INFINITY;
+
+			Range = Objectives[Members[Start + Size - 1] + m * obj] - Objectives[Members[Start] + m * obj];
+			if (Range > 0) {
+				for (i = Start + 1; i < Start + Size - 1; i++) {
+					Crowding[Members[i]] += (Objectives[Members[i + 1] + m * obj] - Objectives[Members[i - 1] + m * obj]) / Range;
+				}
+			}
+		}
+	}
+
+	free(FrontStart);
+	free(Members);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for performing crowded tournament selection.										 */
+void CrowdedTourSel(int k, const double *Objectives, const int *Rank, const double *Crowding, const bool *Population, int NoSurvivors, size_t m, size_t n, size_t M, bool *Survivors, double *SurvivorObjectives){
+
+	int Tournament, Contender, ContenderIndex, row, col, WinnerIndex;
+	int *ContenderList;
+	bool AlreadyInTour;
+
+	ContenderList = (int*)malloc(sizeof(int) * k);
+
+	/* Hold tournaments until 'NoSurvivors' has been found.										 */
+	for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+
+		/* Randomly pick k unique contenders.													 */
+		Contender = 0;
+		while (Contender < k){
+			ContenderIndex = randr(0, m-1);
+			AlreadyInTour = false;
+			for (row = 0; row < Contender; row++) {
+				if (ContenderIndex == ContenderList[row]) {
+					AlreadyInTour = true;
+				}
+			}
+			if (AlreadyInTour == false) {
+				ContenderList[Contender] = ContenderIndex;
+				Contender++;
+			}
+		}
+
+		/* Find winner of the tournament using the crowded-comparison operator.					 */
+		WinnerIndex = ContenderList[0];
+		for (row = 1; row < k; row++) {
+			ContenderIndex = ContenderList[row];
+			if (Rank[ContenderIndex] < Rank[WinnerIndex] ||
+			   (Rank[ContenderIndex] == Rank[WinnerIndex] && Crowding[ContenderIndex] > Crowding[WinnerIndex])) {
+				WinnerIndex = ContenderIndex;
+			}
+		}
+
+		/* Extract the winner and place it in the pool of Survivors together with its objectives. */
+		for (col = 0; col < M; col++){
+			SurvivorObjectives[Tournament + NoSurvivors * col] = Objectives[WinnerIndex + m * col];
+		}
+		for (col = 0; col < n; col++){
+			Survivors[Tournament + NoSurvivors * col] = Population[WinnerIndex + m * col];
+		}
+	}
+
+	free(ContenderList);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking if individual a dominates individual b (all objectives maximised).	 */
+bool Dominates(const double *Objectives, size_t m, size_t M, int a, int b) {
+	size_t obj;
+	bool Better = false;
+	for (obj = 0; obj < M; obj++) {
+		if (Objectives[a + m * obj] < Objectives[b + m * obj]) {
+			return false;
+		}
+		if (Objectives[a + m * obj] > Objectives[b + m * obj]) {
+			Better = true;
+		}
+	}
+	return Better;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer that lies within range.								 */
+int randr(unsigned int min, unsigned int max) {
+	return min + rand() / (RAND_MAX / (max - min + 1) + 1);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort individuals lexicographically decreasing on the objectives.	 */
+int cmplex(const void * a, const void * b){
+	size_t obj;
+	const double *A = SortObjectives + *(const int*)a;
+	const double *B = SortObjectives + *(const int*)b;
+	for (obj = 0; obj < SortCols; obj++) {
+		if (A[SortRows * obj] > B[SortRows * obj]) return -1;
+		if (A[SortRows * obj] < B[SortRows * obj]) return 1;
+	}
+	return 0;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort individuals increasing on objective 'SortObjective'.		 */
+int cmpobj(const void * a, const void * b){
+	double A = SortObjectives[*(const int*)a + SortRows * SortObjective];
+	double B = SortObjectives[*(const int*)b + SortRows * SortObjective];
+	return (A > B) - (A < B);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,234 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Elite selection.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which moves the E best individuals of a population to the top rows, best
+first, so that they can be protected by the 'Eliterows' input of TournamentSelection and the
+'ElitismNo' input of BitflipMutation without sorting the whole population.
+
+The E best individuals are found in one pass over the fitness with a min-heap holding the E best
+seen so far, i.e. in O(m log E) time instead of the O(m log m) of a full sort. The elites are then
+sorted and swapped row by row into the top E rows of a copy of the population, so apart from the
+copy only E rows are moved. The order of the remaining individuals is otherwise not preserved.
+NaN fitness is treated as the worst possible, and ties are broken in favour of the upper row.
+
+The copy is avoided by passing the population and fitness themselves as preallocated outputs, which
+are then reordered in place by the E swaps alone. The preallocated arrays must not share their data
+with another variable (e.g. after B = Population), as Matlab would not know that both are changed.
+
+The function takes 5 inputs:
+* Input 1: a [m x n] population matrix of logical values, with one individual per row.
+* Input 2: a [m x 1] vector 'Fitness' containing the fitness of each individual, higher better.
+* Input 3: a [1 x 1] scalar 'E' specifying how many elites should be moved to the top.
+* Input 4: (optional) a preallocated [m x n] logical matrix 'SelectedPopulation', into which the
+reordered population is written instead of into a new output. It may be the Population itself.
+* Input 5: (optional, with Input 4) a preallocated [m x 1] vector 'SelectedFitness', into which the
+reordered fitness is written. It may be the Fitness itself.
+
+The function outputs 3 variables:
+* Output 1: a [m x n] boolean matrix containing the reordered population.
+* Output 2: a [m x 1] vector with the reordered fitness.
+* Output 3: a [m x 1] vector 'Permutation' such that row i of the output is row Permutation(i) of
+the input population.
+With Inputs 4 and 5 only the Permutation is returned.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex EliteSelection.c
+
+% Run from Matlab when compiled:
+>> Population = logical(randi([0 1],10000, 256));
+>> Fitness = rand(10000,1);
+>> [ Population, Fitness ] = EliteSelection( Population, Fitness, 2 );
+>> [ Survivors, SurvivorFitness ] = TournamentSelection( 3, Fitness, Population, 5000, 2 );
+
+% Or move the elites to the top in place, swapping only the E rows:
+>> EliteSelection( Population, Fitness, 2, Population, Fitness );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <string.h> // Needed for memcpy.
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+bool Better(const double *Fitness, size_t a, size_t b);
+
+void HeapSiftDown(size_t *Heap, size_t Size, size_t Position, const double *Fitness);
+
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const bool *Population;
+	const double *Fitness;
+	int E;
+
+	bool *Output, Gene, ReturnPermutation;
+	double *FitnessOut, *Permutation, Swap;
+	mxArray *PermutationArray;
+	size_t *Heap, *Where, Size, row, gene, Elite, From, Other;
+	size_t m, n;
+	int Out;
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 3 || !mxIsLogical(prhs[0]) || !mxIsDouble(prhs[1])) {
+		mexErrMsgIdAndTxt("MATLAB:EliteSelection:invalidinputs", "Error: Inputs must be a logical Population, a Fitness vector and E!");
+	}
+	Population = mxGetLogicals(prhs[0]);      // Input 1 (Population)
+	Fitness    = mxGetPr(prhs[1]);            // Input 2 (Fitness)
+	E          = (int)mxGetScalar(prhs[2]);   // Input 3 (E)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[0]);                      // Number of rows in Population.
+	n = mxGetN(prhs[0]);                      // Number of columns in Population.
+
+	if (mxGetNumberOfElements(prhs[1]) != m) {
+		mexErrMsgIdAndTxt("MATLAB:EliteSelection:invalidinputs", "Error: Fitness must have one element per individual in Population!");
+	}
+	if (E < 0 || E > (int)m) {
+		mexErrMsgIdAndTxt("MATLAB:EliteSelection:invalidinputs", "Error: E must be between 0 and the number of individuals!");
+	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	/* The Permutation follows the reordered population and fitness, or is the only output if	 */
+	/* they are written to preallocated arrays. It is needed for the swaps even if not returned. */
+	Out = 0;
+	if (nrhs > 3) {
+		if (nrhs < 5 || nlhs > 1 || !IsPreallocated(prhs[3], mxLOGICAL_CLASS, m, n) || !IsPreallocated(prhs[4], mxDOUBLE_CLASS, m, 1)) {
+			mexErrMsgIdAndTxt("MATLAB:EliteSelection:invalidinputs", "Error: Preallocated SelectedPopulation and SelectedFitness must be a [m x n] logical matrix and a [m x 1] vector, and are not returned!");
+		}
+		Output     = mxGetLogicals(prhs[3]);
+		FitnessOut = mxGetPr(prhs[4]);
+	}
+	else {
+		plhs[Out++] = mxCreateLogicalMatrix(m, n);
+		Output = mxGetLogicals(plhs[0]);
+		plhs[Out++] = mxCreateDoubleMatrix(m, 1, mxREAL);
+		FitnessOut = mxGetPr(plhs[1]);
+	}
+	if (Output != Population) {
+		memcpy(Output, Population, sizeof(bool) * m * n);
+	}
+	if (FitnessOut != Fitness) {
+		memcpy(FitnessOut, Fitness, sizeof(double) * m);
+	}
+	PermutationArray = mxCreateDoubleMatrix(m, 1, mxREAL);
+	Permutation = mxGetPr(PermutationArray);
+	ReturnPermutation = Out < nlhs || Out == 0;
+	if (ReturnPermutation) {
+		plhs[Out] = PermutationArray;
+	}
+	for (row = 0; row < m; row++) {
+		Permutation[row] = (double)(row + 1);
+	}
+	if (E == 0) {
+		if (!ReturnPermutation) {
+			mxDestroyArray(PermutationArray);
+		}
+		return;
+	}
+
+	/* ——————————————————————————————————— Find the E best ————————————————————————————————————— */
+	/* The heap holds the E best rows seen so far, with the worst of them at the root.			 */
+	Heap = (size_t*)malloc(sizeof(size_t) * E);
+	Size = 0;
+	for (row = 0; row < m; row++) {
+		if (Size < (size_t)E) {
+			/* Sift the new row up from the bottom of the heap.									 */
+			From = Size++;
+			while (From > 0 && Better(Fitness, Heap[(From - 1) / 2], row)) {
+				Heap[From] = Heap[(From - 1) / 2];
+				From = (From - 1) / 2;
+			}
+			Heap[From] = row;
+		}
+		else if (Better(Fitness, row, Heap[0])) {
+			Heap[0] = row;
+			HeapSiftDown(Heap, Size, 0, Fitness);
+		}
+	}
+
+	/* Pop the worst elite to the end of the heap array until it is sorted best first.			 */
+	while (Size > 1) {
+		Elite = Heap[0];
+		Heap[0] = Heap[--Size];
+		Heap[Size] = Elite;
+		HeapSiftDown(Heap, Size, 0, Fitness);
+	}
+
+	/* ———————————————————————————————— Swap elites to the top ————————————————————————————————— */
+	/* Where[r] is the current row of input row r, and Permutation the input row of each row.	 */
+	Where = (size_t*)malloc(sizeof(size_t) * m);
+	for (row = 0; row < m; row++) {
+		Where[row] = row;
+	}
+	for (Elite = 0; Elite < (size_t)E; Elite++) {
+		From = Where[Heap[Elite]];
+		if (From == Elite) {
+			continue;
+		}
+		for (gene = 0; gene < n; gene++) {
+			Gene = Output[Elite + m * gene];
+			Output[Elite + m * gene] = Output[From + m * gene];
+			Output[From + m * gene] = Gene;
+		}
+		Swap = FitnessOut[Elite];
+		FitnessOut[Elite] = FitnessOut[From];
+		FitnessOut[From] = Swap;
+
+		Other = (size_t)Permutation[Elite] - 1;
+		Permutation[Elite] = (double)(Heap[Elite] + 1);
+		Permutation[From] = (double)(Other + 1);
+		Where[Heap[Elite]] = Elite;
+		Where[Other] = From;
+	}
+
+	free(Heap);
+	free(Where);
+	if (!ReturnPermutation) {
+		mxDestroyArray(PermutationArray);
+	}
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking if row a is better than row b. NaN is worse than any fitness, and of	 */
+/* two equal fitness values the upper row is better.											 */
+bool Better(const double *Fitness, size_t a, size_t b){
+	if (Fitness[a] == Fitness[b] || (mxIsNaN(Fitness[a]) && mxIsNaN(Fitness[b]))) {
+		return a < b;
+	}
+	return mxIsNaN(Fitness[b]) || Fitness[a] > Fitness[b];
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for restoring the heap below a position, with the worst row at the root.			 */
+void HeapSiftDown(size_t *Heap, size_t Size, size_t Position, const double *Fitness){
+
+	size_t Child, Row = Heap[Position];
+
+	while ((Child = 2 * Position + 1) < Size) {
+		if (Child + 1 < Size && Better(Fitness, Heap[Child], Heap[Child + 1])) {
+			Child++;
+		}
+		if (!Better(Fitness, Row, Heap[Child])) {
+			break;
+		}
+		Heap[Position] = Heap[Child];
+		Position = Child;
+	}
+	Heap[Position] = Row;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking that a preallocated output is a real [m x n] array of the given class.	 */
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n){
+	return mxGetClassID(Array) == Class && !mxIsComplex(Array) && mxGetNumberOfDimensions(Array) == 2
+		&& mxGetM(Array) == m && mxGetN(Array) == n;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
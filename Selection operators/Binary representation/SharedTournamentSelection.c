@@ -0,0 +1,573 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Tournament selection with fitness sharing or clearing.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which performs tournament selection as in TournamentSelection, but on a
+fitness that has been adjusted for crowding, so that the population spreads over several optima
+(niches) of a multimodal problem instead of converging to one of them.
+
+Two niching methods are available, both based on the Hamming distance d between individuals and a
+niche radius 'Sigma':
+* 'sharing': the fitness of each individual is divided by its niche count, the sum of
+sh(d) = 1 - (d/Sigma)^Alpha over all individuals (itself included) closer than Sigma.
+* 'clearing': the individuals are visited from best to worst, and each one that is not yet cleared
+becomes the winner of its niche and clears all individuals closer than Sigma, except for the Kappa
+best of the niche, whose fitness is kept. Cleared individuals get fitness 0.
+Both methods assume fitness values that are zero or positive. A NaN fitness stays NaN after sharing
+and is treated as the worst fitness, both in the tournaments and in the order of clearing.
+
+Finding the individuals closer than Sigma is the expensive part, which for m individuals naively
+takes O(m^2) distance computations. The individuals are packed into 64-bit words, so a distance
+is a popcount of XORed words, and it is computed with early exit, i.e. it stops as soon as the
+distance reaches Sigma. In addition, if the chromosome is long compared to Sigma, the genes are
+split into Sigma blocks. Two individuals closer than Sigma differ in fewer than Sigma genes, so
+by the pigeonhole principle they are identical in at least one of the blocks. The individuals are
+therefore indexed by the hash of each block, and only individuals that share a block are compared.
+The neighbours found are exactly the same as in a full scan, but for short niche radii only a small
+fraction of the pairs is compared. Otherwise the pairs are scanned in cache-sized tiles. The niche
+counts of the individuals are computed in parallel when compiled with OpenMP.
+
+For reference, see D. Goldberg and J. Richardson, Genetic algorithms with sharing for multimodal
+function optimization, 1987, and A. Petrowski, A clearing procedure as a niching method for
+genetic algorithms, 1996.
+
+The function takes 8 inputs:
+* Input 1: a [1 x 1] scalar 'k' specifying how many contenders are involved in each tournament.
+* Input 2: a [m x 1] vector 'Fitness' containing the fitness of each individual, higher better.
+* Input 3: a [m x n] boolean matrix 'Population' containing the population.
+* Input 4: a [1 x 1] scalar 'NoSurvivors' specifying the number of survivors after selection.
+* Input 5: a [1 x 1] scalar 'Eliterows' specifying how many rows, starting from the top, should
+be excluded from the selection process due to elitism.
+* Input 6: 'sharing' or 'clearing'.
+* Input 7: a [1 x 1] scalar 'Sigma', the niche radius in number of genes.
+* Input 8: (optional) a [1 x 1] scalar 'Alpha' for sharing (default 1) or 'Kappa' for clearing
+(default 1).
+
+The function outputs 3 variables:
+* Output 1: a [NoSurvivors x n] boolean matrix containing the survivors.
+* Output 2: a [NoSurvivors x 1] vector with the (unadjusted) fitness of the survivors.
+* Output 3: a [m x 1] vector with the shared or cleared fitness of the whole population.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64, optionally with OpenMP
+>> mex SharedTournamentSelection.c
+>> mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" SharedTournamentSelection.c
+
+% Run from Matlab when compiled:
+>> Fitness = rand(20000,1);
+>> Population = logical(randi([0 1],20000, 256));
+>> [ Survivors, SurvivorFitness ] = SharedTournamentSelection( 3, Fitness, Population, 10000, 0, 'sharing', 8 );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used to set seed for rand().
+#include <math.h>   // Needed for pow() in the sharing function.
+#include <string.h> // Needed for memset and strcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#ifdef _MSC_VER
+#include <intrin.h> // Needed for __popcnt64.
+#endif
+
+/* Shortest block, in genes, for which the pigeonhole index is used instead of a full scan.		 */
+#define MIN_BLOCK_GENES 16
+
+/* Number of individuals per tile in the full scan.												 */
+#define TILE_ROWS 256
+
+/* ——————————————————————————————————————————— Types ——————————————————————————————————————————— */
+/* Entry of the pigeonhole index: the hash of one block of one individual.						 */
+typedef struct {
+	uint64_t Key;
+	size_t Row;
+} BlockEntry;
+
+/* Packed population with its (optional) pigeonhole index.										 */
+typedef struct {
+	const uint64_t *Packed;     // [m x Words] packed individuals.
+	size_t m, n, Words;
+	int Sigma;
+	size_t Blocks;              // Number of blocks, 0 if the pigeonhole index is not used.
+	BlockEntry *Index;          // [Blocks x m] entries of each block, sorted by key.
+} NeighbourSearch;
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void TourSel(int k, const double *Fitness, const bool *Population, int NoSurvivors, int Eliterows, size_t m, size_t n, bool *Survivors, double *SurvivorFitness, int *SurvivorRows);
+
+void ShareFitness(const NeighbourSearch *Search, const double *Fitness, double Alpha, double *SharedFitness);
+
+void ClearFitness(const NeighbourSearch *Search, const double *Fitness, int Kappa, double *ClearedFitness);
+
+size_t FindNeighbours(const NeighbourSearch *Search, size_t Row, size_t *Neighbours, int *Distances);
+
+void BuildIndex(NeighbourSearch *Search);
+
+int HammingBelow(const uint64_t *a, const uint64_t *b, size_t Words, int Limit);
+
+uint64_t BlockHash(const uint64_t *Genome, size_t Start, size_t End);
+
+bool BlocksEqual(const uint64_t *a, const uint64_t *b, size_t Start, size_t End);
+
+size_t BlockStart(const NeighbourSearch *Search, size_t Block);
+
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed);
+
+void DrawContenders(int k, int Eliterows, size_t m, int *ContenderList);
+
+int Popcount64(uint64_t x);
+
+int CompareEntries(const void *a, const void *b);
+
+int CompareFitnessDescending(const void *a, const void *b);
+
+int cmpfunc(const void * a, const void * b);
+
+int randr(unsigned int min, unsigned int max);
+
+/* Fitness used by CompareFitnessDescending.													 */
+static const double *SortFitness;
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.		 */
+	srand(clock());
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	int k, NoSurvivors, Eliterows, Sigma;
+	const double *Fitness;
+	const bool *Population;
+	char Method[16];
+	double Parameter;
+
+	double *SurvivorFitness, *AdjustedFitness;
+	bool *Survivors;
+	int *SurvivorRows, Tournament;
+	uint64_t *Packed;
+	NeighbourSearch Search;
+
+	size_t m, n;
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 7 || mxGetString(prhs[5], Method, sizeof(Method)) != 0 || !mxIsLogical(prhs[2])) {
+		mexErrMsgIdAndTxt("MATLAB:SharedTournamentSelection:invalidinputs", "Error: Inputs must be k, Fitness, a logical Population, NoSurvivors, Eliterows, Method and Sigma!");
+	}
+	k           = (int)mxGetScalar(prhs[0]);  // Input 1 (k)
+	Fitness     = mxGetPr(prhs[1]);           // Input 2 (Fitness)
+	Population  = mxGetLogicals(prhs[2]);     // Input 3 (Population)
+	NoSurvivors = (int)mxGetScalar(prhs[3]);  // Input 4 (Number of survivors)
+	Eliterows   = (int)mxGetScalar(prhs[4]);  // Input 5 (Number of elitism rows)
+	Sigma       = (int)mxGetScalar(prhs[6]);  // Input 7 (Sigma)
+	Parameter   = nrhs > 7 ? mxGetScalar(prhs[7]) : 1; // Input 8 (Alpha or Kappa)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[2]);                      // Number of rows in Population.
+	n = mxGetN(prhs[2]);                      // Number of columns in Population.
+
+	if (mxGetNumberOfElements(prhs[1]) != m) {
+		mexErrMsgIdAndTxt("MATLAB:SharedTournamentSelection:invalidinputs", "Error: Fitness must have one element per individual in Population!");
+	}
+	if (k < 1 || Eliterows < 0 || k > (int)m - Eliterows) {
+		mexErrMsgIdAndTxt("MATLAB:SharedTournamentSelection:invalidinputs", "Error: k must be between 1 and the number of non-elite rows!");
+	}
+	if (Sigma < 1 || (strcmp(Method, "sharing") != 0 && strcmp(Method, "clearing") != 0)) {
+		mexErrMsgIdAndTxt("MATLAB:SharedTournamentSelection:invalidinputs", "Error: Method must be 'sharing' or 'clearing', and Sigma at least 1!");
+	}
+
+	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
+	plhs[0] = mxCreateLogicalMatrix(NoSurvivors, n);
+	Survivors = mxGetLogicals(plhs[0]);
+	plhs[1] = mxCreateDoubleMatrix(NoSurvivors, 1, mxREAL);
+	SurvivorFitness = mxGetPr(plhs[1]);
+	plhs[2] = mxCreateDoubleMatrix(m, 1, mxREAL);
+	AdjustedFitness = mxGetPr(plhs[2]);
+
+	/* ———————————————————————————————— Find the niches ———————————————————————————————————————— */
+	Search.m      = m;
+	Search.n      = n;
+	Search.Words  = (n + 63) / 64;
+	Search.Sigma  = Sigma;
+	Packed        = (uint64_t*)malloc(sizeof(uint64_t) * (m * Search.Words + 1));
+	PackRows(Population, m, n, Search.Words, Packed);
+	Search.Packed = Packed;
+	BuildIndex(&Search);
+
+	if (strcmp(Method, "sharing") == 0) {
+		ShareFitness(&Search, Fitness, Parameter, AdjustedFitness);
+	}
+	else {
+		ClearFitness(&Search, Fitness, (int)Parameter, AdjustedFitness);
+	}
+	free(Packed);
+	free(Search.Index);
+
+	/* ———————————————————————— Tournament selection on adjusted fitness ——————————————————————— */
+	SurvivorRows = (int*)malloc(sizeof(int) * (NoSurvivors + 1));
+	TourSel(k, AdjustedFitness, Population, NoSurvivors, Eliterows, m, n, Survivors, SurvivorFitness, SurvivorRows);
+	for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+		SurvivorFitness[Tournament] = Fitness[SurvivorRows[Tournament]];
+	}
+	free(SurvivorRows);
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for performing tournament selection, as in TournamentSelection. The row of each		 */
+/* winner is also returned in SurvivorRows.														 */
+void TourSel(int k, const double *Fitness, const bool *Population, int NoSurvivors, int Eliterows, size_t m, size_t n, bool *Survivors, double *SurvivorFitness, int *SurvivorRows){
+
+	int Tournament, row, col, WinnerIndex;
+	int *ContenderList;
+	double Winner;
+
+	ContenderList = (int*)malloc(sizeof(int) * k);
+
+	/* Hold tournaments until 'NoSurvivors' has been found.										 */
+	for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+
+		/* Randomly pick k contenders and find the winner of the tournament. A contender beats a */
+		/* winner whose fitness is NaN, so NaN only wins if all contenders are NaN.				 */
+		DrawContenders(k, Eliterows, m, ContenderList);
+		Winner = Fitness[ContenderList[0]];
+		WinnerIndex = ContenderList[0];
+		for (row = 1; row < k; row++) {
+			if (Fitness[ContenderList[row]] > Winner || Winner != Winner) {
+				Winner = Fitness[ContenderList[row]];
+				WinnerIndex = ContenderList[row];
+			}
+		}
+
+		/* Extract the winner and place it in the pool of Survivors together with its fitness.	 */
+		SurvivorFitness[Tournament] = Winner;
+		SurvivorRows[Tournament] = WinnerIndex;
+		for (col = 0; col < (int)n; col++){
+			Survivors[Tournament + NoSurvivors * col] = Population[WinnerIndex + m * col];
+		}
+	}
+
+	free(ContenderList);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for fitness sharing: each fitness is divided by the niche count of the individual.	 */
+/* Every individual finds its own neighbours, so the individuals can be handled in parallel.	 */
+void ShareFitness(const NeighbourSearch *Search, const double *Fitness, double Alpha, double *SharedFitness){
+
+	ptrdiff_t row;
+
+	#pragma omp parallel
+	{
+		size_t *Neighbours = (size_t*)malloc(sizeof(size_t) * Search->m);
+		int *Distances = (int*)malloc(sizeof(int) * Search->m);
+		size_t NoNeighbours, j;
+		double NicheCount;
+
+		#pragma omp for schedule(dynamic, 64)
+		for (row = 0; row < (ptrdiff_t)Search->m; row++) {
+			NoNeighbours = FindNeighbours(Search, (size_t)row, Neighbours, Distances);
+			NicheCount = 1;
+			for (j = 0; j < NoNeighbours; j++) {
+				NicheCount += 1 - pow((double)Distances[j] / Search->Sigma, Alpha);
+			}
+			SharedFitness[row] = Fitness[row] / NicheCount;
+		}
+		free(Neighbours);
+		free(Distances);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for clearing: from best to worst, each individual that is not cleared is the winner	 */
+/* of a niche, and clears the individuals of its niche beyond the Kappa best.					 */
+void ClearFitness(const NeighbourSearch *Search, const double *Fitness, int Kappa, double *ClearedFitness){
+
+	size_t *Order, *Neighbours, NoNeighbours, i, j, Row;
+	int *Distances, *Rank, Winners;
+	bool *Cleared;
+
+	Order      = (size_t*)malloc(sizeof(size_t) * Search->m);
+	Rank       = (int*)malloc(sizeof(int) * Search->m);
+	Neighbours = (size_t*)malloc(sizeof(size_t) * Search->m);
+	Distances  = (int*)malloc(sizeof(int) * Search->m);
+	Cleared    = (bool*)calloc(Search->m, sizeof(bool));
+
+	for (i = 0; i < Search->m; i++) {
+		Order[i] = i;
+	}
+	SortFitness = Fitness;
+	qsort(Order, Search->m, sizeof(size_t), CompareFitnessDescending);
+	for (i = 0; i < Search->m; i++) {
+		Rank[Order[i]] = (int)i;
+	}
+
+	for (i = 0; i < Search->m; i++) {
+		Row = Order[i];
+		ClearedFitness[Row] = Cleared[Row] ? 0 : Fitness[Row];
+		if (Cleared[Row]) {
+			continue;
+		}
+
+		/* Keep the Kappa best of the niche (this winner included) and clear the rest. The		 */
+		/* neighbours are in no particular order, so they are sorted by rank first.				 */
+		NoNeighbours = FindNeighbours(Search, Row, Neighbours, Distances);
+		for (j = 0; j < NoNeighbours; j++) {
+			Distances[j] = Rank[Neighbours[j]];
+		}
+		qsort(Distances, NoNeighbours, sizeof(int), cmpfunc);
+		Winners = 1;
+		for (j = 0; j < NoNeighbours; j++) {
+			Row = Order[Distances[j]];
+			if ((size_t)Distances[j] < i || Cleared[Row]) {
+				continue;
+			}
+			if (Winners < Kappa) {
+				Winners++;
+			}
+			else {
+				Cleared[Row] = true;
+			}
+		}
+	}
+
+	free(Order);
+	free(Rank);
+	free(Neighbours);
+	free(Distances);
+	free(Cleared);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding all individuals closer than Sigma to an individual, itself excluded.	 */
+/* Returns their number, and writes their rows and distances to Neighbours and Distances.		 */
+size_t FindNeighbours(const NeighbourSearch *Search, size_t Row, size_t *Neighbours, int *Distances){
+
+	const uint64_t *Genome = Search->Packed + Row * Search->Words;
+	const BlockEntry *Entries;
+	size_t NoNeighbours = 0, Block, Earlier, Low, High, Mid, Tile, j, Other;
+	uint64_t Key;
+	int Distance;
+	bool Duplicate;
+
+	/* Full scan, tile by tile so that the other individuals stay in cache between rows.		 */
+	if (Search->Blocks == 0) {
+		for (Tile = 0; Tile < Search->m; Tile += TILE_ROWS) {
+			for (j = Tile; j < Tile + TILE_ROWS && j < Search->m; j++) {
+				if (j == Row) {
+					continue;
+				}
+				Distance = HammingBelow(Genome, Search->Packed + j * Search->Words, Search->Words, Search->Sigma);
+				if (Distance < Search->Sigma) {
+					Neighbours[NoNeighbours] = j;
+					Distances[NoNeighbours] = Distance;
+					NoNeighbours++;
+				}
+			}
+		}
+		return NoNeighbours;
+	}
+
+	/* Pigeonhole search: look up the individuals that share the hash of a block, and compare	 */
+	/* them if the block is truly identical. A pair identical in several blocks is only			 */
+	/* compared in the first of them.															 */
+	for (Block = 0; Block < Search->Blocks; Block++) {
+		Entries = Search->Index + Block * Search->m;
+		Key = BlockHash(Genome, BlockStart(Search, Block), BlockStart(Search, Block + 1));
+
+		Low = 0;
+		High = Search->m;
+		while (Low < High) {
+			Mid = Low + (High - Low) / 2;
+			if (Entries[Mid].Key < Key) {
+				Low = Mid + 1;
+			}
+			else {
+				High = Mid;
+			}
+		}
+
+		for (; Low < Search->m && Entries[Low].Key == Key; Low++) {
+			Other = Entries[Low].Row;
+			if (Other == Row || !BlocksEqual(Genome, Search->Packed + Other * Search->Words, BlockStart(Search, Block), BlockStart(Search, Block + 1))) {
+				continue;
+			}
+			Duplicate = false;
+			for (Earlier = 0; Earlier < Block && !Duplicate; Earlier++) {
+				Duplicate = BlocksEqual(Genome, Search->Packed + Other * Search->Words, BlockStart(Search, Earlier), BlockStart(Search, Earlier + 1));
+			}
+			if (Duplicate) {
+				continue;
+			}
+			Distance = HammingBelow(Genome, Search->Packed + Other * Search->Words, Search->Words, Search->Sigma);
+			if (Distance < Search->Sigma) {
+				Neighbours[NoNeighbours] = Other;
+				Distances[NoNeighbours] = Distance;
+				NoNeighbours++;
+			}
+		}
+	}
+	return NoNeighbours;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for building the pigeonhole index, if the blocks are long enough to be selective.	 */
+void BuildIndex(NeighbourSearch *Search){
+
+	size_t Block, row;
+	BlockEntry *Entries;
+
+	Search->Index = NULL;
+	Search->Blocks = 0;
+	if (Search->n / (size_t)Search->Sigma < MIN_BLOCK_GENES) {
+		return;
+	}
+
+	Search->Blocks = (size_t)Search->Sigma;
+	Search->Index = (BlockEntry*)malloc(sizeof(BlockEntry) * Search->Blocks * Search->m + 1);
+	for (Block = 0; Block < Search->Blocks; Block++) {
+		Entries = Search->Index + Block * Search->m;
+		for (row = 0; row < Search->m; row++) {
+			Entries[row].Key = BlockHash(Search->Packed + row * Search->Words, BlockStart(Search, Block), BlockStart(Search, Block + 1));
+			Entries[row].Row = row;
+		}
+		qsort(Entries, Search->m, sizeof(BlockEntry), CompareEntries);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for the Hamming distance between two packed individuals, with early exit: the		 */
+/* counting stops as soon as the distance reaches Limit, and Limit is then returned.			 */
+int HammingBelow(const uint64_t *a, const uint64_t *b, size_t Words, int Limit){
+	size_t word;
+	int Distance = 0;
+	for (word = 0; word < Words; word++) {
+		Distance += Popcount64(a[word] ^ b[word]);
+		if (Distance >= Limit) {
+			return Limit;
+		}
+	}
+	return Distance;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for hashing genes Start to End-1 of a packed individual.							 */
+uint64_t BlockHash(const uint64_t *Genome, size_t Start, size_t End){
+	size_t word;
+	uint64_t Mask, Hash = 0x9E3779B97F4A7C15ULL;
+	for (word = Start / 64; word <= (End - 1) / 64; word++) {
+		Mask = ~(uint64_t)0;
+		if (word == Start / 64) {
+			Mask &= ~(uint64_t)0 << (Start % 64);
+		}
+		if (word == (End - 1) / 64 && End % 64 != 0) {
+			Mask &= ((uint64_t)1 << (End % 64)) - 1;
+		}
+		Hash ^= Genome[word] & Mask;
+		Hash *= 0xBF58476D1CE4E5B9ULL;
+		Hash ^= Hash >> 31;
+	}
+	return Hash;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking if genes Start to End-1 of two packed individuals are identical.		 */
+bool BlocksEqual(const uint64_t *a, const uint64_t *b, size_t Start, size_t End){
+	size_t word;
+	uint64_t Mask;
+	for (word = Start / 64; word <= (End - 1) / 64; word++) {
+		Mask = ~(uint64_t)0;
+		if (word == Start / 64) {
+			Mask &= ~(uint64_t)0 << (Start % 64);
+		}
+		if (word == (End - 1) / 64 && End % 64 != 0) {
+			Mask &= ((uint64_t)1 << (End % 64)) - 1;
+		}
+		if (((a[word] ^ b[word]) & Mask) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for the first gene of a block, with the genes split into nearly equal blocks.		 */
+size_t BlockStart(const NeighbourSearch *Search, size_t Block){
+	return Block * Search->n / Search->Blocks;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing each row of a column-major logical matrix into 64-bit words. Gene j of	 */
+/* a row is stored in bit j%64 of word j/64, and the unused bits of the last word are zero.		 */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed){
+
+	size_t row, gene;
+
+	memset(Packed, 0, sizeof(uint64_t) * m * Words);
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < m; row++) {
+			Packed[row * Words + gene / 64] |= (uint64_t)(Population[row + m * gene] != 0) << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing k unique contenders among the non-elite rows.							 */
+void DrawContenders(int k, int Eliterows, size_t m, int *ContenderList){
+
+	int Contender, ContenderIndex, row;
+	bool AlreadyInTour;
+
+	Contender = 0;
+	while (Contender < k){
+		ContenderIndex = randr(Eliterows, (unsigned int)m - 1);
+		AlreadyInTour = false;
+		for (row = 0; row < Contender; row++) {
+			if (ContenderIndex == ContenderList[row]) {
+				AlreadyInTour = true;
+			}
+		}
+		if (AlreadyInTour == false) {
+			ContenderList[Contender] = ContenderIndex;
+			Contender++;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for counting the number of bits that are set in a 64-bit word.						 */
+int Popcount64(uint64_t x){
+#if defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64(x);
+#elif defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort index entries by key.										 */
+int CompareEntries(const void *a, const void *b){
+	uint64_t KeyA = ((const BlockEntry*)a)->Key, KeyB = ((const BlockEntry*)b)->Key;
+	return (KeyA > KeyB) - (KeyA < KeyB);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort rows by decreasing fitness, with ties in row order. NaN is	 */
+/* sorted last, as the worst fitness, so that the order is consistent.							 */
+int CompareFitnessDescending(const void *a, const void *b){
+	size_t RowA = *(const size_t*)a, RowB = *(const size_t*)b;
+	bool NaNA = mxIsNaN(SortFitness[RowA]), NaNB = mxIsNaN(SortFitness[RowB]);
+	if (NaNA != NaNB) {
+		return NaNA ? 1 : -1;
+	}
+	if (!NaNA && SortFitness[RowA] != SortFitness[RowB]) {
+		return SortFitness[RowA] < SortFitness[RowB] ? 1 : -1;
+	}
+	return (RowA > RowB) - (RowA < RowB);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort vector.														 */
+int cmpfunc(const void * a, const void * b){
+	return (*(int*)a - *(int*)b);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer that lies within range.								 */
+int randr(unsigned int min, unsigned int max) {
+	return min + rand() / (RAND_MAX / (max - min + 1) + 1);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -14,14 +14,31 @@ The function takes 5 inputs:
 * Input 4: a [1 x 1] scalar 'NoSurvivors' specifying the number of survivors after selection.
 * Input 5: a [1 x 1] scalar 'Eliterows' specifying how many rows, starting from the top, should
 be excluded from the selection process due to elitism.
+* Input 6-7: (optional) a preallocated [NoSurvivors x n] logical matrix 'Survivors' and a
+preallocated [NoSurvivors x 1] double vector 'SurvivorFitness', into which the survivors and their
+fitness are written in place instead of into new outputs. The function then has no outputs.
 
 The function outputs 2 variables:
 * Output 1: a [NoSurvivors x n] boolean matrix containing the survivors.
 * Output 2: a [NoSurvivors x 1] vector with the fitness of the survivors.
+* Output 3: (only when compiled with GA_INSTRUMENT) a struct 'Counters' with the number of random
+numbers drawn (RngDraws), of contenders drawn again because they were already in the tournament
+(ContenderRetries) and of bytes copied into the survivors (BytesCopied), and the wall time of the
+selection in seconds (SelectionTime). With preallocated outputs it is the only output.
+
+New outputs are not zero-filled before the survivors are written, as they are overwritten
+completely. Writing into preallocated outputs saves the allocation as well, which is a noticeable
+part of the run time for small populations, e.g. when called once per generation in a loop. The
+preallocated arrays must not share their data with another variable (e.g. after B = Survivors), as
+Matlab does not know that they are changed and would change the other variable as well.
 
 Example on how to compile and run from Matlab:
 % Compile .C to .mexw64
 >> mex TournamentSelection.c
+% or with the typed data API of Matlab R2018a and later
+>> mex -R2018a TournamentSelection.c
+% or with the instrumentation counters
+>> mex -DGA_INSTRUMENT TournamentSelection.c
 
 % Run from Matlab when compiled:
 >> k = 3;
@@ -32,6 +49,30 @@ Example on how to compile and run from Matlab:
 
 >> [ Survivors, SurvivorFitness ] = TournamentSelection( k, Fitness, Population, NoSurvivors, Eliterows );
 
+% Or write into preallocated outputs, e.g. once per generation:
+>> Survivors = false(NoSurvivors, 256);
+>> SurvivorFitness = zeros(NoSurvivors, 1);
+>> TournamentSelection( k, Fitness, Population, NoSurvivors, Eliterows, Survivors, SurvivorFitness );
+
+When compiled with AVX2 (or AVX-512F) enabled the tournaments are held in batches of 4 (or 8), 
+where the fitness of the contenders of all tournaments in a batch is gathered in parallel and the 
+winners are found with a vector max and index blend. The batches draw their contenders in the same 
+order as the scalar path, so the survivors are identical whichever path is compiled in. This is 
+mostly worthwhile for high selection pressure (large k).
+
+% Compile with AVX2 (GCC/Clang) or AVX-512F (MSVC) to enable the batch path:
+>> mex CFLAGS="$CFLAGS -mavx2" TournamentSelection.c
+>> mex COMPFLAGS="$COMPFLAGS /arch:AVX512" TournamentSelection.c
+
+Example on how to compile and run from GNU Octave:
+% Compile .C to .mex, or to a native .oct together with the Octave gateway TournamentSelection.cc,
+% which passes the Octave arrays to TourSel without converting them to and from mxArrays
+>> mkoctfile --mex TournamentSelection.c
+>> mkoctfile -DGA_NO_MEX TournamentSelection.cc TournamentSelection.c
+
+% Run from Octave when compiled, exactly as from Matlab:
+>> [ Survivors, SurvivorFitness ] = TournamentSelection( k, Fitness, Population, NoSurvivors, Eliterows );
+
 Example of compatible C compilers:
 * Microsoft Visual C++ 2013 Professional (C)
 * Microsoft Visual C++ 2015 Professional (C)
@@ -41,19 +82,91 @@ Written 2017-09-12 by
 petter.stefansson@nmbu.no
 ———————————————————————————————————————————————————————————————————————————————————————————————— */
 
+#ifndef GA_NO_MEX
 #include <mex.h>	// Needed to communicate with matlab
+
+/* Typed data access of the R2018a API when compiled with mex -R2018a, else the legacy API.		 */
+#if MX_HAS_INTERLEAVED_COMPLEX
+#define GetDoubles(Array) mxGetDoubles(Array)
+#else
+#define GetDoubles(Array) mxGetPr(Array)
+#endif
+
+/* New outputs are not zero-filled, except under Octave where older versions lack the function.	 */
+#ifdef HAVE_OCTAVE
+#define CreateUninitMatrix(m, n, Class) mxCreateNumericMatrix(m, n, Class, mxREAL)
+#else
+#define CreateUninitMatrix(m, n, Class) mxCreateUninitNumericMatrix(m, n, Class, mxREAL)
+#endif
+#else
+#include <stdlib.h>  // Needed for malloc and rand when compiled for the native Octave gateway.
+#include <stdbool.h> // Needed for bool when compiled for the native Octave gateway.
+#endif
 #include <time.h>   // Needed for counting CPU clock cycle which is used to set seed for rand()
 
+/* ——————————————————————————————————————— Instrumentation ————————————————————————————————————— */
+/* When compiled with GA_INSTRUMENT defined the operator counts its random numbers, redrawn		 */
+/* contenders and copied bytes, and times its phases in seconds of wall time. The counters of	 */
+/* the last call are kept in TourSelCounters, named by TourSelCounterNames. Without				 */
+/* GA_INSTRUMENT the counting compiles to nothing.												 */
+#ifdef GA_INSTRUMENT
+#include <stdio.h>  // Needed for snprintf.
+#include <string.h> // Needed for memset.
+#ifdef _WIN32
+#include <windows.h> // Needed for QueryPerformanceCounter.
+#endif
+enum { RNG_DRAWS, CONTENDER_RETRIES, BYTES_COPIED, SELECTION_TIME, TOURSEL_NO_COUNTERS };
+const int TourSelNoCounters = TOURSEL_NO_COUNTERS;
+const char *TourSelCounterNames[TOURSEL_NO_COUNTERS] = { "RngDraws", "ContenderRetries", "BytesCopied", "SelectionTime" };
+double TourSelCounters[TOURSEL_NO_COUNTERS];
+#define COUNT(Counter, Amount) (TourSelCounters[Counter] += (double)(Amount))
+#define COUNTERS_OUTPUT 1
+#else
+#define COUNT(Counter, Amount) ((void)0)
+#define COUNTERS_OUTPUT 0
+#endif
+
+/* Number of tournaments held in parallel by the SIMD batch path (doubles per vector register).	 */
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define TOURSEL_BATCH 8
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define TOURSEL_BATCH 4
+#endif
+
 /* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
 void TourSel(int k, const double *Fitness, const bool *Population, int NoSurvivors, int Eliterows, size_t m, size_t n, bool *Survivors, double *SurvivorFitness);
 
+void DrawContenders(int k, int Eliterows, size_t m, int *ContenderList, int Stride);
+
+#ifdef TOURSEL_BATCH
+void BatchWinners(int k, const double *Fitness, const int *ContenderList, int *WinnerIndex, double *Winner);
+#endif
+
 int randr(unsigned int min, unsigned int max);
 
+#ifdef GA_INSTRUMENT
+double WallTime(void);
+
+int TourSelCountersJson(char *Buffer, size_t Size);
+
+#ifndef GA_NO_MEX
+mxArray *CountersStruct(void);
+#endif
+#endif
+
+#ifndef GA_NO_MEX
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n);
+
 /* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 
-	/* Before starting set the seed of the RNG to the number of clock cycles since start.        */
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.		 */
 	srand(clock());
+#ifdef GA_INSTRUMENT
+	memset(TourSelCounters, 0, sizeof(TourSelCounters));
+#endif
 
 	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
 	int k, NoSurvivors, Eliterows;
@@ -67,7 +180,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 
 	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
 	k           = (int)mxGetScalar(prhs[0]);  // Input 1 (k)
-	Fitness     = mxGetPr(prhs[1]);           // Input 2 (Fitness)
+	Fitness     = GetDoubles(prhs[1]);        // Input 2 (Fitness)
 	Population  = mxGetLogicals(prhs[2]);     // Input 3 (Population)
 	NoSurvivors = (int)mxGetScalar(prhs[3]);  // Input 4 (Number of survivors)
 	Eliterows   = (int)mxGetScalar(prhs[4]);  // Input 5 (Number of elitism rows)
@@ -76,11 +189,24 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 	m = mxGetM(prhs[2]);                      // Number of rows in Population.
 	n = mxGetN(prhs[2]);                      // Number of columns in Population.
 
+	if (Fitness == NULL || mxIsComplex(prhs[1]) || mxGetNumberOfElements(prhs[1]) != m) {
+		mexErrMsgIdAndTxt("MATLAB:TournamentSelection:invalidinputs", "Error: Fitness must be a real double vector with one element per individual in Population!");
+	}
+
 	/* ——————————————————————————————— Specify Matlab outputs —————————————————————————————————— */
-	plhs[0] = mxCreateLogicalMatrix(NoSurvivors, n);
-	Survivors = mxGetLogicals(plhs[0]);
-	plhs[1] = mxCreateDoubleMatrix(NoSurvivors, 1, mxREAL);
-	SurvivorFitness = mxGetPr(plhs[1]);
+	if (nrhs > 5) {
+		if (nrhs < 7 || nlhs > COUNTERS_OUTPUT || !IsPreallocated(prhs[5], mxLOGICAL_CLASS, NoSurvivors, n) || !IsPreallocated(prhs[6], mxDOUBLE_CLASS, NoSurvivors, 1)) {
+			mexErrMsgIdAndTxt("MATLAB:TournamentSelection:invalidinputs", "Error: Preallocated outputs must be a [NoSurvivors x n] logical matrix and a [NoSurvivors x 1] double vector, and nothing is returned!");
+		}
+		Survivors = mxGetLogicals(prhs[5]);
+		SurvivorFitness = GetDoubles(prhs[6]);
+	}
+	else {
+		plhs[0] = CreateUninitMatrix(NoSurvivors, n, mxLOGICAL_CLASS);
+		Survivors = mxGetLogicals(plhs[0]);
+		plhs[1] = CreateUninitMatrix(NoSurvivors, 1, mxDOUBLE_CLASS);
+		SurvivorFitness = GetDoubles(plhs[1]);
+	}
 	
 	/* ——————————————————————————————— Tournament selection ———————————————————————————————————— */
 	
@@ -93,63 +219,93 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
 		                n, 
 		        Survivors,
 		  SurvivorFitness);
-	
+
+#ifdef GA_INSTRUMENT
+	if (nlhs > (nrhs > 5 ? 0 : 2)) {
+		plhs[nrhs > 5 ? 0 : 2] = CountersStruct();
+	}
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking that a preallocated output is a real [m x n] array of the given class.	 */
+bool IsPreallocated(const mxArray *Array, mxClassID Class, size_t m, size_t n){
+	return mxGetClassID(Array) == Class && !mxIsComplex(Array) && mxGetNumberOfDimensions(Array) == 2
+		&& mxGetM(Array) == m && mxGetN(Array) == n;
 }
+#endif
 
 /* ————————————————————————————————————————————————————————————————————————————————————————————— */
 /* Function for performing tournament selection.												 */
 void TourSel(int k, const double *Fitness, const bool *Population, int NoSurvivors, int Eliterows, size_t m, size_t n, bool *Survivors, double *SurvivorFitness){
 
-	int Tournament, Contender, ContenderIndex, row, col, WinnerIndex;
+	int Tournament, row, col, WinnerIndex;
 	int *ContenderList;
-	bool AlreadyInTour;
 	double Winner;
 	double *ContenderFitnessList;
 
+	COUNT(SELECTION_TIME, -WallTime());
+	COUNT(BYTES_COPIED, (double)NoSurvivors * n);
+	Tournament = 0;
+
+#ifdef TOURSEL_BATCH
+	/* Hold TOURSEL_BATCH tournaments at a time. The contenders are stored contender-major, so	 */
+	/* that contender c of every tournament in the batch lies at ContenderList[c*TOURSEL_BATCH]. */
+	int lane;
+	int BatchWinnerIndex[TOURSEL_BATCH];
+	double BatchWinner[TOURSEL_BATCH];
+
+	ContenderList = (int*)malloc(sizeof(int) * k * TOURSEL_BATCH);
+
+	for (; Tournament + TOURSEL_BATCH <= NoSurvivors; Tournament += TOURSEL_BATCH) {
+
+		/* Randomly pick k contenders for each tournament in the batch.							 */
+		for (lane = 0; lane < TOURSEL_BATCH; lane++) {
+			DrawContenders(k, Eliterows, m, ContenderList + lane, TOURSEL_BATCH);
+		}
+
+		/* Find the winners of all tournaments in the batch at once.							 */
+		BatchWinners(k, Fitness, ContenderList, BatchWinnerIndex, BatchWinner);
+
+		/* Place the winners in the pool of Survivors together with their fitness.				 */
+		for (lane = 0; lane < TOURSEL_BATCH; lane++) {
+			SurvivorFitness[Tournament + lane] = BatchWinner[lane];
+			for (col = 0; col < n; col++){
+				Survivors[Tournament + lane + NoSurvivors * col] = Population[BatchWinnerIndex[lane] + m * col];
+			}
+		}
+	}
+
+	free(ContenderList);
+#endif
+
 	ContenderList        = (int*)malloc(sizeof(int)          * k); 
 	ContenderFitnessList = (double*)malloc(sizeof(double)    * k);
 
 	/* Hold tournaments until 'NoSurvivors' has been found.										 */
-	for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+	for (; Tournament < NoSurvivors; Tournament++) {
 		
 		/* Randomly pick k contenders.															 */
-		Contender = 0;
-		while (Contender < k){
-			/* Draw a contender.																 */
-			ContenderIndex = randr(Eliterows, m-1);
-			
-			/* Check if it is already in the contender list.									 */
-			AlreadyInTour = false;
-			for (row = 0; row < Contender; row++) {
-				if (ContenderIndex == ContenderList[row]) {
-					AlreadyInTour = true;
-				}
-			}
-
-			/* If the contender was not already on the list - add it, and its fitness.           */
-			if (AlreadyInTour == false) {
-				ContenderList[Contender] = ContenderIndex;
-				ContenderFitnessList[Contender] = Fitness[ContenderIndex];
-				Contender++;
-			}
+		DrawContenders(k, Eliterows, m, ContenderList, 1);
+		for (row = 0; row < k; row++) {
+			ContenderFitnessList[row] = Fitness[ContenderList[row]];
 		}
 
-
-		/* Find winner of the tournament.														 */
+		/* Find winner of the tournament. A contender beats a winner whose fitness is NaN, so	 */
+		/* NaN is treated as the worst fitness, as in EliteSelection.							 */
 		for (row = 0; row < k; row++) {
 			if (row == 0) {
 				Winner = ContenderFitnessList[row];
 				WinnerIndex = ContenderList[row];
 			}
 			else {
-				if (ContenderFitnessList[row] > Winner) {
+				if (ContenderFitnessList[row] > Winner || Winner != Winner) {
 					Winner = ContenderFitnessList[row];
 					WinnerIndex = ContenderList[row];
 				}
 			}
 		}
 
-		/* Extract the winner and place it in the pool of Survivors together with its fitness.   */
+		/* Extract the winner and place it in the pool of Survivors together with its fitness.	 */
 		SurvivorFitness[Tournament] = Winner;
 		for (col = 0; col < n; col++){
 			Survivors[Tournament + NoSurvivors * col] = Population[WinnerIndex + m * col];
@@ -159,10 +315,146 @@ void TourSel(int k, const double *Fitness, const bool *Population, int NoSurvivo
 
 	free(ContenderList);
 	free(ContenderFitnessList);
+	COUNT(SELECTION_TIME, WallTime());
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing k unique contenders among the non-elite rows. Contender c is written to	 */
+/* ContenderList[c*Stride], which lets the batch path interleave the tournaments of a batch.	 */
+void DrawContenders(int k, int Eliterows, size_t m, int *ContenderList, int Stride){
+
+	int Contender, ContenderIndex, row;
+	bool AlreadyInTour;
+
+	Contender = 0;
+	while (Contender < k){
+		/* Draw a contender.																	 */
+		ContenderIndex = randr(Eliterows, m-1);
+
+		/* Check if it is already in the contender list.										 */
+		AlreadyInTour = false;
+		for (row = 0; row < Contender; row++) {
+			if (ContenderIndex == ContenderList[row * Stride]) {
+				AlreadyInTour = true;
+			}
+		}
+
+		/* If the contender was not already on the list - add it.								 */
+		if (AlreadyInTour == false) {
+			ContenderList[Contender * Stride] = ContenderIndex;
+			Contender++;
+		}
+		else {
+			COUNT(CONTENDER_RETRIES, 1);
+		}
+	}
+}
+#ifdef TOURSEL_BATCH
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for finding the winners of TOURSEL_BATCH tournaments in parallel. The fitness of	 */
+/* contender c is gathered for all tournaments, and a lane takes the new contender (fitness and	 */
+/* row index) if it is strictly better or if the fitness of the lane is NaN. Ties therefore go	 */
+/* to the earliest contender, and NaN only wins if all contenders are NaN, exactly as in the	 */
+/* scalar compare loop.																			 */
+void BatchWinners(int k, const double *Fitness, const int *ContenderList, int *WinnerIndex, double *Winner){
+
+	int Contender;
+
+#if TOURSEL_BATCH == 8
+	__m256i Index;
+	__m512i BestIndex;
+	__m512d Contestant, Best;
+	__mmask8 Better;
+
+	Index     = _mm256_loadu_si256((const __m256i*)ContenderList);
+	Best      = _mm512_i32gather_pd(Index, Fitness, sizeof(double));
+	BestIndex = _mm512_cvtepi32_epi64(Index);
+
+	for (Contender = 1; Contender < k; Contender++) {
+		Index      = _mm256_loadu_si256((const __m256i*)(ContenderList + Contender * TOURSEL_BATCH));
+		Contestant = _mm512_i32gather_pd(Index, Fitness, sizeof(double));
+		Better     = _mm512_cmp_pd_mask(Contestant, Best, _CMP_GT_OQ) | _mm512_cmp_pd_mask(Best, Best, _CMP_UNORD_Q);
+		Best       = _mm512_mask_blend_pd(Better, Best, Contestant);
+		BestIndex  = _mm512_mask_blend_epi64(Better, BestIndex, _mm512_cvtepi32_epi64(Index));
+	}
+
+	_mm512_storeu_pd(Winner, Best);
+	_mm256_storeu_si256((__m256i*)WinnerIndex, _mm512_cvtepi64_epi32(BestIndex));
+#else
+	__m128i Index;
+	__m256i BestIndex;
+	__m256d Contestant, Best, Better;
+
+	Index     = _mm_loadu_si128((const __m128i*)ContenderList);
+	Best      = _mm256_i32gather_pd(Fitness, Index, sizeof(double));
+	BestIndex = _mm256_cvtepi32_epi64(Index);
+
+	for (Contender = 1; Contender < k; Contender++) {
+		Index      = _mm_loadu_si128((const __m128i*)(ContenderList + Contender * TOURSEL_BATCH));
+		Contestant = _mm256_i32gather_pd(Fitness, Index, sizeof(double));
+		Better     = _mm256_or_pd(_mm256_cmp_pd(Contestant, Best, _CMP_GT_OQ), _mm256_cmp_pd(Best, Best, _CMP_UNORD_Q));
+		Best       = _mm256_blendv_pd(Best, Contestant, Better);
+		BestIndex  = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(BestIndex),
+		                                                  _mm256_castsi256_pd(_mm256_cvtepi32_epi64(Index)), Better));
+	}
+
+	/* Pack the 64-bit lane indices back down to 32-bit (the low half of each lane).			 */
+	_mm256_storeu_pd(Winner, Best);
+	_mm_storeu_si128((__m128i*)WinnerIndex, _mm256_castsi256_si128(
+		_mm256_permutevar8x32_epi32(BestIndex, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7))));
+#endif
 }
+#endif
 /* ————————————————————————————————————————————————————————————————————————————————————————————— */
 /* Function for drawing a random integer that lies within range.								 */
 int randr(unsigned int min, unsigned int max) {
+	COUNT(RNG_DRAWS, 1);
 	return min + rand() / (RAND_MAX / (max - min + 1) + 1);
 }
-/* ————————————————————————————————————————————————————————————————————————————————————————————— */
\ No newline at end of file
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+#ifdef GA_INSTRUMENT
+/* Function for reading a monotonic wall clock in seconds.										 */
+double WallTime(void){
+#ifdef _WIN32
+	LARGE_INTEGER Count, Frequency;
+	QueryPerformanceCounter(&Count);
+	QueryPerformanceFrequency(&Frequency);
+	return (double)Count.QuadPart / (double)Frequency.QuadPart;
+#else
+	struct timespec Now;
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (double)Now.tv_sec + 1e-9 * (double)Now.tv_nsec;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for writing the counters as a JSON object into a buffer of Size bytes, which like	 */
+/* snprintf returns the length of the full text and truncates it if the buffer is too small.	 */
+int TourSelCountersJson(char *Buffer, size_t Size){
+
+	size_t Used = 0;
+	int Counter;
+
+	for (Counter = 0; Counter < TourSelNoCounters; Counter++) {
+		Used += snprintf(Used < Size ? Buffer + Used : NULL, Used < Size ? Size - Used : 0, "%s\"%s\": %.17g",
+			Counter == 0 ? "{" : ", ", TourSelCounterNames[Counter], TourSelCounters[Counter]);
+	}
+	Used += snprintf(Used < Size ? Buffer + Used : NULL, Used < Size ? Size - Used : 0, "}");
+	return (int)Used;
+}
+#ifndef GA_NO_MEX
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for returning the counters to Matlab as a struct with one scalar field per			 */
+/* counter.																						 */
+mxArray *CountersStruct(void){
+
+	mxArray *Counters;
+	int Counter;
+
+	Counters = mxCreateStructMatrix(1, 1, TourSelNoCounters, TourSelCounterNames);
+	for (Counter = 0; Counter < TourSelNoCounters; Counter++) {
+		mxSetFieldByNumber(Counters, 0, Counter, mxCreateDoubleScalar(TourSelCounters[Counter]));
+	}
+	return Counters;
+}
+#endif
+#endif
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,95 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Tournament selection operator, native GNU Octave gateway.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is an Octave function (.oct) with the same inputs and outputs as the MEX function in
+TournamentSelection.c, whose TourSel it calls. Octave passes its own arrays to a MEX function by
+converting them to mxArrays, and converts the outputs back, which for large populations costs as
+much as the selection itself. This gateway instead reads the population and fitness directly from
+the Octave arrays, and TourSel writes the survivors directly into the Octave output arrays.
+
+TournamentSelection.c has to be compiled with GA_NO_MEX defined, which leaves out its MEX gateway.
+When both files are compiled with GA_INSTRUMENT defined, a third output holds the counters of
+the call, as a struct with the same fields as in TournamentSelection.c.
+
+Example on how to compile and run from GNU Octave:
+% Compile .CC and .C to .oct
+>> mkoctfile -DGA_NO_MEX TournamentSelection.cc TournamentSelection.c
+% or with the instrumentation counters
+>> mkoctfile -DGA_NO_MEX -DGA_INSTRUMENT TournamentSelection.cc TournamentSelection.c
+
+% Run from Octave when compiled:
+>> [ Survivors, SurvivorFitness ] = TournamentSelection( 3, rand(100,1), rand(100,256) > 0.5, 50, 2 );
+
+Example of compatible C++ compilers:
+* GCC 7 and later, with GNU Octave 4.4 and later
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <octave/oct.h> // Needed to communicate with Octave.
+#include <cstdlib>      // Needed for srand().
+#include <ctime>        // Needed for counting CPU clock cycle which is used to set seed for rand().
+#include <cstring>      // Needed for memset.
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+extern "C" void TourSel(int k, const double *Fitness, const bool *Population, int NoSurvivors, int Eliterows, size_t m, size_t n, bool *Survivors, double *SurvivorFitness);
+
+#ifdef GA_INSTRUMENT
+extern "C" const int TourSelNoCounters;
+extern "C" const char *TourSelCounterNames[];
+extern "C" double TourSelCounters[];
+#endif
+
+/* ——————————————————————————————————— Octave gateway start ———————————————————————————————————— */
+DEFUN_DLD(TournamentSelection, args, nargout,
+	"[ Survivors, SurvivorFitness ] = TournamentSelection( k, Fitness, Population, NoSurvivors, Eliterows )"){
+
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.        */
+	srand(clock());
+#ifdef GA_INSTRUMENT
+	memset(TourSelCounters, 0, sizeof(double) * TourSelNoCounters);
+#endif
+
+	if (args.length() != 5 || !args(2).islogical()) {
+		error_with_id("Octave:TournamentSelection:invalidinputs", "Error: Inputs must be k, Fitness, a logical Population, NoSurvivors and Eliterows!");
+	}
+
+	/* ———————————————————————— Get the input variables without copying ———————————————————————— */
+	int k                        = args(0).int_value();        // Input 1 (k)
+	const NDArray Fitness        = args(1).array_value();      // Input 2 (Fitness)
+	const boolNDArray Population = args(2).bool_array_value(); // Input 3 (Population)
+	int NoSurvivors              = args(3).int_value();        // Input 4 (Number of survivors)
+	int Eliterows                = args(4).int_value();        // Input 5 (Number of elitism rows)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	size_t m = Population.rows();                              // Number of rows in Population.
+	size_t n = Population.columns();                           // Number of columns in Population.
+
+	if ((size_t)Fitness.numel() != m) {
+		error_with_id("Octave:TournamentSelection:invalidinputs", "Error: Fitness must have one element per individual in Population!");
+	}
+	if (k < 1 || NoSurvivors < 0 || Eliterows < 0 || (size_t)Eliterows + k > m) {
+		error_with_id("Octave:TournamentSelection:invalidinputs", "Error: k must be at least 1 and at most the number of rows after Eliterows!");
+	}
+
+	/* ——————————————————————————————— Specify Octave outputs —————————————————————————————————— */
+	boolMatrix Survivors(NoSurvivors, n);
+	ColumnVector SurvivorFitness(NoSurvivors);
+
+	/* ——————————————————————————————— Tournament selection ———————————————————————————————————— */
+	TourSel(k, Fitness.data(), Population.data(), NoSurvivors, Eliterows, m, n,
+		Survivors.fortran_vec(), SurvivorFitness.fortran_vec());
+
+	octave_value_list Outputs = ovl(Survivors, SurvivorFitness);
+#ifdef GA_INSTRUMENT
+	if (nargout > 2) {
+		octave_scalar_map Counters;
+		for (int Counter = 0; Counter < TourSelNoCounters; Counter++) {
+			Counters.assign(TourSelCounterNames[Counter], TourSelCounters[Counter]);
+		}
+		Outputs(2) = Counters;
+	}
+#endif
+	return Outputs;
+}
@@ -0,0 +1,322 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Duplicate elimination.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which finds the individuals of a population that are identical to an
+individual higher up in the population, and either removes them or mutates them until they are
+unique. It is meant to be run after NpointCrossover and BitflipMutation, so that no fitness
+evaluations are spent on duplicates.
+
+Each individual is packed into 64-bit words and hashed with xxHash64. The hashes are inserted in an
+open-addressing hash table, and on a hash match the packed individuals are compared in full, so a
+hash collision can never make a unique individual a duplicate. The whole pass takes O(m*n) time.
+
+With 'remutate', each duplicate gets a bitflip mutation as in BitflipMutation with probability Pm,
+with at least one gene flipped, and the mutation is repeated on the original duplicate until the
+result is not in the population, for at most 100 attempts.
+
+The function takes 4 inputs:
+* Input 1: a [m x n] population matrix of logical values, with one individual per row.
+* Input 2: 'remove' or 'remutate'.
+* Input 3: (optional) a [1 x 1] scalar 'ElitismNo' specifying how many individuals, starting from
+the top row, are never removed or mutated. Default 0.
+* Input 4: (optional) a [1 x 1] scalar 'Pm' specifying the mutation probability of 'remutate'.
+Default 1/n.
+
+With 'remove' the function outputs 2 variables:
+* Output 1: a [u x n] boolean matrix containing the u unique individuals, in population order.
+* Output 2: a [u x 1] vector with the row in the population of each unique individual.
+
+With 'remutate' the function outputs 2 variables:
+* Output 1: a [m x n] boolean matrix containing the population with the duplicates mutated.
+* Output 2: a [m x 1] boolean vector which is true for the individuals that were duplicates.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex DuplicateElimination.c
+
+% Run from Matlab when compiled:
+>> Population = logical(randi([0 1],10000, 16));
+>> [ Unique, Rows ] = DuplicateElimination( Population, 'remove' );
+>> [ Population, WasDuplicate ] = DuplicateElimination( Population, 'remutate', 2, 1/16 );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used to set seed for rand().
+#include <string.h> // Needed for memset, memcpy, memcmp and strcmp.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+
+/* Number of mutations tried on a duplicate before it is left as it is.							 */
+#define MAX_ATTEMPTS 100
+
+/* ——————————————————————————————————————————— Types ——————————————————————————————————————————— */
+/* Open-addressing hash set of packed individuals, referred to by their row.					 */
+typedef struct {
+	const uint64_t *Packed;     // [m x Words] packed individuals.
+	size_t Words;
+	size_t Slots;               // Number of slots, a power of two.
+	uint64_t *Hashes;           // [Slots x 1] hash of the individual in each slot.
+	int64_t *Rows;              // [Slots x 1] row stored in each slot, -1 if empty.
+} GenomeSet;
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+bool SetContains(const GenomeSet *Set, const uint64_t *Genome, uint64_t Hash);
+
+void SetInsert(GenomeSet *Set, size_t Row, uint64_t Hash);
+
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed);
+
+uint64_t XXH64(const uint64_t *Data, size_t Words, uint64_t Seed);
+
+int randr(unsigned int min, unsigned int max);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* Before starting set the seed of the RNG to the number of clock cycles since start.		 */
+	srand(clock());
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const bool *Population;
+	char Mode[16];
+	int ElitismNo;
+	double Pm;
+
+	bool *Duplicate, *Output, Flipped;
+	double *RowsOut;
+	uint64_t *Packed, *Trial, Hash;
+	GenomeSet Set;
+	size_t m, n, Words, row, gene, NoUnique, u;
+	int Attempt;
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 2 || !mxIsLogical(prhs[0]) || mxGetString(prhs[1], Mode, sizeof(Mode)) != 0 ||
+		(strcmp(Mode, "remove") != 0 && strcmp(Mode, "remutate") != 0)) {
+		mexErrMsgIdAndTxt("MATLAB:DuplicateElimination:invalidinputs", "Error: Inputs must be a logical Population and 'remove' or 'remutate'!");
+	}
+	Population = mxGetLogicals(prhs[0]);      // Input 1 (Population)
+	ElitismNo  = nrhs > 2 ? (int)mxGetScalar(prhs[2]) : 0; // Input 3 (Elitism rows)
+
+	/* ——————————————————————— Get the dimensions of the input variables ——————————————————————— */
+	m = mxGetM(prhs[0]);                      // Number of rows in Population.
+	n = mxGetN(prhs[0]);                      // Number of columns in Population.
+	Words = (n + 63) / 64;
+
+	Pm = nrhs > 3 ? mxGetScalar(prhs[3]) : 1.0 / (double)(n > 0 ? n : 1); // Input 4 (Pm)
+	if (ElitismNo < 0) {
+		ElitismNo = 0;
+	}
+
+	/* ———————————————————————————————— Build the hash set ————————————————————————————————————— */
+	/* The set is kept at most half full so that the probe sequences stay short. When			 */
+	/* remutating, one extra row holds the trial mutation of the current duplicate.				 */
+	Packed = (uint64_t*)malloc(sizeof(uint64_t) * ((m + 1) * Words + 1));
+	PackRows(Population, m, n, Words, Packed);
+	Trial = Packed + m * Words;
+
+	Set.Packed = Packed;
+	Set.Words  = Words;
+	for (Set.Slots = 1024; Set.Slots < 2 * m; Set.Slots *= 2);
+	Set.Hashes = (uint64_t*)malloc(sizeof(uint64_t) * Set.Slots);
+	Set.Rows   = (int64_t*)malloc(sizeof(int64_t) * Set.Slots);
+	memset(Set.Rows, 0xFF, sizeof(int64_t) * Set.Slots);
+	Duplicate  = (bool*)calloc(m + 1, sizeof(bool));
+
+	/* The first occurrence of each individual is kept, as are the elites.						 */
+	NoUnique = 0;
+	for (row = 0; row < m; row++) {
+		Hash = XXH64(Packed + row * Words, Words, 0);
+		if (SetContains(&Set, Packed + row * Words, Hash) && row >= (size_t)ElitismNo) {
+			Duplicate[row] = true;
+		}
+		else {
+			SetInsert(&Set, row, Hash);
+			NoUnique++;
+		}
+	}
+
+	/* ——————————————————————————————————— Remove duplicates ——————————————————————————————————— */
+	if (strcmp(Mode, "remove") == 0) {
+		plhs[0] = mxCreateLogicalMatrix(NoUnique, n);
+		Output = mxGetLogicals(plhs[0]);
+		plhs[1] = mxCreateDoubleMatrix(NoUnique, 1, mxREAL);
+		RowsOut = mxGetPr(plhs[1]);
+
+		u = 0;
+		for (row = 0; row < m; row++) {
+			if (!Duplicate[row]) {
+				RowsOut[u++] = (double)(row + 1);
+			}
+		}
+		for (gene = 0; gene < n; gene++) {
+			for (u = 0; u < NoUnique; u++) {
+				Output[u + NoUnique * gene] = Population[(size_t)RowsOut[u] - 1 + m * gene];
+			}
+		}
+	}
+
+	/* ——————————————————————————————————— Remutate duplicates ————————————————————————————————— */
+	else {
+		plhs[0] = mxCreateLogicalMatrix(m, n);
+		Output = mxGetLogicals(plhs[0]);
+		memcpy(Output, Population, sizeof(bool) * m * n);
+		plhs[1] = mxCreateLogicalMatrix(m, 1);
+		memcpy(mxGetLogicals(plhs[1]), Duplicate, sizeof(bool) * m);
+
+		for (row = 0; row < m && n > 0; row++) {
+			if (!Duplicate[row]) {
+				continue;
+			}
+			for (Attempt = 0; Attempt < MAX_ATTEMPTS; Attempt++) {
+				/* Mutate a copy of the duplicate, flipping one random gene if Pm flipped none.	 */
+				memcpy(Trial, Packed + row * Words, sizeof(uint64_t) * Words);
+				Flipped = false;
+				for (gene = 0; gene < n; gene++) {
+					if ((double)rand() / RAND_MAX < Pm) {
+						Trial[gene / 64] ^= (uint64_t)1 << (gene % 64);
+						Flipped = true;
+					}
+				}
+				if (!Flipped) {
+					gene = randr(0, (unsigned int)n - 1);
+					Trial[gene / 64] ^= (uint64_t)1 << (gene % 64);
+				}
+
+				Hash = XXH64(Trial, Words, 0);
+				if (!SetContains(&Set, Trial, Hash)) {
+					break;
+				}
+			}
+
+			/* Keep the unique mutant, and add it to the set so that later duplicates avoid it.	 */
+			if (Attempt < MAX_ATTEMPTS) {
+				memcpy(Packed + row * Words, Trial, sizeof(uint64_t) * Words);
+				SetInsert(&Set, row, Hash);
+				for (gene = 0; gene < n; gene++) {
+					Output[row + m * gene] = (Trial[gene / 64] >> (gene % 64)) & 1;
+				}
+			}
+		}
+	}
+
+	free(Packed);
+	free(Set.Hashes);
+	free(Set.Rows);
+	free(Duplicate);
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking if a packed individual is in the set.									 */
+bool SetContains(const GenomeSet *Set, const uint64_t *Genome, uint64_t Hash){
+
+	size_t Slot;
+	int64_t Row;
+
+	/* Linear probing until an empty slot is reached.											 */
+	for (Slot = Hash & (Set->Slots - 1); (Row = Set->Rows[Slot]) >= 0; Slot = (Slot + 1) & (Set->Slots - 1)) {
+		if (Set->Hashes[Slot] == Hash && memcmp(Set->Packed + Row * Set->Words, Genome, sizeof(uint64_t) * Set->Words) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for adding a row that is not already in the set. The set never holds more than m	 */
+/* rows, and has at least 2m slots, so it cannot fill up.										 */
+void SetInsert(GenomeSet *Set, size_t Row, uint64_t Hash){
+
+	size_t Slot;
+
+	Slot = Hash & (Set->Slots - 1);
+	while (Set->Rows[Slot] >= 0) {
+		Slot = (Slot + 1) & (Set->Slots - 1);
+	}
+	Set->Hashes[Slot] = Hash;
+	Set->Rows[Slot]   = (int64_t)Row;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing each row of a column-major logical matrix into 64-bit words. Gene j of	 */
+/* a row is stored in bit j%64 of word j/64, and the unused bits of the last word are zero.		 */
+void PackRows(const bool *Population, size_t m, size_t n, size_t Words, uint64_t *Packed){
+
+	size_t row, gene;
+
+	memset(Packed, 0, sizeof(uint64_t) * m * Words);
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < m; row++) {
+			Packed[row * Words + gene / 64] |= (uint64_t)(Population[row + m * gene] != 0) << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for computing the 64-bit xxHash of 'Words' 64-bit words.							 */
+#define XXH_PRIME1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME3 0x165667B19E3779F9ULL
+#define XXH_PRIME4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME5 0x27D4EB2F165667C5ULL
+#define XXH_ROTL(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+static uint64_t XXH64Round(uint64_t Acc, uint64_t Input) {
+	Acc += Input * XXH_PRIME2;
+	Acc  = XXH_ROTL(Acc, 31);
+	return Acc * XXH_PRIME1;
+}
+
+static uint64_t XXH64Merge(uint64_t Acc, uint64_t Val) {
+	Acc ^= XXH64Round(0, Val);
+	return Acc * XXH_PRIME1 + XXH_PRIME4;
+}
+
+uint64_t XXH64(const uint64_t *Data, size_t Words, uint64_t Seed) {
+
+	uint64_t Hash, v1, v2, v3, v4;
+	size_t i = 0;
+
+	if (Words >= 4) {
+		v1 = Seed + XXH_PRIME1 + XXH_PRIME2;
+		v2 = Seed + XXH_PRIME2;
+		v3 = Seed;
+		v4 = Seed - XXH_PRIME1;
+		for (; i + 4 <= Words; i += 4) {
+			v1 = XXH64Round(v1, Data[i]);
+			v2 = XXH64Round(v2, Data[i + 1]);
+			v3 = XXH64Round(v3, Data[i + 2]);
+			v4 = XXH64Round(v4, Data[i + 3]);
+		}
+		Hash = XXH_ROTL(v1, 1) + XXH_ROTL(v2, 7) + XXH_ROTL(v3, 12) + XXH_ROTL(v4, 18);
+		Hash = XXH64Merge(Hash, v1);
+		Hash = XXH64Merge(Hash, v2);
+		Hash = XXH64Merge(Hash, v3);
+		Hash = XXH64Merge(Hash, v4);
+	}
+	else {
+		Hash = Seed + XXH_PRIME5;
+	}
+
+	Hash += (uint64_t)Words * 8;
+	for (; i < Words; i++) {
+		Hash ^= XXH64Round(0, Data[i]);
+		Hash  = XXH_ROTL(Hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+	}
+
+	Hash ^= Hash >> 33;
+	Hash *= XXH_PRIME2;
+	Hash ^= Hash >> 29;
+	Hash *= XXH_PRIME3;
+	Hash ^= Hash >> 32;
+	return Hash;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer that lies within range.								 */
+int randr(unsigned int min, unsigned int max) {
+	return min + rand() / (RAND_MAX / (max - min + 1) + 1);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
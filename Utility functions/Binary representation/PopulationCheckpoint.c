@@ -0,0 +1,382 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Population checkpoint.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which saves a population to a compact binary file and loads it back, so that
+a long run can be checkpointed and resumed. The chromosomes are stored with 1 bit per gene, i.e.
+8 times smaller than a logical matrix in a .mat file and without its compression, so a population
+of 1M x 4096 genes takes 512 MB.
+
+The file is written row chunk by row chunk, so only one chunk of packed rows is held in memory at a
+time. It is loaded by mapping the file into memory (mmap, or MapViewOfFile on Windows) and unpacking
+the rows directly from the mapped pages into the output, without reading the file into a buffer.
+The file is written to File.tmp, which is renamed to File once it is complete, so a save that fails
+or is interrupted leaves the previous checkpoint intact.
+
+File layout (native byte order, which is little endian on all supported platforms):
+* Header, 128 bytes: the magic "GAPOP01" with a terminating zero, then the 64-bit unsigned integers
+Rows, Genes, Words, Generation and HasFitness, the 4 words of RngState, and 6 reserved words.
+* Chromosomes: Rows x Words 64-bit words, row after row. Gene j of a row is bit j%64 of word j/64,
+and the unused bits of the last word of a row are zero.
+* Fitness: Rows doubles, only if HasFitness is 1.
+
+The function is called with a command as first input:
+* PopulationCheckpoint('save', File, Population, Fitness, Generation, RngState) writes a file.
+Fitness may be [], and Generation and RngState may be left out, in which case they are stored
+as 0.
+* PopulationCheckpoint('load', File) returns [Population, Fitness, Generation, RngState].
+* PopulationCheckpoint('info', File) returns a struct with the Rows, Genes, Generation and
+HasFitness of a file, without loading the population.
+
+The inputs and outputs are:
+* File: the name of the checkpoint file.
+* Population: a [m x n] boolean matrix containing the population, with one individual per row.
+* Fitness: a [m x 1] vector containing the fitness of each individual, or [] if not stored.
+* Generation: a [1 x 1] scalar, e.g. the number of generations completed.
+* RngState: up to 4 unsigned 64-bit integers (uint64) holding the state of a random number
+generator, e.g. the xoshiro256** state of a GA. Returned as a [1 x 4] uint64 vector.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64
+>> mex PopulationCheckpoint.c
+
+% Run from Matlab when compiled:
+>> Population = logical(randi([0 1],10000, 4096));
+>> Fitness = rand(10000,1);
+>> PopulationCheckpoint( 'save', 'run1.gapop', Population, Fitness, 250 );
+>> [ Population, Fitness, Generation ] = PopulationCheckpoint( 'load', 'run1.gapop' );
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <stdio.h>  // Needed for writing the file.
+#include <string.h> // Needed for memset, memcmp, strcmp and strcat.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#ifdef _WIN32
+#include <windows.h>  // Needed for mapping the file into memory.
+#else
+#include <fcntl.h>    // Needed for open.
+#include <unistd.h>   // Needed for close.
+#include <sys/mman.h> // Needed for mapping the file into memory.
+#include <sys/stat.h> // Needed for the file size.
+#endif
+
+/* Number of rows packed and written at a time when saving.										 */
+#define CHUNK_ROWS 4096
+
+/* ——————————————————————————————————————————— Types ——————————————————————————————————————————— */
+/* Header at the start of a checkpoint file.													 */
+typedef struct {
+	char Magic[8];              // "GAPOP01" with a terminating zero.
+	uint64_t Rows, Genes, Words;
+	uint64_t Generation;
+	uint64_t HasFitness;        // 1 if the fitness follows the chromosomes, otherwise 0.
+	uint64_t RngState[4];
+	uint64_t Reserved[6];
+} CheckpointHeader;
+
+/* File mapped into memory.																		 */
+typedef struct {
+	const unsigned char *Data;
+	size_t Size;
+#ifdef _WIN32
+	HANDLE File, Mapping;
+#endif
+} MappedFile;
+
+static const char CheckpointMagic[8] = "GAPOP01";
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void SaveCheckpoint(const char *Name, const bool *Population, const double *Fitness, size_t m, size_t n, const CheckpointHeader *Header);
+
+bool MapFile(const char *Name, MappedFile *Map);
+
+void UnmapFile(MappedFile *Map);
+
+const CheckpointHeader *CheckHeader(const MappedFile *Map);
+
+void PackRows(const bool *Population, size_t m, size_t First, size_t Rows, size_t n, size_t Words, uint64_t *Packed);
+
+void UnpackRows(const uint64_t *Packed, size_t m, size_t n, size_t Words, bool *Population);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	const char *FieldNames[] = { "Rows", "Genes", "Generation", "HasFitness" };
+	char Command[8], *Name;
+	const bool *Population;
+	const double *Fitness;
+	const CheckpointHeader *Stored;
+	CheckpointHeader Header;
+	MappedFile Map;
+	uint64_t *RngOut;
+	size_t m, n, i;
+
+	/* ———————————————————————— Get pointers from the input variables —————————————————————————— */
+	if (nrhs < 2 || mxGetString(prhs[0], Command, sizeof(Command)) != 0 || !mxIsChar(prhs[1])) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:invalidinputs", "Error: Inputs must be 'save', 'load' or 'info' and a file name!");
+	}
+
+	/* ————————————————————————————————————— Save a population ————————————————————————————————— */
+	if (strcmp(Command, "save") == 0) {
+		if (nrhs < 3 || !mxIsLogical(prhs[2])) {
+			mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:invalidinputs", "Error: 'save' takes a logical Population as third input!");
+		}
+		Population = mxGetLogicals(prhs[2]);   // Input 3 (Population)
+		m = mxGetM(prhs[2]);                   // Number of rows in Population.
+		n = mxGetN(prhs[2]);                   // Number of columns in Population.
+
+		Fitness = NULL;
+		if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+			if (!mxIsDouble(prhs[3]) || mxGetNumberOfElements(prhs[3]) != m) {
+				mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:invalidinputs", "Error: Fitness must be [] or have one element per individual in Population!");
+			}
+			Fitness = mxGetPr(prhs[3]);        // Input 4 (Fitness)
+		}
+
+		memset(&Header, 0, sizeof(Header));
+		memcpy(Header.Magic, CheckpointMagic, sizeof(Header.Magic));
+		Header.Rows       = m;
+		Header.Genes      = n;
+		Header.Words      = (n + 63) / 64;
+		Header.HasFitness = Fitness != NULL;
+		Header.Generation = nrhs > 4 ? (uint64_t)mxGetScalar(prhs[4]) : 0; // Input 5 (Generation)
+		if (nrhs > 5) {
+			if (mxGetNumberOfElements(prhs[5]) > 4 || (!mxIsUint64(prhs[5]) && !mxIsDouble(prhs[5]))) {
+				mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:invalidinputs", "Error: RngState must be up to 4 uint64 or double values!");
+			}
+			for (i = 0; i < mxGetNumberOfElements(prhs[5]); i++) {    // Input 6 (RngState)
+				Header.RngState[i] = mxIsUint64(prhs[5]) ? ((const uint64_t*)mxGetData(prhs[5]))[i] : (uint64_t)mxGetPr(prhs[5])[i];
+			}
+		}
+
+		Name = mxArrayToString(prhs[1]);
+		SaveCheckpoint(Name, Population, Fitness, m, n, &Header);
+		mxFree(Name);
+		return;
+	}
+	if (strcmp(Command, "load") != 0 && strcmp(Command, "info") != 0) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:invalidinputs", "Error: First input must be 'save', 'load' or 'info'!");
+	}
+
+	/* ————————————————————————————— Map the file and check its header ———————————————————————— */
+	Name = mxArrayToString(prhs[1]);
+	if (!MapFile(Name, &Map)) {
+		mxFree(Name);
+		mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:fileerror", "Error: Could not open and map the checkpoint file!");
+	}
+	mxFree(Name);
+	Stored = CheckHeader(&Map);
+	if (Stored == NULL) {
+		UnmapFile(&Map);
+		mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:fileerror", "Error: File is not a population checkpoint, or is truncated!");
+	}
+	m = (size_t)Stored->Rows;
+	n = (size_t)Stored->Genes;
+
+	/* —————————————————————————————————————— File information ————————————————————————————————— */
+	if (strcmp(Command, "info") == 0) {
+		plhs[0] = mxCreateStructMatrix(1, 1, 4, FieldNames);
+		mxSetField(plhs[0], 0, "Rows", mxCreateDoubleScalar((double)Stored->Rows));
+		mxSetField(plhs[0], 0, "Genes", mxCreateDoubleScalar((double)Stored->Genes));
+		mxSetField(plhs[0], 0, "Generation", mxCreateDoubleScalar((double)Stored->Generation));
+		mxSetField(plhs[0], 0, "HasFitness", mxCreateLogicalScalar(Stored->HasFitness != 0));
+		UnmapFile(&Map);
+		return;
+	}
+
+	/* ————————————————————————————————————— Load a population ————————————————————————————————— */
+	plhs[0] = mxCreateLogicalMatrix(m, n);
+	UnpackRows((const uint64_t*)(Map.Data + sizeof(CheckpointHeader)), m, n, (size_t)Stored->Words, mxGetLogicals(plhs[0]));
+	if (nlhs > 1) {
+		plhs[1] = mxCreateDoubleMatrix(Stored->HasFitness ? m : 0, Stored->HasFitness ? 1 : 0, mxREAL);
+		if (Stored->HasFitness) {
+			memcpy(mxGetPr(plhs[1]), Map.Data + sizeof(CheckpointHeader) + sizeof(uint64_t) * m * Stored->Words, sizeof(double) * m);
+		}
+	}
+	if (nlhs > 2) {
+		plhs[2] = mxCreateDoubleScalar((double)Stored->Generation);
+	}
+	if (nlhs > 3) {
+		plhs[3] = mxCreateNumericMatrix(1, 4, mxUINT64_CLASS, mxREAL);
+		RngOut = (uint64_t*)mxGetData(plhs[3]);
+		memcpy(RngOut, Stored->RngState, sizeof(Stored->RngState));
+	}
+	UnmapFile(&Map);
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for writing a checkpoint file, packing and writing CHUNK_ROWS rows at a time to		 */
+/* Name.tmp, which is moved over Name once it is complete.										 */
+void SaveCheckpoint(const char *Name, const bool *Population, const double *Fitness, size_t m, size_t n, const CheckpointHeader *Header){
+
+	FILE *File;
+	char *TempName;
+	uint64_t *Packed;
+	size_t First, Rows, Words = (size_t)Header->Words;
+	bool Written;
+
+	TempName = (char*)mxMalloc(strlen(Name) + 5);
+	strcpy(TempName, Name);
+	strcat(TempName, ".tmp");
+	File = fopen(TempName, "wb");
+	if (File == NULL) {
+		mxFree(TempName);
+		mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:fileerror", "Error: Could not open the checkpoint file for writing!");
+	}
+	Packed = (uint64_t*)malloc(sizeof(uint64_t) * CHUNK_ROWS * Words + 1);
+
+	Written = fwrite(Header, sizeof(CheckpointHeader), 1, File) == 1;
+	for (First = 0; First < m && Written; First += CHUNK_ROWS) {
+		Rows = m - First < CHUNK_ROWS ? m - First : CHUNK_ROWS;
+		PackRows(Population, m, First, Rows, n, Words, Packed);
+		Written = fwrite(Packed, sizeof(uint64_t) * Words, Rows, File) == Rows;
+	}
+	if (Written && Fitness != NULL) {
+		Written = fwrite(Fitness, sizeof(double), m, File) == m;
+	}
+
+	free(Packed);
+	Written = fclose(File) == 0 && Written;
+	if (Written) {
+#ifdef _WIN32
+		Written = MoveFileExA(TempName, Name, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		Written = rename(TempName, Name) == 0;
+#endif
+	}
+	if (!Written) {
+		remove(TempName);
+	}
+	mxFree(TempName);
+	if (!Written) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationCheckpoint:fileerror", "Error: Could not write the checkpoint file!");
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for mapping a whole file read-only into memory. Returns false on failure.			 */
+bool MapFile(const char *Name, MappedFile *Map){
+#ifdef _WIN32
+	LARGE_INTEGER Size;
+
+	Map->Data = NULL;
+	Map->Mapping = NULL;
+	Map->File = CreateFileA(Name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (Map->File == INVALID_HANDLE_VALUE || !GetFileSizeEx(Map->File, &Size) || Size.QuadPart == 0) {
+		UnmapFile(Map);
+		return false;
+	}
+	Map->Size = (size_t)Size.QuadPart;
+	Map->Mapping = CreateFileMappingA(Map->File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (Map->Mapping != NULL) {
+		Map->Data = (const unsigned char*)MapViewOfFile(Map->Mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (Map->Data == NULL) {
+		UnmapFile(Map);
+		return false;
+	}
+	return true;
+#else
+	struct stat Info;
+	void *Data;
+	int File;
+
+	Map->Data = NULL;
+	File = open(Name, O_RDONLY);
+	if (File < 0) {
+		return false;
+	}
+	if (fstat(File, &Info) != 0 || Info.st_size == 0) {
+		close(File);
+		return false;
+	}
+	Map->Size = (size_t)Info.st_size;
+	Data = mmap(NULL, Map->Size, PROT_READ, MAP_PRIVATE, File, 0);
+	close(File);
+	if (Data == MAP_FAILED) {
+		return false;
+	}
+
+	/* The rows are unpacked from start to end, so let the kernel read ahead.					 */
+	madvise(Data, Map->Size, MADV_SEQUENTIAL);
+	Map->Data = (const unsigned char*)Data;
+	return true;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for unmapping a file mapped by MapFile.												 */
+void UnmapFile(MappedFile *Map){
+#ifdef _WIN32
+	if (Map->Data != NULL) {
+		UnmapViewOfFile(Map->Data);
+	}
+	if (Map->Mapping != NULL) {
+		CloseHandle(Map->Mapping);
+	}
+	if (Map->File != INVALID_HANDLE_VALUE) {
+		CloseHandle(Map->File);
+	}
+#else
+	if (Map->Data != NULL) {
+		munmap((void*)Map->Data, Map->Size);
+	}
+#endif
+	Map->Data = NULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking the header of a mapped checkpoint, and that the file is large enough	 */
+/* for the chromosomes and fitness it describes. Returns NULL if the file is not valid.			 */
+const CheckpointHeader *CheckHeader(const MappedFile *Map){
+
+	const CheckpointHeader *Header;
+	uint64_t Needed;
+
+	if (Map->Size < sizeof(CheckpointHeader)) {
+		return NULL;
+	}
+	Header = (const CheckpointHeader*)Map->Data;
+	if (memcmp(Header->Magic, CheckpointMagic, sizeof(Header->Magic)) != 0 || Header->Words != (Header->Genes + 63) / 64 ||
+		(Header->Words > 0 && Header->Rows > (UINT64_MAX / 16) / Header->Words)) {
+		return NULL;
+	}
+	Needed = sizeof(CheckpointHeader) + Header->Rows * Header->Words * sizeof(uint64_t) + (Header->HasFitness ? Header->Rows * sizeof(double) : 0);
+	return Needed <= Map->Size ? Header : NULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for packing rows First to First+Rows-1 of a column-major logical matrix into 64-bit	 */
+/* words. Gene j of a row is stored in bit j%64 of word j/64, and unused bits are zero.			 */
+void PackRows(const bool *Population, size_t m, size_t First, size_t Rows, size_t n, size_t Words, uint64_t *Packed){
+
+	size_t row, gene;
+
+	memset(Packed, 0, sizeof(uint64_t) * Rows * Words);
+	for (gene = 0; gene < n; gene++) {
+		for (row = 0; row < Rows; row++) {
+			Packed[row * Words + gene / 64] |= (uint64_t)(Population[First + row + m * gene] != 0) << (gene % 64);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for unpacking packed rows into a column-major logical matrix. The rows are handled	 */
+/* in chunks, so that the packed words of a chunk stay in cache while its columns are written.	 */
+void UnpackRows(const uint64_t *Packed, size_t m, size_t n, size_t Words, bool *Population){
+
+	size_t First, Rows, row, gene;
+
+	for (First = 0; First < m; First += 256) {
+		Rows = m - First < 256 ? m - First : 256;
+		for (gene = 0; gene < n; gene++) {
+			for (row = 0; row < Rows; row++) {
+				Population[First + row + m * gene] = (Packed[(First + row) * Words + gene / 64] >> (gene % 64)) & 1;
+			}
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
@@ -0,0 +1,766 @@
+﻿/* ————————————————————————————————————————————————————————————————————————————————————————————————
+Streaming population operators.
+———————————————————————————————————————————————————————————————————————————————————————————————————
+This is a MEX function which performs bitflip mutation, N-point crossover and tournament selection
+on populations that are too large to be held in memory as logical matrices, e.g. 50M individuals.
+The populations are stored in files in the packed format of PopulationCheckpoint (1 bit per gene),
+and each operator reads an input file and writes an output file in the same format.
+
+The input file is mapped into memory, so only the pages in use are held in memory, and the output
+is produced in chunks of rows. The chunks are double buffered: while one chunk is being computed
+the previous one is being written to the output file, when compiled with OpenMP. The mutation
+touches the input sequentially, and the next input chunk is prefetched while the current one is
+mutated.
+
+The tournament selection is done in two passes: first the tournaments are held on the fitness
+only, which is the only part of the population held in memory, and then the survivors are copied
+from the input file in increasing row order. The survivors are therefore written in row order
+rather than tournament order, which makes no difference to the random pairing of the crossover.
+
+The function is called with a command as first input:
+* PopulationStream('mutate', InFile, OutFile, Pm, ElitismNo, Seed) applies bitflip mutation with
+probability Pm to all individuals except the first ElitismNo, as in BitflipMutation.
+* PopulationStream('crossover', InFile, OutFile, N, my, Seed) creates my children by N-point
+crossover of randomly chosen pairs of parents, as in NpointCrossover.
+* PopulationStream('select', InFile, OutFile, k, NoSurvivors, Eliterows, Seed) selects NoSurvivors
+individuals by tournaments of k contenders, excluding the first Eliterows rows from the
+tournaments, as in TournamentSelection. The input file must hold the fitness of the population.
+NaN fitness, which 'fitness' gives the rows not yet evaluated, is the worst.
+* PopulationStream('read', File, First, Count) returns [Population, Fitness] of rows First to
+First+Count-1 of a file, e.g. to evaluate the population chunk by chunk.
+* PopulationStream('fitness', File, Fitness, First) stores the fitness of rows First to
+First+numel(Fitness)-1 in a file. If the file held no fitness, the fitness of all other rows
+is set to NaN.
+Seed is optional in all commands, and defaults to the number of clock cycles since start. The
+fitness of mutated and crossed individuals is unknown, so their output files hold no fitness.
+The output is written to OutFile.tmp, which is renamed to OutFile once it is complete and the input
+is closed, so OutFile may be the same file as InFile, and an error leaves any old OutFile intact.
+
+Example on how to compile and run from Matlab:
+% Compile .C to .mexw64, optionally with OpenMP to overlap the computations with the writing
+>> mex PopulationStream.c
+>> mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" PopulationStream.c
+
+% Run from Matlab when compiled:
+>> PopulationStream( 'select', 'gen1.gapop', 'parents.gapop', 3, 25e6, 0 );
+>> PopulationStream( 'crossover', 'parents.gapop', 'children.gapop', 2, 50e6 );
+>> PopulationStream( 'mutate', 'children.gapop', 'gen2.gapop', 1/4096, 0 );
+>> for First = 1:1e6:50e6
+>>     Chunk = PopulationStream( 'read', 'gen2.gapop', First, 1e6 );
+>>     PopulationStream( 'fitness', 'gen2.gapop', MyFitnessFunction(Chunk), First );
+>> end
+
+Example of compatible C compilers:
+* Microsoft Visual C++ 2013 Professional (C)
+* Microsoft Visual C++ 2015 Professional (C)
+* Intel Parallel Studio XE 2017
+
+Written 2026-10-16 by
+petter.stefansson@nmbu.no
+———————————————————————————————————————————————————————————————————————————————————————————————— */
+
+#include <mex.h>	// Needed to communicate with matlab.
+#include <time.h>   // Needed for counting CPU clock cycle which is used to set the default seed.
+#include <math.h>   // Needed for log() and log1p() in the skip sampling of the mutation.
+#include <stdio.h>  // Needed for writing the files.
+#include <string.h> // Needed for memset, memcpy, memcmp, strcmp and strcat.
+#include <stdint.h> // Needed for fixed width 64-bit integers.
+#ifdef _WIN32
+#include <windows.h>  // Needed for mapping the file into memory.
+#define SeekFile _fseeki64
+#else
+#include <fcntl.h>    // Needed for open.
+#include <unistd.h>   // Needed for close.
+#include <sys/mman.h> // Needed for mapping the file into memory.
+#include <sys/stat.h> // Needed for the file size.
+#define SeekFile fseeko
+#endif
+
+/* Number of rows produced and written at a time.												 */
+#define CHUNK_ROWS 65536
+
+/* ——————————————————————————————————————————— Types ——————————————————————————————————————————— */
+/* Header at the start of a population file, as written by PopulationCheckpoint.				 */
+typedef struct {
+	char Magic[8];              // "GAPOP01" with a terminating zero.
+	uint64_t Rows, Genes, Words;
+	uint64_t Generation;
+	uint64_t HasFitness;        // 1 if the fitness follows the chromosomes, otherwise 0.
+	uint64_t RngState[4];
+	uint64_t Reserved[6];
+} CheckpointHeader;
+
+/* File mapped into memory.																		 */
+typedef struct {
+	const unsigned char *Data;
+	size_t Size;
+#ifdef _WIN32
+	HANDLE File, Mapping;
+#endif
+} MappedFile;
+
+/* State of a streaming operator, shared by the chunks of its output.							 */
+typedef struct StreamJob StreamJob;
+typedef void (*ChunkFunction)(StreamJob *Job, size_t First, size_t Rows, uint64_t *Out);
+struct StreamJob {
+	MappedFile Map;
+	const CheckpointHeader *Header;
+	const uint64_t *Genomes;    // [Rows x Words] packed individuals of the input file.
+	const double *Fitness;      // [Rows x 1] fitness of the input file, NULL if not stored.
+	size_t n, Words;
+	uint64_t Rng[4];
+	ChunkFunction Produce;
+
+	/* Mutation.																				 */
+	double Pm, LogQ;
+	uint64_t NextFlip;          // Next gene to flip, counted row by row over the whole output.
+
+	/* Crossover.																				 */
+	int N, *CrossOverPoints;
+	size_t Parent1, Parent2;
+	uint64_t *Mask;             // [Words x 1] genes taken from the second parent.
+
+	/* Selection.																				 */
+	size_t *SurvivorRows;       // [NoSurvivors x 1] input row of each survivor, increasing.
+	double *SurvivorFitness;
+};
+
+static const char CheckpointMagic[8] = "GAPOP01";
+
+/* ——————————————————————————————————— Function declarations ——————————————————————————————————— */
+void OpenInput(const mxArray *Name, StreamJob *Job);
+
+void CloseInput(StreamJob *Job);
+
+bool WriteStream(StreamJob *Job, const mxArray *Name, size_t Rows, const double *Fitness);
+
+bool ReplaceOutput(const mxArray *Name, bool Written);
+
+char *TempFileName(const mxArray *Name);
+
+void MutateChunk(StreamJob *Job, size_t First, size_t Rows, uint64_t *Out);
+
+uint64_t DrawSkip(StreamJob *Job);
+
+void CrossoverChunk(StreamJob *Job, size_t First, size_t Rows, uint64_t *Out);
+
+void SelectChunk(StreamJob *Job, size_t First, size_t Rows, uint64_t *Out);
+
+void PrefetchRows(const StreamJob *Job, size_t First, size_t Rows);
+
+void SetBitRange(uint64_t *Mask, size_t Start, size_t End);
+
+void StoreFitness(const mxArray *Name, const double *Fitness, size_t First, size_t Count);
+
+bool MapFile(const char *Name, MappedFile *Map);
+
+void UnmapFile(MappedFile *Map);
+
+const CheckpointHeader *CheckHeader(const MappedFile *Map);
+
+int cmpfunc(const void * a, const void * b);
+
+int CompareRows(const void *a, const void *b);
+
+uint64_t RngNext(uint64_t *s);
+
+void RngSeed(uint64_t *s, uint64_t Seed);
+
+unsigned int RandBelow(uint64_t *s, unsigned int Range);
+
+double RandUnit(uint64_t *s);
+
+/* ——————————————————————————————————— Matlab gateway start ———————————————————————————————————— */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]){
+
+	/* —————————————————————————— Variable type and name declaration ——————————————————————————— */
+	char Command[16];
+	StreamJob Job;
+	int k, Contender, Entrant, Winner, *ContenderList;
+	size_t m, my, NoSurvivors, Eliterows, ElitismNo, First, Count, Tournament, row, gene;
+	bool *Population, AlreadyInTour, Written;
+	uint64_t Seed;
+
+	/* ————————————————————————— Get pointers from the input variables ————————————————————————— */
+	if (nrhs < 2 || mxGetString(prhs[0], Command, sizeof(Command)) != 0 || !mxIsChar(prhs[1])) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: Inputs must be a command and a file name!");
+	}
+	memset(&Job, 0, sizeof(Job));
+
+	/* ——————————————————————————————— Store fitness in a file ————————————————————————————————— */
+	if (strcmp(Command, "fitness") == 0) {
+		if (nrhs < 4 || !mxIsDouble(prhs[2])) {
+			mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: 'fitness' takes a file name, a Fitness vector and the first row!");
+		}
+		StoreFitness(prhs[1], mxGetPr(prhs[2]), (size_t)mxGetScalar(prhs[3]) - 1, mxGetNumberOfElements(prhs[2]));
+		return;
+	}
+
+	OpenInput(prhs[1], &Job);
+	m = (size_t)Job.Header->Rows;
+
+	/* ————————————————————————————————— Read rows of a file ——————————————————————————————————— */
+	if (strcmp(Command, "read") == 0) {
+		First = nrhs > 2 ? (size_t)mxGetScalar(prhs[2]) - 1 : 0;     // Input 3 (First)
+		Count = nrhs > 3 ? (size_t)mxGetScalar(prhs[3]) : m;         // Input 4 (Count)
+		if (nrhs > 2 && (mxGetScalar(prhs[2]) < 1 || First >= m)) {
+			CloseInput(&Job);
+			mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: First row must be between 1 and the number of rows of the file!");
+		}
+		Count = Count < m - First ? Count : m - First;
+
+		plhs[0] = mxCreateLogicalMatrix(Count, Job.n);
+		Population = mxGetLogicals(plhs[0]);
+		for (gene = 0; gene < Job.n; gene++) {
+			for (row = 0; row < Count; row++) {
+				Population[row + Count * gene] = (Job.Genomes[(First + row) * Job.Words + gene / 64] >> (gene % 64)) & 1;
+			}
+		}
+		if (nlhs > 1) {
+			plhs[1] = mxCreateDoubleMatrix(Job.Fitness != NULL ? Count : 0, Job.Fitness != NULL ? 1 : 0, mxREAL);
+			if (Job.Fitness != NULL) {
+				memcpy(mxGetPr(plhs[1]), Job.Fitness + First, sizeof(double) * Count);
+			}
+		}
+		CloseInput(&Job);
+		return;
+	}
+
+	/* ————————————————————————————————— Bitflip mutation —————————————————————————————————————— */
+	if (strcmp(Command, "mutate") == 0) {
+		if (nrhs < 5 || !mxIsChar(prhs[2])) {
+			CloseInput(&Job);
+			mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: 'mutate' takes InFile, OutFile, Pm and ElitismNo!");
+		}
+		Job.Pm    = mxGetScalar(prhs[3]);                  // Input 4 (Pm)
+		ElitismNo = (size_t)mxGetScalar(prhs[4]);          // Input 5 (ElitismNo)
+		Seed      = nrhs > 5 ? (uint64_t)mxGetScalar(prhs[5]) : (uint64_t)clock();
+		RngSeed(Job.Rng, Seed);
+
+		/* The number of genes skipped before the next flip is geometrically distributed, so	 */
+		/* no random number is drawn per gene.													 */
+		Job.LogQ = Job.Pm > 0 && Job.Pm < 1 ? log1p(-Job.Pm) : 0;
+		Job.NextFlip = (uint64_t)(ElitismNo < m ? ElitismNo : m) * Job.n;
+		if (!(Job.Pm > 0)) {
+			Job.NextFlip = UINT64_MAX;
+		}
+		else if (Job.Pm < 1) {
+			Job.NextFlip += DrawSkip(&Job);
+		}
+		Job.Produce = MutateChunk;
+		Written = WriteStream(&Job, prhs[2], m, NULL);
+	}
+
+	/* ————————————————————————————————— N-point crossover ————————————————————————————————————— */
+	else if (strcmp(Command, "crossover") == 0) {
+		if (nrhs < 5 || !mxIsChar(prhs[2])) {
+			CloseInput(&Job);
+			mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: 'crossover' takes InFile, OutFile, N and my!");
+		}
+		Job.N = (int)mxGetScalar(prhs[3]);                 // Input 4 (N)
+		my    = (size_t)mxGetScalar(prhs[4]);              // Input 5 (my)
+		Seed  = nrhs > 5 ? (uint64_t)mxGetScalar(prhs[5]) : (uint64_t)clock();
+		if (Job.N < 1 || Job.N > (int)Job.n - 1 || m < 2 || m > UINT32_MAX) {
+			CloseInput(&Job);
+			mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: N must be between 1 and n-1, and the file must hold at least 2 rows!");
+		}
+		RngSeed(Job.Rng, Seed);
+		Job.CrossOverPoints = (int*)malloc(sizeof(int) * Job.N);
+		Job.Mask = (uint64_t*)malloc(sizeof(uint64_t) * Job.Words + 1);
+		Job.Produce = CrossoverChunk;
+		Written = WriteStream(&Job, prhs[2], my, NULL);
+		free(Job.CrossOverPoints);
+		free(Job.Mask);
+	}
+
+	/* ————————————————————————————— Two-pass tournament selection ————————————————————————————— */
+	else if (strcmp(Command, "select") == 0) {
+		if (nrhs < 6 || !mxIsChar(prhs[2])) {
+			CloseInput(&Job);
+			mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: 'select' takes InFile, OutFile, k, NoSurvivors and Eliterows!");
+		}
+		k           = (int)mxGetScalar(prhs[3]);           // Input 4 (k)
+		NoSurvivors = (size_t)mxGetScalar(prhs[4]);        // Input 5 (NoSurvivors)
+		Eliterows   = (size_t)mxGetScalar(prhs[5]);        // Input 6 (Eliterows)
+		Seed        = nrhs > 6 ? (uint64_t)mxGetScalar(prhs[6]) : (uint64_t)clock();
+		if (Job.Fitness == NULL || k < 1 || Eliterows >= m || (size_t)k > m - Eliterows || m > UINT32_MAX) {
+			CloseInput(&Job);
+			mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: The file must hold fitness, and k must be between 1 and the number of non-elite rows!");
+		}
+		RngSeed(Job.Rng, Seed);
+
+		/* Pass 1: hold the tournaments on the fitness only.									 */
+		ContenderList = (int*)malloc(sizeof(int) * k);
+		Job.SurvivorRows = (size_t*)malloc(sizeof(size_t) * (NoSurvivors + 1));
+		Job.SurvivorFitness = (double*)malloc(sizeof(double) * (NoSurvivors + 1));
+		for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+			Contender = 0;
+			while (Contender < k) {
+				Entrant = (int)(Eliterows + RandBelow(Job.Rng, (unsigned int)(m - Eliterows)));
+				AlreadyInTour = false;
+				for (row = 0; row < (size_t)Contender; row++) {
+					if (Entrant == ContenderList[row]) {
+						AlreadyInTour = true;
+					}
+				}
+				if (AlreadyInTour == false) {
+					ContenderList[Contender] = Entrant;
+					Contender++;
+				}
+			}
+			/* A contender beats a winner whose fitness is NaN, e.g. of a row not yet evaluated, */
+			/* so NaN only wins if all contenders are NaN, as in TournamentSelection.			 */
+			Winner = ContenderList[0];
+			for (row = 1; row < (size_t)k; row++) {
+				if (Job.Fitness[ContenderList[row]] > Job.Fitness[Winner] || Job.Fitness[Winner] != Job.Fitness[Winner]) {
+					Winner = ContenderList[row];
+				}
+			}
+			Job.SurvivorRows[Tournament] = (size_t)Winner;
+		}
+		free(ContenderList);
+
+		/* Pass 2: copy the survivors in increasing row order, i.e. sequentially through the	 */
+		/* input file.																			 */
+		qsort(Job.SurvivorRows, NoSurvivors, sizeof(size_t), CompareRows);
+		for (Tournament = 0; Tournament < NoSurvivors; Tournament++) {
+			Job.SurvivorFitness[Tournament] = Job.Fitness[Job.SurvivorRows[Tournament]];
+		}
+		Job.Produce = SelectChunk;
+		Written = WriteStream(&Job, prhs[2], NoSurvivors, Job.SurvivorFitness);
+		free(Job.SurvivorRows);
+		free(Job.SurvivorFitness);
+	}
+	else {
+		CloseInput(&Job);
+		mexErrMsgIdAndTxt("MATLAB:PopulationStream:invalidinputs", "Error: First input must be 'mutate', 'crossover', 'select', 'read' or 'fitness'!");
+	}
+
+	/* The output only replaces OutFile once the input is unmapped, as OutFile may be InFile.	 */
+	CloseInput(&Job);
+	if (!ReplaceOutput(prhs[2], Written)) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationStream:fileerror", "Error: Could not write the output file!");
+	}
+}
+
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for mapping an input population file and checking its header.						 */
+void OpenInput(const mxArray *Name, StreamJob *Job){
+
+	char *FileName = mxArrayToString(Name);
+	bool Mapped = MapFile(FileName, &Job->Map);
+
+	mxFree(FileName);
+	if (!Mapped) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationStream:fileerror", "Error: Could not open and map the population file!");
+	}
+	Job->Header = CheckHeader(&Job->Map);
+	if (Job->Header == NULL) {
+		UnmapFile(&Job->Map);
+		mexErrMsgIdAndTxt("MATLAB:PopulationStream:fileerror", "Error: File is not a population file, or is truncated!");
+	}
+	Job->n       = (size_t)Job->Header->Genes;
+	Job->Words   = (size_t)Job->Header->Words;
+	Job->Genomes = (const uint64_t*)(Job->Map.Data + sizeof(CheckpointHeader));
+	Job->Fitness = Job->Header->HasFitness ? (const double*)(Job->Genomes + Job->Header->Rows * Job->Words) : NULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for unmapping the input population file.											 */
+void CloseInput(StreamJob *Job){
+	UnmapFile(&Job->Map);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for writing an output file of Rows rows, produced chunk by chunk by Job->Produce,	 */
+/* to the temporary file of Name. Two chunk buffers are used, so that the next chunk is			 */
+/* produced while the previous one is written. Returns false if the file could not be written.	 */
+bool WriteStream(StreamJob *Job, const mxArray *Name, size_t Rows, const double *Fitness){
+
+	CheckpointHeader Header;
+	uint64_t *Buffer[2];
+	size_t Chunk, NoChunks;
+	char *FileName;
+	FILE *File;
+	bool Written;
+
+	FileName = TempFileName(Name);
+	File = fopen(FileName, "wb");
+	mxFree(FileName);
+	if (File == NULL) {
+		return false;
+	}
+
+	memcpy(&Header, Job->Header, sizeof(Header));
+	Header.Rows       = Rows;
+	Header.HasFitness = Fitness != NULL;
+	Written = fwrite(&Header, sizeof(Header), 1, File) == 1;
+
+	Buffer[0] = (uint64_t*)malloc(sizeof(uint64_t) * CHUNK_ROWS * Job->Words + 1);
+	Buffer[1] = (uint64_t*)malloc(sizeof(uint64_t) * CHUNK_ROWS * Job->Words + 1);
+	NoChunks = (Rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+
+	/* In step Chunk, chunk Chunk is produced while chunk Chunk-1 is written.					 */
+	for (Chunk = 0; Chunk <= NoChunks && Written; Chunk++) {
+		#pragma omp parallel sections num_threads(2)
+		{
+			#pragma omp section
+			{
+				if (Chunk < NoChunks) {
+					size_t First = Chunk * CHUNK_ROWS;
+					size_t Count = Rows - First < CHUNK_ROWS ? Rows - First : CHUNK_ROWS;
+					Job->Produce(Job, First, Count, Buffer[Chunk % 2]);
+				}
+			}
+			#pragma omp section
+			{
+				if (Chunk > 0) {
+					size_t First = (Chunk - 1) * CHUNK_ROWS;
+					size_t Count = Rows - First < CHUNK_ROWS ? Rows - First : CHUNK_ROWS;
+					Written = fwrite(Buffer[(Chunk - 1) % 2], sizeof(uint64_t) * Job->Words, Count, File) == Count;
+				}
+			}
+		}
+	}
+	if (Written && Fitness != NULL) {
+		Written = fwrite(Fitness, sizeof(double), Rows, File) == Rows;
+	}
+
+	free(Buffer[0]);
+	free(Buffer[1]);
+	return fclose(File) == 0 && Written;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for moving the temporary file written by WriteStream over the output file Name, or	 */
+/* removing it if it was not fully written. Returns false if the output file was not replaced.	 */
+bool ReplaceOutput(const mxArray *Name, bool Written){
+
+	char *FileName = mxArrayToString(Name);
+	char *TempName = TempFileName(Name);
+
+	if (Written) {
+#ifdef _WIN32
+		Written = MoveFileExA(TempName, FileName, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		Written = rename(TempName, FileName) == 0;
+#endif
+	}
+	if (!Written) {
+		remove(TempName);
+	}
+	mxFree(FileName);
+	mxFree(TempName);
+	return Written;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for naming the temporary output file, Name with ".tmp" appended. Freed with mxFree.	 */
+char *TempFileName(const mxArray *Name){
+
+	char *FileName = mxArrayToString(Name);
+	char *TempName = (char*)mxMalloc(strlen(FileName) + 5);
+
+	strcpy(TempName, FileName);
+	strcat(TempName, ".tmp");
+	mxFree(FileName);
+	return TempName;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for producing a chunk of mutated individuals. The flips are counted row by row over	 */
+/* the whole population, so the skip sampling carries on from one chunk to the next.			 */
+void MutateChunk(StreamJob *Job, size_t First, size_t Rows, uint64_t *Out){
+
+	uint64_t End = (uint64_t)(First + Rows) * Job->n;
+	size_t row, gene;
+
+	PrefetchRows(Job, First + Rows, CHUNK_ROWS);
+	memcpy(Out, Job->Genomes + First * Job->Words, sizeof(uint64_t) * Rows * Job->Words);
+
+	while (Job->NextFlip < End) {
+		row  = (size_t)(Job->NextFlip / Job->n) - First;
+		gene = (size_t)(Job->NextFlip % Job->n);
+		Out[row * Job->Words + gene / 64] ^= (uint64_t)1 << (gene % 64);
+		if (Job->Pm < 1) {
+			Job->NextFlip += 1 + DrawSkip(Job);
+		}
+		else {
+			Job->NextFlip++;
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing the number of genes skipped before the next flip, capped at the			 */
+/* number of genes in the file so that it fits in 64 bits however small Pm is.					 */
+uint64_t DrawSkip(StreamJob *Job){
+
+	uint64_t Genes = Job->Header->Rows * Job->n;
+	double Skip = floor(log(RandUnit(Job->Rng)) / Job->LogQ);
+
+	return Skip < (double)Genes ? (uint64_t)Skip : Genes;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for producing a chunk of children. The children are made in pairs from the same		 */
+/* parents and crossover points, with the parents swapped for the second child of a pair.		 */
+void CrossoverChunk(StreamJob *Job, size_t First, size_t Rows, uint64_t *Out){
+
+	const uint64_t *P1, *P2;
+	size_t row, word, Start;
+	int i, j, CandidatePoint;
+	bool AlreadyChosen;
+
+	for (row = 0; row < Rows; row++) {
+		if ((First + row) % 2 == 0) {
+			/* Randomly pick two different parents and N unique crossover points.				 */
+			Job->Parent1 = RandBelow(Job->Rng, (unsigned int)Job->Header->Rows);
+			Job->Parent2 = RandBelow(Job->Rng, (unsigned int)Job->Header->Rows);
+			while (Job->Parent1 == Job->Parent2) {
+				Job->Parent2 = RandBelow(Job->Rng, (unsigned int)Job->Header->Rows);
+			}
+			i = 0;
+			while (i < Job->N) {
+				CandidatePoint = 1 + (int)RandBelow(Job->Rng, (unsigned int)Job->n - 1);
+				AlreadyChosen = false;
+				for (j = 0; j < i; j++) {
+					if (CandidatePoint == Job->CrossOverPoints[j]) {
+						AlreadyChosen = true;
+					}
+				}
+				if (AlreadyChosen == false) {
+					Job->CrossOverPoints[i] = CandidatePoint;
+					i += 1;
+				}
+			}
+			qsort(Job->CrossOverPoints, Job->N, sizeof(int), cmpfunc);
+
+			/* Every second segment, starting with the second, comes from the second parent.	 */
+			memset(Job->Mask, 0, sizeof(uint64_t) * Job->Words);
+			for (i = 0; i < Job->N; i += 2) {
+				Start = (size_t)Job->CrossOverPoints[i];
+				SetBitRange(Job->Mask, Start, i + 1 < Job->N ? (size_t)Job->CrossOverPoints[i + 1] : Job->n);
+			}
+			P1 = Job->Genomes + Job->Parent1 * Job->Words;
+			P2 = Job->Genomes + Job->Parent2 * Job->Words;
+		}
+		else {
+			P1 = Job->Genomes + Job->Parent2 * Job->Words;
+			P2 = Job->Genomes + Job->Parent1 * Job->Words;
+		}
+		for (word = 0; word < Job->Words; word++) {
+			Out[row * Job->Words + word] = (P1[word] & ~Job->Mask[word]) | (P2[word] & Job->Mask[word]);
+		}
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for producing a chunk of survivors, copied from the input in increasing row order.	 */
+void SelectChunk(StreamJob *Job, size_t First, size_t Rows, uint64_t *Out){
+	size_t row;
+	for (row = 0; row < Rows; row++) {
+		memcpy(Out + row * Job->Words, Job->Genomes + Job->SurvivorRows[First + row] * Job->Words, sizeof(uint64_t) * Job->Words);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for asking the operating system to start reading input rows that will be needed		 */
+/* soon, so that they are in memory when their chunk is produced.								 */
+void PrefetchRows(const StreamJob *Job, size_t First, size_t Rows){
+#ifndef _WIN32
+	size_t Page = (size_t)sysconf(_SC_PAGESIZE), Start, End;
+
+	if (First >= Job->Header->Rows) {
+		return;
+	}
+	Rows  = Rows < Job->Header->Rows - First ? Rows : (size_t)Job->Header->Rows - First;
+	Start = sizeof(CheckpointHeader) + sizeof(uint64_t) * First * Job->Words;
+	End   = Start + sizeof(uint64_t) * Rows * Job->Words;
+	Start -= Start % Page;
+	madvise((void*)(Job->Map.Data + Start), End - Start, MADV_WILLNEED);
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for setting bits Start to End-1 of a bit mask.										 */
+void SetBitRange(uint64_t *Mask, size_t Start, size_t End){
+	size_t word;
+	uint64_t Bits;
+	for (word = Start / 64; word * 64 < End; word++) {
+		Bits = ~(uint64_t)0;
+		if (word == Start / 64) {
+			Bits &= ~(uint64_t)0 << (Start % 64);
+		}
+		if (word == (End - 1) / 64 && End % 64 != 0) {
+			Bits &= ((uint64_t)1 << (End % 64)) - 1;
+		}
+		Mask[word] |= Bits;
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for storing the fitness of some rows in a population file, adding a block of NaN	 */
+/* fitness to the file first if it has none.													 */
+void StoreFitness(const mxArray *Name, const double *Fitness, size_t First, size_t Count){
+
+	CheckpointHeader Header;
+	char *FileName;
+	FILE *File;
+	double *Missing;
+	size_t row, Block;
+	bool Valid, Written;
+
+	FileName = mxArrayToString(Name);
+	File = fopen(FileName, "r+b");
+	mxFree(FileName);
+	if (File == NULL) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationStream:fileerror", "Error: Could not open the population file for writing!");
+	}
+	Valid = fread(&Header, sizeof(Header), 1, File) == 1 && memcmp(Header.Magic, CheckpointMagic, sizeof(Header.Magic)) == 0 &&
+		First <= Header.Rows && Count <= Header.Rows - First;
+	Written = Valid && SeekFile(File, sizeof(Header) + sizeof(uint64_t) * Header.Rows * Header.Words, SEEK_SET) == 0;
+
+	if (Written && !Header.HasFitness) {
+		Missing = (double*)malloc(sizeof(double) * CHUNK_ROWS);
+		for (row = 0; row < CHUNK_ROWS; row++) {
+			Missing[row] = mxGetNaN();
+		}
+		for (row = 0; row < Header.Rows && Written; row += Block) {
+			Block = Header.Rows - row < CHUNK_ROWS ? (size_t)Header.Rows - row : CHUNK_ROWS;
+			Written = fwrite(Missing, sizeof(double), Block, File) == Block;
+		}
+		free(Missing);
+		Header.HasFitness = 1;
+		Written = Written && SeekFile(File, 0, SEEK_SET) == 0 && fwrite(&Header, sizeof(Header), 1, File) == 1;
+	}
+	Written = Written && SeekFile(File, sizeof(Header) + sizeof(uint64_t) * Header.Rows * Header.Words + sizeof(double) * First, SEEK_SET) == 0 &&
+		fwrite(Fitness, sizeof(double), Count, File) == Count;
+
+	if (fclose(File) != 0 || !Written) {
+		mexErrMsgIdAndTxt("MATLAB:PopulationStream:fileerror", Valid ? "Error: Could not write the fitness to the population file!" : "Error: File is not a population file, or the rows are outside it!");
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for mapping a whole file read-only into memory. Returns false on failure.			 */
+bool MapFile(const char *Name, MappedFile *Map){
+#ifdef _WIN32
+	LARGE_INTEGER Size;
+
+	Map->Data = NULL;
+	Map->Mapping = NULL;
+	Map->File = CreateFileA(Name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (Map->File == INVALID_HANDLE_VALUE || !GetFileSizeEx(Map->File, &Size) || Size.QuadPart == 0) {
+		UnmapFile(Map);
+		return false;
+	}
+	Map->Size = (size_t)Size.QuadPart;
+	Map->Mapping = CreateFileMappingA(Map->File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (Map->Mapping != NULL) {
+		Map->Data = (const unsigned char*)MapViewOfFile(Map->Mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (Map->Data == NULL) {
+		UnmapFile(Map);
+		return false;
+	}
+	return true;
+#else
+	struct stat Info;
+	void *Data;
+	int File;
+
+	Map->Data = NULL;
+	File = open(Name, O_RDONLY);
+	if (File < 0) {
+		return false;
+	}
+	if (fstat(File, &Info) != 0 || Info.st_size == 0) {
+		close(File);
+		return false;
+	}
+	Map->Size = (size_t)Info.st_size;
+	Data = mmap(NULL, Map->Size, PROT_READ, MAP_PRIVATE, File, 0);
+	close(File);
+	if (Data == MAP_FAILED) {
+		return false;
+	}
+	Map->Data = (const unsigned char*)Data;
+	return true;
+#endif
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for unmapping a file mapped by MapFile.												 */
+void UnmapFile(MappedFile *Map){
+#ifdef _WIN32
+	if (Map->Data != NULL) {
+		UnmapViewOfFile(Map->Data);
+	}
+	if (Map->Mapping != NULL) {
+		CloseHandle(Map->Mapping);
+	}
+	if (Map->File != INVALID_HANDLE_VALUE) {
+		CloseHandle(Map->File);
+	}
+#else
+	if (Map->Data != NULL) {
+		munmap((void*)Map->Data, Map->Size);
+	}
+#endif
+	Map->Data = NULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for checking the header of a mapped population file, and that the file is large		 */
+/* enough for the chromosomes and fitness it describes. Returns NULL if the file is not valid.	 */
+const CheckpointHeader *CheckHeader(const MappedFile *Map){
+
+	const CheckpointHeader *Header;
+	uint64_t Needed;
+
+	if (Map->Size < sizeof(CheckpointHeader)) {
+		return NULL;
+	}
+	Header = (const CheckpointHeader*)Map->Data;
+	if (memcmp(Header->Magic, CheckpointMagic, sizeof(Header->Magic)) != 0 || Header->Words != (Header->Genes + 63) / 64 ||
+		(Header->Words > 0 && Header->Rows > (UINT64_MAX / 16) / Header->Words)) {
+		return NULL;
+	}
+	Needed = sizeof(CheckpointHeader) + Header->Rows * Header->Words * sizeof(uint64_t) + (Header->HasFitness ? Header->Rows * sizeof(double) : 0);
+	return Needed <= Map->Size ? Header : NULL;
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort vector.														 */
+int cmpfunc(const void * a, const void * b){
+	return (*(int*)a - *(int*)b);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function used by qsort() to sort rows in increasing order.									 */
+int CompareRows(const void *a, const void *b){
+	size_t RowA = *(const size_t*)a, RowB = *(const size_t*)b;
+	return (RowA > RowB) - (RowA < RowB);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Functions for the xoshiro256** random number generator, seeded through splitmix64.			 */
+uint64_t RngNext(uint64_t *s){
+	uint64_t Result = s[1] * 5;
+	uint64_t t = s[1] << 17;
+	Result = ((Result << 7) | (Result >> 57)) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return Result;
+}
+
+void RngSeed(uint64_t *s, uint64_t Seed){
+	int i;
+	uint64_t z;
+	for (i = 0; i < 4; i++) {
+		Seed += 0x9E3779B97F4A7C15ULL;
+		z = Seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s[i] = z ^ (z >> 31);
+	}
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random integer in the range 0 to Range-1.								 */
+unsigned int RandBelow(uint64_t *s, unsigned int Range){
+	return (unsigned int)(((RngNext(s) >> 32) * Range) >> 32);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */
+/* Function for drawing a random number in the range (0,1].										 */
+double RandUnit(uint64_t *s){
+	return ((RngNext(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+/* ————————————————————————————————————————————————————————————————————————————————————————————— */